@@ -0,0 +1,366 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_ARENAMAP_H
+#define SYSCOIN_ARENAMAP_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** Hash map with open addressing (robin hood probing) whose entries live in an arena.
+ *
+ * Meant as a replacement for std::unordered_map where lookups and inserts are
+ * hot and the map is emptied wholesale, like the UTXO cache:
+ *  - Entries are carved out of a few large chunks instead of one heap
+ *    allocation each. Erased entries are recycled through a free list, and
+ *    clear() releases all chunks at once.
+ *  - The probe table only holds an entry pointer and 32 bits of its hash, so a
+ *    lookup touches one or two table cache lines and then the entry itself.
+ *  - References to entries stay valid until the entry is erased, as with
+ *    std::unordered_map, since entries never move when the table grows.
+ *  - Memory use is known exactly, see memusage::DynamicUsage().
+ *
+ * Iteration follows the order of the entries in the arena. Erasing an entry
+ * only invalidates iterators to that entry, so erase-while-iterating works as
+ * with std::unordered_map.
+ *
+ * Only the subset of the std::unordered_map interface used for the coins cache
+ * is provided.
+ */
+template <typename K, typename T, typename Hash = std::hash<K> >
+class arenamap
+{
+public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<const K, T> value_type;
+    typedef size_t size_type;
+
+private:
+    struct Node {
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+        uint32_t chunk;
+        bool live;
+
+        value_type& value() { return *reinterpret_cast<value_type*>(&storage); }
+        const value_type& value() const { return *reinterpret_cast<const value_type*>(&storage); }
+        Node*& next_free() { return *reinterpret_cast<Node**>(&storage); }
+    };
+
+    struct Chunk {
+        std::unique_ptr<Node[]> nodes;
+        size_t size;
+    };
+
+    struct Slot {
+        Node* node;
+        uint32_t hash;
+    };
+
+    /** Size of the first arena chunk; chunks double up to MAX_CHUNK_NODES */
+    static const size_t MIN_CHUNK_NODES = 16;
+    static const size_t MAX_CHUNK_NODES = 4096;
+
+    Hash hasher;
+    std::vector<Slot> table;
+    std::vector<Chunk> chunks;
+    //! Nodes handed out from the last chunk
+    size_t nChunkUsed;
+    Node* pFree;
+    size_t nSize;
+
+    uint32_t HashKey(const K& key) const { return (uint32_t)hasher(key); }
+
+    size_t Distance(size_t pos, uint32_t hash) const { return (pos - hash) & (table.size() - 1); }
+
+    Node* AllocateNode()
+    {
+        if (pFree != nullptr) {
+            Node* node = pFree;
+            pFree = node->next_free();
+            return node;
+        }
+        if (chunks.empty() || nChunkUsed == chunks.back().size) {
+            size_t nChunkSize = chunks.empty() ? MIN_CHUNK_NODES : chunks.back().size * 2;
+            if (nChunkSize > MAX_CHUNK_NODES)
+                nChunkSize = MAX_CHUNK_NODES;
+            chunks.push_back(Chunk{std::unique_ptr<Node[]>(new Node[nChunkSize]), nChunkSize});
+            nChunkUsed = 0;
+        }
+        Node* node = &chunks.back().nodes[nChunkUsed++];
+        node->chunk = chunks.size() - 1;
+        node->live = false;
+        return node;
+    }
+
+    void FreeNode(Node* node)
+    {
+        node->live = false;
+        node->next_free() = pFree;
+        pFree = node;
+    }
+
+    /** Index of the slot holding node, which must be in the table */
+    size_t FindSlot(const Node* node, uint32_t hash) const
+    {
+        const size_t mask = table.size() - 1;
+        for (size_t pos = hash & mask; ; pos = (pos + 1) & mask) {
+            if (table[pos].node == node)
+                return pos;
+        }
+    }
+
+    Node* FindNode(const K& key, uint32_t hash) const
+    {
+        if (table.empty())
+            return nullptr;
+        const size_t mask = table.size() - 1;
+        size_t dist = 0;
+        for (size_t pos = hash & mask; ; pos = (pos + 1) & mask, dist++) {
+            const Slot& slot = table[pos];
+            if (slot.node == nullptr || Distance(pos, slot.hash) < dist)
+                return nullptr;
+            if (slot.hash == hash && slot.node->value().first == key)
+                return slot.node;
+        }
+    }
+
+    void InsertSlot(Slot slot)
+    {
+        const size_t mask = table.size() - 1;
+        size_t dist = 0;
+        for (size_t pos = slot.hash & mask; ; pos = (pos + 1) & mask, dist++) {
+            Slot& cur = table[pos];
+            if (cur.node == nullptr) {
+                cur = slot;
+                return;
+            }
+            // Robin hood: take the place of an entry that is closer to its home slot
+            const size_t curDist = Distance(pos, cur.hash);
+            if (curDist < dist) {
+                std::swap(cur, slot);
+                dist = curDist;
+            }
+        }
+    }
+
+    void Rehash(size_t nTableSize)
+    {
+        std::vector<Slot> old(nTableSize, Slot{nullptr, 0});
+        old.swap(table);
+        for (const Slot& slot : old) {
+            if (slot.node != nullptr)
+                InsertSlot(slot);
+        }
+    }
+
+    void ReserveOneMore()
+    {
+        // Keep the load factor at most 7/8
+        if ((nSize + 1) * 8 > table.size() * 7)
+            Rehash(std::max<size_t>(16, table.size() * 2));
+    }
+
+    template <bool Const>
+    class iterator_base
+    {
+    private:
+        friend class arenamap;
+        typedef typename std::conditional<Const, const arenamap*, arenamap*>::type map_ptr;
+        map_ptr map;
+        Node* node;
+
+        iterator_base(map_ptr mapIn, Node* nodeIn) : map(mapIn), node(nodeIn) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename arenamap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+        iterator_base() : map(nullptr), node(nullptr) {}
+        template <bool C = Const, typename std::enable_if<C, int>::type = 0>
+        iterator_base(const iterator_base<false>& it) : map(it.map), node(it.node) {}
+
+        reference operator*() const { return node->value(); }
+        pointer operator->() const { return &node->value(); }
+        iterator_base& operator++() { node = map->NextLive(node); return *this; }
+        iterator_base operator++(int) { iterator_base copy(*this); ++(*this); return copy; }
+        bool operator==(const iterator_base& other) const { return node == other.node; }
+        bool operator!=(const iterator_base& other) const { return node != other.node; }
+
+        template <bool> friend class iterator_base;
+    };
+
+    /** The first live node at or after position index of chunk nChunk */
+    Node* FirstLive(size_t nChunk, size_t index) const
+    {
+        for (; nChunk < chunks.size(); nChunk++, index = 0) {
+            const size_t nUsed = nChunk + 1 == chunks.size() ? nChunkUsed : chunks[nChunk].size;
+            for (; index < nUsed; index++) {
+                Node* node = &chunks[nChunk].nodes[index];
+                if (node->live)
+                    return node;
+            }
+        }
+        return nullptr;
+    }
+
+    Node* NextLive(const Node* node) const
+    {
+        return FirstLive(node->chunk, node - chunks[node->chunk].nodes.get() + 1);
+    }
+
+public:
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+
+    arenamap() : nChunkUsed(0), pFree(nullptr), nSize(0) {}
+
+    arenamap(arenamap&& other) :
+        hasher(other.hasher), table(std::move(other.table)), chunks(std::move(other.chunks)),
+        nChunkUsed(other.nChunkUsed), pFree(other.pFree), nSize(other.nSize)
+    {
+        other.table.clear();
+        other.chunks.clear();
+        other.nChunkUsed = 0;
+        other.pFree = nullptr;
+        other.nSize = 0;
+    }
+
+    arenamap(const arenamap&) = delete;
+    arenamap& operator=(const arenamap&) = delete;
+
+    ~arenamap() { clear(); }
+
+    iterator begin() { return iterator(this, FirstLive(0, 0)); }
+    iterator end() { return iterator(this, nullptr); }
+    const_iterator begin() const { return const_iterator(this, FirstLive(0, 0)); }
+    const_iterator end() const { return const_iterator(this, nullptr); }
+
+    size_type size() const { return nSize; }
+    bool empty() const { return nSize == 0; }
+
+    iterator find(const K& key) { return iterator(this, FindNode(key, HashKey(key))); }
+    const_iterator find(const K& key) const { return const_iterator(this, FindNode(key, HashKey(key))); }
+    size_type count(const K& key) const { return FindNode(key, HashKey(key)) != nullptr; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        // Construct the entry first to get at its key, like std::unordered_map does
+        Node* node = AllocateNode();
+        try {
+            new (&node->storage) value_type(std::forward<Args>(args)...);
+        } catch (...) {
+            FreeNode(node);
+            throw;
+        }
+        const uint32_t hash = HashKey(node->value().first);
+        Node* existing = FindNode(node->value().first, hash);
+        if (existing != nullptr) {
+            node->value().~value_type();
+            FreeNode(node);
+            return std::make_pair(iterator(this, existing), false);
+        }
+        ReserveOneMore();
+        InsertSlot(Slot{node, hash});
+        node->live = true;
+        nSize++;
+        return std::make_pair(iterator(this, node), true);
+    }
+
+    T& operator[](const K& key)
+    {
+        const uint32_t hash = HashKey(key);
+        Node* node = FindNode(key, hash);
+        if (node != nullptr)
+            return node->value().second;
+        return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+    }
+
+    /** Look an entry up that must exist; throws std::out_of_range otherwise, like std::unordered_map. */
+    T& at(const K& key)
+    {
+        Node* node = FindNode(key, HashKey(key));
+        if (node == nullptr)
+            throw std::out_of_range("arenamap::at");
+        return node->value().second;
+    }
+
+    const T& at(const K& key) const
+    {
+        Node* node = FindNode(key, HashKey(key));
+        if (node == nullptr)
+            throw std::out_of_range("arenamap::at");
+        return node->value().second;
+    }
+
+    /** Erase the entry it points to. Returns an iterator to the entry after it. */
+    iterator erase(const_iterator it)
+    {
+        Node* node = it.node;
+        Node* next = NextLive(node);
+        // Backward shift deletion: move the following entries of the probe
+        // sequence one slot back so that no tombstones are needed
+        const size_t mask = table.size() - 1;
+        size_t pos = FindSlot(node, HashKey(node->value().first));
+        for (size_t nextPos = (pos + 1) & mask; table[nextPos].node != nullptr && Distance(nextPos, table[nextPos].hash) > 0; nextPos = (nextPos + 1) & mask) {
+            table[pos] = table[nextPos];
+            pos = nextPos;
+        }
+        table[pos] = Slot{nullptr, 0};
+        node->value().~value_type();
+        FreeNode(node);
+        nSize--;
+        return iterator(this, next);
+    }
+
+    size_type erase(const K& key)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    /** Destroy all entries and release the table and the arena. */
+    void clear()
+    {
+        for (size_t nChunk = 0; nChunk < chunks.size(); nChunk++) {
+            const size_t nUsed = nChunk + 1 == chunks.size() ? nChunkUsed : chunks[nChunk].size;
+            for (size_t i = 0; i < nUsed; i++) {
+                Node& node = chunks[nChunk].nodes[i];
+                if (node.live)
+                    node.value().~value_type();
+            }
+        }
+        std::vector<Chunk>().swap(chunks);
+        std::vector<Slot>().swap(table);
+        nChunkUsed = 0;
+        pFree = nullptr;
+        nSize = 0;
+    }
+
+    /** Allocated sizes of the probe table and the arena chunks, in bytes. */
+    size_t TableBytes() const { return table.capacity() * sizeof(Slot); }
+    size_t ChunkBytes(size_t nChunk) const { return chunks[nChunk].size * sizeof(Node); }
+    size_t ChunkCount() const { return chunks.size(); }
+    size_t ChunkVectorBytes() const { return chunks.capacity() * sizeof(Chunk); }
+};
+
+#endif // SYSCOIN_ARENAMAP_H
@@ -13,6 +13,7 @@
 #include <serialize.h>
 #include <uint256.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -188,6 +189,96 @@ public:
    */
   static CPureBlockHeader& initAuxPow (CBlockHeader& header);
 
+  /**
+   * Reads past a serialised auxpow without constructing it.  This is much
+   * cheaper than deserialising, since the parent coinbase is neither
+   * allocated nor hashed.  Used for SERIALIZE_BLOCK_NO_AUXPOW.
+   */
+  template<typename Stream>
+    static void
+    Skip (Stream& s)
+  {
+    /* coinbaseTx */
+    SkipTransaction (s);
+    SkipBytes (s, sizeof (uint256));
+    SkipBytes (s, ReadCompactSize (s) * sizeof (uint256));
+    SkipBytes (s, sizeof (int));
+    /* vChainMerkleBranch, nChainIndex, parentBlock */
+    SkipBytes (s, ReadCompactSize (s) * sizeof (uint256));
+    SkipBytes (s, sizeof (int));
+    SkipBytes (s, ::GetSerializeSize (CPureBlockHeader (), SER_NETWORK, 0));
+  }
+
+private:
+
+  template<typename Stream>
+    static void
+    SkipBytes (Stream& s, uint64_t nSize)
+  {
+    char buf[256];
+    while (nSize > 0)
+      {
+        const size_t nNow = std::min<uint64_t> (nSize, sizeof (buf));
+        s.read (buf, nNow);
+        nSize -= nNow;
+      }
+  }
+
+  /* Mirrors UnserializeTransaction.  */
+  template<typename Stream>
+    static void
+    SkipTransaction (Stream& s)
+  {
+    const bool fAllowWitness = !(s.GetVersion () & SERIALIZE_TRANSACTION_NO_WITNESS);
+    const auto skipScript = [&s] () { SkipBytes (s, ReadCompactSize (s)); };
+    const auto skipInputs = [&s, &skipScript] () {
+      const uint64_t nIn = ReadCompactSize (s);
+      for (uint64_t i = 0; i < nIn; ++i)
+        {
+          SkipBytes (s, sizeof (uint256) + sizeof (uint32_t));
+          skipScript ();
+          SkipBytes (s, sizeof (uint32_t));
+        }
+      return nIn;
+    };
+    const auto skipOutputs = [&s, &skipScript] () {
+      const uint64_t nOut = ReadCompactSize (s);
+      for (uint64_t i = 0; i < nOut; ++i)
+        {
+          SkipBytes (s, sizeof (CAmount));
+          skipScript ();
+        }
+    };
+
+    SkipBytes (s, sizeof (int32_t));
+    unsigned char flags = 0;
+    uint64_t nIn = skipInputs ();
+    if (nIn == 0 && fAllowWitness)
+      {
+        s >> flags;
+        if (flags != 0)
+          {
+            nIn = skipInputs ();
+            skipOutputs ();
+          }
+      }
+    else
+      skipOutputs ();
+    if ((flags & 1) && fAllowWitness)
+      {
+        flags ^= 1;
+        for (uint64_t i = 0; i < nIn; ++i)
+          {
+            const uint64_t nItems = ReadCompactSize (s);
+            for (uint64_t j = 0; j < nItems; ++j)
+              skipScript ();
+          }
+      }
+    if (flags)
+      throw std::ios_base::failure ("Unknown transaction optional data");
+    SkipBytes (s, sizeof (uint32_t));
+  }
+
 };
 
 #endif // SYSCOIN_AUXPOW_H
@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 
 #include <crypto/sha256.h>
+#include <ethereum/SHA3.h>
 #include <key.h>
 #include <random.h>
 #include <util.h>
@@ -65,6 +66,7 @@ int main(int argc, char** argv)
     const fs::path bench_datadir{SetDataDir()};
 
     SHA256AutoDetect();
+    dev::SHA3AutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
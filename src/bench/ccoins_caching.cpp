@@ -2,11 +2,14 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <arenamap.h>
 #include <bench/bench.h>
 #include <coins.h>
 #include <policy/policy.h>
+#include <random.h>
 #include <wallet/crypter.h>
 
+#include <unordered_map>
 #include <vector>
 
 // FIXME: Dedup with SetupDummyInputs in test/transaction_tests.cpp.
@@ -85,3 +88,53 @@ static void CCoinsCaching(benchmark::State& state)
 }
 
 BENCHMARK(CCoinsCaching, 170 * 1000);
+
+static const size_t COINS_MAP_ENTRIES = 100000;
+
+// Block-connect-like access pattern on the coins map itself: fill it with
+// coins, look every one up, spend half of them and clear it as a flush does.
+template <typename Map>
+static void CoinsMapConnect(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(COINS_MAP_ENTRIES);
+    for (size_t i = 0; i < COINS_MAP_ENTRIES; i++)
+        outpoints.emplace_back(rng.rand256(), rng.randrange(4));
+    Coin coin;
+    coin.out.nValue = 50 * CENT;
+    coin.out.scriptPubKey << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 1) << OP_EQUALVERIFY << OP_CHECKSIG;
+    coin.nHeight = 1;
+
+    Map map;
+    while (state.KeepRunning()) {
+        for (const COutPoint& outpoint : outpoints) {
+            CCoinsCacheEntry& entry = map.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::tuple<>()).first->second;
+            entry.coin = coin;
+            entry.flags = CCoinsCacheEntry::DIRTY | CCoinsCacheEntry::FRESH;
+        }
+        CAmount total = 0;
+        for (const COutPoint& outpoint : outpoints) {
+            auto it = map.find(outpoint);
+            assert(it != map.end());
+            total += it->second.coin.out.nValue;
+        }
+        assert(total == (CAmount)COINS_MAP_ENTRIES * 50 * CENT);
+        for (size_t i = 0; i < outpoints.size(); i += 2)
+            map.erase(map.find(outpoints[i]));
+        map.clear();
+    }
+}
+
+static void CoinsMapConnectUnordered(benchmark::State& state)
+{
+    CoinsMapConnect<std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher>>(state);
+}
+
+static void CoinsMapConnectArena(benchmark::State& state)
+{
+    CoinsMapConnect<arenamap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher>>(state);
+}
+
+BENCHMARK(CoinsMapConnectUnordered, 20);
+BENCHMARK(CoinsMapConnectArena, 20);
@@ -14,6 +14,7 @@
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha512.h>
+#include <ethereum/SHA3.h>
 
 /* Number of bytes to hash per iteration */
 static const uint64_t BUFFER_SIZE = 1000*1000;
@@ -60,6 +61,52 @@ static void SHA256D64_1024(benchmark::State& state)
     }
 }
 
+/* 1024 transaction-sized messages, hashed one by one and together */
+static void SHA256D_250b_1024(benchmark::State& state)
+{
+    std::vector<uint8_t> in(250 * 1024, 0);
+    std::vector<uint8_t> out(32 * 1024);
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1024; i++)
+            CHash256().Write(in.data() + 250 * i, 250).Finalize(out.data() + 32 * i);
+    }
+}
+
+static void SHA256DMulti_250b_1024(benchmark::State& state)
+{
+    std::vector<uint8_t> in(250 * 1024, 0);
+    std::vector<uint8_t> out(32 * 1024);
+    std::vector<const uint8_t*> inputs(1024);
+    std::vector<size_t> lengths(1024, 250);
+    for (int i = 0; i < 1024; i++)
+        inputs[i] = in.data() + 250 * i;
+    while (state.KeepRunning()) {
+        SHA256DMulti(out.data(), inputs.data(), lengths.data(), 1024);
+    }
+}
+
+static void KECCAK256_532b_64(benchmark::State& state)
+{
+    std::vector<uint8_t> in(532 * 64, 0);
+    std::vector<dev::h256> out(64);
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 64; i++)
+            dev::sha3(dev::bytesConstRef(in.data() + 532 * i, 532), out[i].ref());
+    }
+}
+
+static void KECCAK256Multi_532b_64(benchmark::State& state)
+{
+    std::vector<uint8_t> in(532 * 64, 0);
+    std::vector<dev::h256> out(64);
+    std::vector<dev::bytesConstRef> inputs;
+    for (int i = 0; i < 64; i++)
+        inputs.emplace_back(in.data() + 532 * i, 532);
+    while (state.KeepRunning()) {
+        dev::sha3Multi(inputs.data(), out.data(), 64);
+    }
+}
+
 static void SHA512(benchmark::State& state)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -103,5 +150,9 @@ BENCHMARK(SHA512, 330);
 BENCHMARK(SHA256_32b, 4700 * 1000);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
 BENCHMARK(SHA256D64_1024, 7400);
+BENCHMARK(SHA256D_250b_1024, 1500);
+BENCHMARK(SHA256DMulti_250b_1024, 3000);
+BENCHMARK(KECCAK256_532b_64, 2000);
+BENCHMARK(KECCAK256Multi_532b_64, 6000);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
 BENCHMARK(FastRandom_1bit, 440 * 1000 * 1000);
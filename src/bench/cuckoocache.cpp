@@ -0,0 +1,78 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <cuckoocache.h>
+#include <random.h>
+#include <script/sigcache.h>
+#include <util.h>
+
+#include <thread>
+#include <vector>
+
+static const int MIN_CORES = 2;
+static const size_t CACHE_BYTES = 4 << 20;
+static const size_t LOOKUPS_PER_THREAD = 20000;
+
+/** A single cache behind one reader/writer lock, the way the signature cache used to share it */
+class LockedCuckooCache
+{
+    CuckooCache::cache<uint256, SignatureCacheHasher> set;
+    mutable boost::shared_mutex mtx;
+
+public:
+    uint32_t setup_bytes(size_t bytes) { return set.setup_bytes(bytes); }
+    void insert(const uint256& e)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(mtx);
+        set.insert(e);
+    }
+    bool contains(const uint256& e, const bool erase) const
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mtx);
+        return set.contains(e, erase);
+    }
+};
+
+// Every thread looks up entries like a script check thread would, inserting
+// the ones that miss. Half of the entries were cached beforehand.
+template <typename Cache>
+static void CuckooCacheConcurrent(benchmark::State& state)
+{
+    const size_t nThreads = std::max(MIN_CORES, GetNumCores());
+    FastRandomContext insecure_rand(true);
+    std::vector<uint256> entries(nThreads * LOOKUPS_PER_THREAD);
+    for (uint256& entry : entries)
+        entry = insecure_rand.rand256();
+    while (state.KeepRunning()) {
+        Cache set;
+        set.setup_bytes(CACHE_BYTES);
+        for (size_t i = 0; i < entries.size(); i += 2)
+            set.insert(entries[i]);
+        std::vector<std::thread> threads;
+        for (size_t x = 0; x < nThreads; ++x) {
+            threads.emplace_back([&, x] {
+                for (size_t i = x; i < entries.size(); i += nThreads) {
+                    if (!set.contains(entries[i], false))
+                        set.insert(entries[i]);
+                }
+            });
+        }
+        for (std::thread& t : threads)
+            t.join();
+    }
+}
+
+static void CuckooCacheLocked(benchmark::State& state)
+{
+    CuckooCacheConcurrent<LockedCuckooCache>(state);
+}
+
+static void CuckooCacheSharded(benchmark::State& state)
+{
+    CuckooCacheConcurrent<CuckooCache::sharded_cache<uint256, SignatureCacheHasher>>(state);
+}
+
+BENCHMARK(CuckooCacheLocked, 20);
+BENCHMARK(CuckooCacheSharded, 20);
@@ -0,0 +1,122 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <fs.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <vector>
+
+// Compare the LevelDB profiles on records shaped like asset allocations:
+// small keys, values of around a hundred bytes. Run with `make dbbench`.
+static const int DB_BENCH_RECORDS = 20000;
+static const size_t DB_BENCH_CACHE = 8 << 20;
+
+static fs::path DBBenchPath(const std::string& name)
+{
+    return fs::temp_directory_path() / fs::unique_path(strprintf("syscoin_dbbench_%s_%%%%%%%%", name));
+}
+
+static std::vector<unsigned char> DBBenchValue(FastRandomContext& rng)
+{
+    // Half random, half repetitive, like a serialized allocation with its address and amounts
+    std::vector<unsigned char> value = rng.randbytes(48);
+    value.resize(96, 0x51);
+    return value;
+}
+
+static void DBProfileWrite(benchmark::State& state, const char* profile_name)
+{
+    const DBProfile* profile = FindDBProfile(profile_name);
+    assert(profile);
+    FastRandomContext rng(true);
+    const fs::path path = DBBenchPath(profile_name);
+    {
+        CDBWrapper db(path, DB_BENCH_CACHE, false, true, false, profile);
+        uint32_t n = 0;
+        while (state.KeepRunning()) {
+            CDBBatch batch(db);
+            for (int i = 0; i < 1000; i++, n++)
+                batch.Write(std::make_pair('a', n % DB_BENCH_RECORDS), DBBenchValue(rng));
+            db.WriteBatch(batch);
+        }
+    }
+    fs::remove_all(path);
+}
+
+static void DBProfileRead(benchmark::State& state, const char* profile_name)
+{
+    const DBProfile* profile = FindDBProfile(profile_name);
+    assert(profile);
+    FastRandomContext rng(true);
+    const fs::path path = DBBenchPath(profile_name);
+    {
+        CDBWrapper db(path, DB_BENCH_CACHE, false, true, false, profile);
+        CDBBatch batch(db);
+        for (uint32_t n = 0; n < DB_BENCH_RECORDS; n++)
+            batch.Write(std::make_pair('a', n), DBBenchValue(rng));
+        db.WriteBatch(batch, true);
+        db.CompactRange(std::make_pair('a', (uint32_t)0), std::make_pair('a', (uint32_t)DB_BENCH_RECORDS));
+
+        std::vector<unsigned char> value;
+        while (state.KeepRunning()) {
+            // Hits and misses, as lookups of allocations that may not exist yet
+            for (int i = 0; i < 1000; i++)
+                db.Read(std::make_pair('a', (uint32_t)rng.randrange(2 * DB_BENCH_RECORDS)), value);
+        }
+    }
+    fs::remove_all(path);
+}
+
+static void DBProfileScan(benchmark::State& state, const char* profile_name)
+{
+    const DBProfile* profile = FindDBProfile(profile_name);
+    assert(profile);
+    FastRandomContext rng(true);
+    const fs::path path = DBBenchPath(profile_name);
+    {
+        CDBWrapper db(path, DB_BENCH_CACHE, false, true, false, profile);
+        CDBBatch batch(db);
+        for (uint32_t n = 0; n < DB_BENCH_RECORDS; n++)
+            batch.Write(std::make_pair('a', n), DBBenchValue(rng));
+        db.WriteBatch(batch, true);
+        db.CompactRange(std::make_pair('a', (uint32_t)0), std::make_pair('a', (uint32_t)DB_BENCH_RECORDS));
+
+        std::vector<unsigned char> value;
+        while (state.KeepRunning()) {
+            std::unique_ptr<CDBIterator> it(db.NewIterator());
+            for (it->Seek(std::make_pair('a', (uint32_t)0)); it->Valid(); it->Next())
+                it->GetValue(value);
+        }
+    }
+    fs::remove_all(path);
+}
+
+static void DBProfileWriteDefault(benchmark::State& state) { DBProfileWrite(state, "default"); }
+static void DBProfileWriteLookup(benchmark::State& state) { DBProfileWrite(state, "lookup"); }
+static void DBProfileWriteArchive(benchmark::State& state) { DBProfileWrite(state, "archive"); }
+static void DBProfileWriteScan(benchmark::State& state) { DBProfileWrite(state, "scan"); }
+static void DBProfileReadDefault(benchmark::State& state) { DBProfileRead(state, "default"); }
+static void DBProfileReadLookup(benchmark::State& state) { DBProfileRead(state, "lookup"); }
+static void DBProfileReadArchive(benchmark::State& state) { DBProfileRead(state, "archive"); }
+static void DBProfileReadScan(benchmark::State& state) { DBProfileRead(state, "scan"); }
+static void DBProfileScanDefault(benchmark::State& state) { DBProfileScan(state, "default"); }
+static void DBProfileScanLookup(benchmark::State& state) { DBProfileScan(state, "lookup"); }
+static void DBProfileScanArchive(benchmark::State& state) { DBProfileScan(state, "archive"); }
+static void DBProfileScanScan(benchmark::State& state) { DBProfileScan(state, "scan"); }
+
+BENCHMARK(DBProfileWriteDefault, 20);
+BENCHMARK(DBProfileWriteLookup, 20);
+BENCHMARK(DBProfileWriteArchive, 20);
+BENCHMARK(DBProfileWriteScan, 20);
+BENCHMARK(DBProfileReadDefault, 50);
+BENCHMARK(DBProfileReadLookup, 50);
+BENCHMARK(DBProfileReadArchive, 50);
+BENCHMARK(DBProfileReadScan, 50);
+BENCHMARK(DBProfileScanDefault, 5);
+BENCHMARK(DBProfileScanLookup, 5);
+BENCHMARK(DBProfileScanArchive, 5);
+BENCHMARK(DBProfileScanScan, 5);
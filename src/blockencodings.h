@@ -86,12 +86,16 @@ public:
         uint64_t txn_size = (uint64_t)txn.size();
         READWRITE(COMPACTSIZE(txn_size));
         if (ser_action.ForRead()) {
+            // SYSCOIN read the transactions first, so that their hashes are computed together
+            std::vector<CMutableTransaction> txs;
             size_t i = 0;
-            while (txn.size() < txn_size) {
-                txn.resize(std::min((uint64_t)(1000 + txn.size()), txn_size));
-                for (; i < txn.size(); i++)
-                    READWRITE(TransactionCompressor(txn[i]));
+            while (txs.size() < txn_size) {
+                txs.resize(std::min((uint64_t)(1000 + txs.size()), txn_size));
+                for (; i < txs.size(); i++)
+                    READWRITE(txs[i]);
             }
+            txn.clear();
+            MakeTransactionRefs(std::move(txs), txn);
         } else {
             for (size_t i = 0; i < txn.size(); i++)
                 READWRITE(TransactionCompressor(txn[i]));
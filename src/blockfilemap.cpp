@@ -0,0 +1,191 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilemap.h>
+
+#include <crypto/common.h>
+#include <fs.h>
+#include <serialize.h>
+#include <thread_pool/thread_pool.hpp>
+#include <util.h>
+#include <validation.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CBlockFileMap g_blockfilemap;
+
+/** Serialized blocks are preceded by the network magic and their size */
+static const unsigned int BLOCK_HEADER_BYTES = 8;
+
+#ifndef WIN32
+static size_t GetPageSize()
+{
+    static const size_t nPageSize = sysconf(_SC_PAGESIZE) > 0 ? sysconf(_SC_PAGESIZE) : 4096;
+    return nPageSize;
+}
+
+/** Give the kernel a hint about a byte range of a mapping. */
+static void AdviseRange(const CMappedBlockFile& file, size_t nBegin, size_t nEnd, int advice)
+{
+    nEnd = std::min(nEnd, file.size);
+    if (nBegin >= nEnd)
+        return;
+    const size_t nAligned = nBegin - nBegin % GetPageSize();
+    madvise(const_cast<unsigned char*>(file.data) + nAligned, nEnd - nAligned, advice);
+}
+
+/** Fault the pages of a range in so a later read does not block on I/O. */
+static void TouchRange(const CMappedBlockFile& file, size_t nBegin, size_t nEnd)
+{
+    volatile unsigned char sink = 0;
+    nEnd = std::min(nEnd, file.size);
+    for (size_t n = nBegin; n < nEnd; n += GetPageSize())
+        sink ^= file.data[n];
+    (void)sink;
+}
+#endif
+
+CMappedBlockFile::~CMappedBlockFile()
+{
+#ifndef WIN32
+    munmap(const_cast<unsigned char*>(data), size);
+#endif
+}
+
+CBlockFileMap::CBlockFileMap() : nUseCounter(0), fEnabled(DEFAULT_MMAP_BLOCKS && Supported())
+{
+}
+
+bool CBlockFileMap::Supported()
+{
+#ifdef WIN32
+    return false;
+#else
+    // Mapping every block file needs a 64-bit address space
+    return sizeof(void*) >= 8;
+#endif
+}
+
+void CBlockFileMap::SetEnabled(bool fEnabledIn)
+{
+    LOCK(cs);
+    fEnabled = fEnabledIn && Supported();
+    if (!fEnabled)
+        mapFiles.clear();
+}
+
+bool CBlockFileMap::Enabled() const
+{
+    LOCK(cs);
+    return fEnabled;
+}
+
+std::shared_ptr<const CMappedBlockFile> CBlockFileMap::MapFile(int nFile, size_t nMinSize)
+{
+    AssertLockHeld(cs);
+    auto it = mapFiles.find(nFile);
+    if (it != mapFiles.end() && it->second.file->size >= nMinSize) {
+        it->second.nLastUse = ++nUseCounter;
+        return it->second.file;
+    }
+#ifdef WIN32
+    return nullptr;
+#else
+    // Not mapped yet, or the file has grown since it was mapped
+    const fs::path path = GetBlockPosFilename(CDiskBlockPos(nFile, 0), "blk");
+    int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size < nMinSize) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t nSize = st.st_size;
+    void* data = mmap(nullptr, nSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        LogPrintf("%s: mmap of %s failed: %s\n", __func__, path.string(), strerror(errno));
+        return nullptr;
+    }
+    std::shared_ptr<const CMappedBlockFile> file = std::make_shared<const CMappedBlockFile>(static_cast<const unsigned char*>(data), nSize);
+    mapFiles[nFile] = MappedFileEntry{file, ++nUseCounter};
+
+    // Keep the number of mappings bounded by dropping the least recently used one
+    if (mapFiles.size() > MAX_MAPPED_BLOCK_FILES) {
+        auto itOldest = mapFiles.begin();
+        for (auto itFile = mapFiles.begin(); itFile != mapFiles.end(); ++itFile) {
+            if (itFile->second.nLastUse < itOldest->second.nLastUse)
+                itOldest = itFile;
+        }
+        mapFiles.erase(itOldest);
+    }
+    return file;
+#endif
+}
+
+std::shared_ptr<const CMappedBlockFile> CBlockFileMap::GetBlock(const CDiskBlockPos& pos, const unsigned char*& pblock, unsigned int& nBlockSize)
+{
+    if (pos.IsNull() || pos.nPos < BLOCK_HEADER_BYTES)
+        return nullptr;
+
+    LOCK(cs);
+    if (!fEnabled)
+        return nullptr;
+    std::shared_ptr<const CMappedBlockFile> file = MapFile(pos.nFile, pos.nPos);
+    if (!file)
+        return nullptr;
+    const unsigned int nSize = ReadLE32(file->data + pos.nPos - 4);
+    if (nSize == 0 || nSize > MAX_SIZE)
+        return nullptr;
+    if ((uint64_t)pos.nPos + nSize > file->size) {
+        file = MapFile(pos.nFile, (size_t)pos.nPos + nSize);
+        if (!file)
+            return nullptr;
+    }
+#ifndef WIN32
+    // Read the whole block in one go instead of faulting it in page by page
+    AdviseRange(*file, pos.nPos, (size_t)pos.nPos + nSize, MADV_WILLNEED);
+#endif
+    pblock = file->data + pos.nPos;
+    nBlockSize = nSize;
+    return file;
+}
+
+void CBlockFileMap::Prefetch(const std::vector<CDiskBlockPos>& vPos)
+{
+#ifndef WIN32
+    for (const CDiskBlockPos& pos : vPos) {
+        const unsigned char* pblock;
+        unsigned int nSize;
+        std::shared_ptr<const CMappedBlockFile> file = GetBlock(pos, pblock, nSize);
+        if (!file)
+            continue;
+        // GetBlock already issued the read-ahead hint; also fault the pages
+        // in on the thread pool so several blocks are read concurrently.
+        if (threadpool == nullptr)
+            continue;
+        const size_t nBegin = pos.nPos;
+        const size_t nEnd = nBegin + nSize;
+        threadpool->tryPost([file, nBegin, nEnd] { TouchRange(*file, nBegin, nEnd); });
+    }
+#endif
+}
+
+void CBlockFileMap::Evict(int nFile)
+{
+    LOCK(cs);
+    mapFiles.erase(nFile);
+}
+
+void CBlockFileMap::Clear()
+{
+    LOCK(cs);
+    mapFiles.clear();
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_BLOCKFILEMAP_H
+#define SYSCOIN_BLOCKFILEMAP_H
+
+#include <chain.h>
+#include <sync.h>
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+/** Default for -mmapblocks */
+static const bool DEFAULT_MMAP_BLOCKS = true;
+/** Default for -blockprefetch, the number of blocks read ahead of sequential scans */
+static const int DEFAULT_BLOCK_PREFETCH = 16;
+/** Maximum number of block files kept mapped at the same time */
+static const unsigned int MAX_MAPPED_BLOCK_FILES = 64;
+
+/** A read-only mapping of one blk?????.dat file. Unmapped when the last reference goes away. */
+class CMappedBlockFile
+{
+public:
+    const unsigned char* const data;
+    const size_t size;
+
+    CMappedBlockFile(const unsigned char* dataIn, size_t sizeIn) : data(dataIn), size(sizeIn) {}
+    ~CMappedBlockFile();
+
+    CMappedBlockFile(const CMappedBlockFile&) = delete;
+    CMappedBlockFile& operator=(const CMappedBlockFile&) = delete;
+};
+
+/**
+ * Serves block reads straight out of memory-mapped block files, so that a
+ * block is deserialized from the page cache without a fopen/fseek/fread
+ * round trip per block.
+ *
+ * Files are mapped lazily and remapped when a read goes past the end of the
+ * current mapping (the file being appended to grows). Callers keep the
+ * returned mapping alive while they read from it, so remapping or evicting a
+ * file never invalidates a span in use. Mapping is not available on Windows
+ * or 32-bit platforms; GetBlock() then fails and callers fall back to stdio.
+ */
+class CBlockFileMap
+{
+private:
+    mutable CCriticalSection cs;
+    struct MappedFileEntry {
+        std::shared_ptr<const CMappedBlockFile> file;
+        uint64_t nLastUse;
+    };
+    std::map<int, MappedFileEntry> mapFiles;
+    uint64_t nUseCounter;
+    bool fEnabled;
+
+    std::shared_ptr<const CMappedBlockFile> MapFile(int nFile, size_t nMinSize);
+
+public:
+    CBlockFileMap();
+
+    /** Whether mapping is possible on this platform at all. */
+    static bool Supported();
+
+    void SetEnabled(bool fEnabledIn);
+    bool Enabled() const;
+
+    /**
+     * Look up the block stored at pos. On success pblock/nBlockSize describe
+     * the serialized block inside the returned mapping, which must be kept
+     * alive while reading. Returns nullptr if the block cannot be served from
+     * a mapping.
+     */
+    std::shared_ptr<const CMappedBlockFile> GetBlock(const CDiskBlockPos& pos, const unsigned char*& pblock, unsigned int& nBlockSize);
+
+    /**
+     * Ask for the given blocks to be read into memory ahead of use. The kernel
+     * is told which ranges are needed, and the pages are faulted in on the
+     * thread pool so that several blocks are read in parallel.
+     */
+    void Prefetch(const std::vector<CDiskBlockPos>& vPos);
+
+    /** Drop the mapping of a file, e.g. before it is pruned. */
+    void Evict(int nFile);
+    void Clear();
+};
+
+extern CBlockFileMap g_blockfilemap;
+
+#endif // SYSCOIN_BLOCKFILEMAP_H
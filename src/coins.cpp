@@ -19,6 +19,19 @@ bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
     return GetCoin(outpoint, coin);
 }
 
+size_t CCoinsView::GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const
+{
+    size_t nFound = 0;
+    coins.resize(outpoints.size());
+    for (size_t i = 0; i < outpoints.size(); i++) {
+        if (GetCoin(outpoints[i], coins[i]))
+            nFound++;
+        else
+            coins[i].Clear();
+    }
+    return nFound;
+}
+
 CCoinsViewBacked::CCoinsViewBacked(CCoinsView *viewIn) : base(viewIn) { }
 bool CCoinsViewBacked::GetCoin(const COutPoint &outpoint, Coin &coin) const { return base->GetCoin(outpoint, coin); }
 bool CCoinsViewBacked::HaveCoin(const COutPoint &outpoint) const { return base->HaveCoin(outpoint); }
@@ -216,6 +229,19 @@ void CCoinsViewCache::Uncache(const COutPoint& hash)
     }
 }
 
+void CCoinsViewCache::Warm(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins)
+{
+    assert(outpoints.size() == coins.size());
+    for (size_t i = 0; i < outpoints.size(); i++) {
+        if (coins[i].IsSpent())
+            continue;
+        // emplace does nothing if the outpoint is cached already, which may hold a newer version
+        auto ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoints[i]), std::forward_as_tuple(std::move(coins[i])));
+        if (ret.second)
+            cachedCoinsUsage += ret.first->second.coin.DynamicMemoryUsage();
+    }
+}
+
 unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
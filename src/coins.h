@@ -6,6 +6,10 @@
 #ifndef SYSCOIN_COINS_H
 #define SYSCOIN_COINS_H
 
+#if defined(HAVE_CONFIG_H)
+#include <config/syscoin-config.h>
+#endif
+
 #include <primitives/transaction.h>
 #include <compressor.h>
 #include <core_memusage.h>
@@ -119,7 +123,11 @@ struct CCoinsCacheEntry
     explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
 };
 
+#ifdef USE_ARENA_COINSMAP
+typedef arenamap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+#else
 typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+#endif
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -151,6 +159,13 @@ public:
      */
     virtual bool GetCoin(const COutPoint &outpoint, Coin &coin) const;
 
+    /** Retrieve the Coins for many outpoints at once. coins[i] is left spent
+     *  when outpoints[i] has no unspent coin. Returns the number of coins found.
+     *  The default calls GetCoin() for each outpoint; views that can do better
+     *  in bulk, like the database, override it.
+     */
+    virtual size_t GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const;
+
     //! Just check whether a given outpoint is unspent.
     virtual bool HaveCoin(const COutPoint &outpoint) const;
 
@@ -191,6 +206,7 @@ public:
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
+    CCoinsView *GetBackend() const { return base; }
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
     size_t EstimateSize() const override;
@@ -274,6 +290,13 @@ public:
      */
     void Uncache(const COutPoint &outpoint);
 
+    /**
+     * Add coins that were read from the backing view ahead of use, e.g. by
+     * GetCoins() on other threads. Outpoints that are already cached, and
+     * spent coins, are skipped. The coins are moved from.
+     */
+    void Warm(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins);
+
     //! Calculate the size of the cache (in number of transaction outputs)
     unsigned int GetCacheSize() const;
 
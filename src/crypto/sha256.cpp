@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <string.h>
 #include <atomic>
+#include <vector>
 
 #if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #if defined(USE_ASM)
@@ -22,11 +23,13 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 namespace sha256d64_sse41
 {
 void Transform_4way(unsigned char* out, const unsigned char* in);
+void Transform_4way_multi(uint32_t* const* s, const unsigned char* const* chunk);
 }
 
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
+void Transform_8way_multi(uint32_t* const* s, const unsigned char* const* chunk);
 }
 
 namespace sha256d64_shani
@@ -416,6 +419,8 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+/** Process one 64-byte chunk for each of several independent states (one per lane). */
+typedef void (*TransformMultiType)(uint32_t* const*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -461,6 +466,8 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformMultiType TransformMulti_4way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -544,6 +551,25 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test the multi-buffer transforms, if available. Lane i continues from the
+    // state after i blocks with block i, giving the state after i + 1 blocks.
+    const std::pair<TransformMultiType, size_t> multi[] = {{TransformMulti_4way, 4}, {TransformMulti_8way, 8}};
+    for (const auto& transform : multi) {
+        if (!transform.first) continue;
+        uint32_t states[8][8];
+        uint32_t* s[8];
+        const unsigned char* chunks[8];
+        for (size_t i = 0; i < transform.second; ++i) {
+            std::copy(result[i], result[i] + 8, states[i]);
+            s[i] = states[i];
+            chunks[i] = data + 1 + 64 * i;
+        }
+        transform.first(s, chunks);
+        for (size_t i = 0; i < transform.second; ++i) {
+            if (!std::equal(states[i], states[i] + 8, result[i + 1])) return false;
+        }
+    }
+
     return true;
 }
 
@@ -622,6 +648,7 @@ std::string SHA256AutoDetect()
 #endif
 #if defined(ENABLE_SSE41) && !defined(BUILD_SYSCOIN_INTERNAL)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformMulti_4way = sha256d64_sse41::Transform_4way_multi;
         ret += ",sse41(4way)";
 #endif
     }
@@ -629,6 +656,7 @@ std::string SHA256AutoDetect()
 #if defined(ENABLE_AVX2) && !defined(BUILD_SYSCOIN_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256d64_avx2::Transform_8way_multi;
         ret += ",avx2(8way)";
     }
 #endif
@@ -728,3 +756,107 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+namespace {
+
+/** Number of blocks of a message of len bytes, including the padding. */
+size_t PaddedBlocks(size_t len)
+{
+    return len / 64 + (len % 64 < 56 ? 1 : 2);
+}
+
+/** SHA-256 of count messages, run ways lanes at a time. A lane that finishes its
+ *  message picks up the next one, so messages of different lengths keep the
+ *  lanes busy until the last few. */
+void SHA256Multi(unsigned char* out, const unsigned char* const* in, const size_t* len, size_t count, TransformMultiType transform, size_t ways)
+{
+    // The last one or two blocks of every message, including the padding
+    std::vector<unsigned char> tails(count * 128);
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char* tail = tails.data() + 128 * i;
+        const size_t rem = len[i] % 64;
+        if (rem) memcpy(tail, in[i] + len[i] - rem, rem);
+        tail[rem] = 0x80;
+        WriteBE64(tail + 64 * (PaddedBlocks(len[i]) - len[i] / 64) - 8, (uint64_t)len[i] << 3);
+    }
+
+    struct Lane {
+        size_t msg;
+        size_t block;
+        uint32_t s[8];
+    };
+    Lane lanes[8];
+    bool busy[8];
+    size_t next = 0;
+    auto Start = [&](Lane& lane) {
+        if (next == count) return false;
+        lane.msg = next++;
+        lane.block = 0;
+        sha256::Initialize(lane.s);
+        return true;
+    };
+    auto Chunk = [&](const Lane& lane) {
+        const size_t full = len[lane.msg] / 64;
+        if (lane.block < full) return in[lane.msg] + 64 * lane.block;
+        return (const unsigned char*)tails.data() + 128 * lane.msg + 64 * (lane.block - full);
+    };
+    for (size_t j = 0; j < ways; ++j) busy[j] = Start(lanes[j]);
+
+    uint32_t idle_state[8] = {0};
+    static const unsigned char idle_chunk[64] = {0};
+    uint32_t* states[8];
+    const unsigned char* chunks[8];
+    while (true) {
+        size_t active = 0;
+        for (size_t j = 0; j < ways; ++j) {
+            if (busy[j]) {
+                states[j] = lanes[j].s;
+                chunks[j] = Chunk(lanes[j]);
+                ++active;
+            } else {
+                states[j] = idle_state;
+                chunks[j] = idle_chunk;
+            }
+        }
+        if (active == 0) break;
+        if (active == 1) {
+            // Not worth a multi-buffer pass for a single lane
+            for (size_t j = 0; j < ways; ++j) {
+                if (busy[j]) Transform(lanes[j].s, chunks[j], 1);
+            }
+        } else {
+            transform(states, chunks);
+        }
+        for (size_t j = 0; j < ways; ++j) {
+            if (!busy[j] || ++lanes[j].block < PaddedBlocks(len[lanes[j].msg])) continue;
+            for (int k = 0; k < 8; ++k) WriteBE32(out + 32 * lanes[j].msg + 4 * k, lanes[j].s[k]);
+            busy[j] = Start(lanes[j]);
+        }
+    }
+}
+
+} // namespace
+
+void SHA256DMulti(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count)
+{
+    TransformMultiType transform = TransformMulti_8way;
+    size_t ways = 8;
+    if (!transform) {
+        transform = TransformMulti_4way;
+        ways = 4;
+    }
+    if (!transform || count < 2) {
+        for (size_t i = 0; i < count; ++i) {
+            unsigned char first[CSHA256::OUTPUT_SIZE];
+            CSHA256().Write(inputs[i], lengths[i]).Finalize(first);
+            CSHA256().Write(first, sizeof(first)).Finalize(output + 32 * i);
+        }
+        return;
+    }
+    std::vector<unsigned char> first(count * 32);
+    SHA256Multi(first.data(), inputs, lengths, count, transform, ways);
+    std::vector<const unsigned char*> first_inputs(count);
+    const std::vector<size_t> first_lengths(count, 32);
+    for (size_t i = 0; i < count; ++i) first_inputs[i] = first.data() + 32 * i;
+    SHA256Multi(output, first_inputs.data(), first_lengths.data(), count, transform, ways);
+}
@@ -38,4 +38,12 @@ std::string SHA256AutoDetect();
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the double-SHA256's of several messages of any length together,
+ *  using the multi-buffer (SSE4.1 4-way, AVX2 8-way) transforms when available.
+ *  output:  pointer to a count*32 byte output buffer
+ *  inputs:  pointers to the count messages
+ *  lengths: the length of each message in bytes
+ */
+void SHA256DMulti(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count);
+
 #endif // SYSCOIN_CRYPTO_SHA256_H
@@ -13,6 +13,7 @@
 #include <memory>
 #include <vector>
 
+#include <boost/thread/shared_mutex.hpp>
 
 /** namespace CuckooCache provides high performance cache primitives
  *
@@ -23,6 +24,9 @@
  * 2) cache is a cache which is performant in memory usage and lookup speed. It
  * is lockfree for erase operations. Elements are lazily erased on the next
  * insert.
+ *
+ * 3) sharded_cache splits a cache into independently locked shards so that it
+ * can be shared between threads without any external locking.
  */
 namespace CuckooCache
 {
@@ -476,6 +480,83 @@ public:
         return false;
     }
 };
+
+/** sharded_cache spreads its elements over a power of two number of caches,
+ * each guarded by its own lock, and picks the shard from the low bits of the
+ * first hash (cache locations use the high bits, so the two stay
+ * independent).
+ *
+ * Lookups take their shard's lock shared and inserts take it exclusively, so
+ * unlike cache, sharded_cache needs no external locking. Threads working on
+ * different shards never wait on each other, and since every shard keeps its
+ * own epochs, the scan that ages an epoch only holds up one shard.
+ *
+ * @tparam Element, Hash see cache
+ * @tparam Shards the number of shards, a power of two
+ */
+template <typename Element, typename Hash, uint32_t Shards = 16>
+class sharded_cache
+{
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+private:
+    struct shard {
+        cache<Element, Hash> set;
+        mutable boost::shared_mutex mtx;
+    };
+    std::array<shard, Shards> shards;
+
+    /** hash_function is used to pick the shard, see cache::hash_function */
+    const Hash hash_function;
+
+    inline uint32_t shard_index(const Element& e) const
+    {
+        return hash_function.template operator()<0>(e) & (Shards - 1);
+    }
+
+public:
+    /** As with cache, setup or setup_bytes must be called before use */
+    sharded_cache() : shards(), hash_function()
+    {
+    }
+
+    /** setup splits new_size elements evenly across the shards.
+     *
+     * setup should only be called once, before the cache is shared.
+     *
+     * @param new_size the desired number of elements to store
+     * @returns the maximum number of elements storable
+     */
+    uint32_t setup(uint32_t new_size)
+    {
+        uint32_t total = 0;
+        for (shard& s : shards)
+            total += s.set.setup(new_size / Shards);
+        return total;
+    }
+
+    /** setup_bytes is a convenience function, see cache::setup_bytes */
+    uint32_t setup_bytes(size_t bytes)
+    {
+        return setup(bytes/sizeof(Element));
+    }
+
+    /** insert e into its shard, see cache::insert */
+    inline void insert(Element e)
+    {
+        shard& s = shards[shard_index(e)];
+        boost::unique_lock<boost::shared_mutex> lock(s.mtx);
+        s.set.insert(std::move(e));
+    }
+
+    /** check whether e is in its shard, see cache::contains */
+    inline bool contains(const Element& e, const bool erase) const
+    {
+        const shard& s = shards[shard_index(e)];
+        boost::shared_lock<boost::shared_mutex> lock(s.mtx);
+        return s.set.contains(e, erase);
+    }
+};
 } // namespace CuckooCache
 
 #endif // SYSCOIN_CUCKOOCACHE_H
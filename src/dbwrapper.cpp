@@ -97,13 +97,118 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static const DBProfile DB_PROFILES[] = {
+    // The settings all databases used to share
+    {"default", false, 4 * 1024, 10, 50, 25, 2 * 1024 * 1024},
+    // Hot records that are looked up and rewritten all the time: more of the
+    // budget for cached blocks and a stronger filter against misses
+    {"lookup", false, 4 * 1024, 14, 70, 15, 2 * 1024 * 1024},
+    // Written once and read rarely: compress, favour the write buffers and
+    // keep compactions infrequent
+    {"archive", true, 16 * 1024, 10, 25, 35, 8 * 1024 * 1024},
+    // Mostly read by iterating: large compressed blocks, no filter
+    {"scan", true, 64 * 1024, 0, 50, 25, 8 * 1024 * 1024},
+};
+
+//! Databases -dbprofile can be given for, by the name of their directory
+static const char* const DB_NAMES[] = {
+    "chainstate", "index", "txindex", "assets", "assetallocations", "assetallocationtransactions",
+    "assetallocationmempoolbalances", "ethereumtxroots",
+};
+
+const char* GetDefaultDBProfile(const std::string& db_name)
+{
+    if (db_name == "assets" || db_name == "assetallocations")
+        return "lookup";
+    if (db_name == "ethereumtxroots" || db_name == "assetallocationtransactions" || db_name == "txindex")
+        return "archive";
+    return "default";
+}
+
+const DBProfile* FindDBProfile(const std::string& profile_name)
+{
+    for (const DBProfile& profile : DB_PROFILES) {
+        if (profile_name == profile.name)
+            return &profile;
+    }
+    return nullptr;
+}
+
+std::string ListDBProfiles()
+{
+    std::string ret;
+    for (const DBProfile& profile : DB_PROFILES) {
+        if (!ret.empty())
+            ret += ", ";
+        ret += profile.name;
+    }
+    return ret;
+}
+
+std::string ListDBNames()
+{
+    std::string ret;
+    for (const char* db_name : DB_NAMES) {
+        if (!ret.empty())
+            ret += ", ";
+        ret += db_name;
+    }
+    return ret;
+}
+
+/** Split a -dbprofile=<database>:<profile> argument. */
+static bool ParseDBProfileArg(const std::string& arg, std::string& db_name, std::string& profile_name)
+{
+    const size_t pos = arg.find(':');
+    if (pos == std::string::npos || pos == 0 || pos + 1 == arg.size())
+        return false;
+    db_name = arg.substr(0, pos);
+    profile_name = arg.substr(pos + 1);
+    return true;
+}
+
+bool CheckDBProfileArgs(std::string& error)
+{
+    for (const std::string& arg : gArgs.GetArgs("-dbprofile")) {
+        std::string db_name, profile_name;
+        if (!ParseDBProfileArg(arg, db_name, profile_name)) {
+            error = strprintf("Invalid -dbprofile '%s', expected <database>:<profile>", arg);
+            return false;
+        }
+        if (std::find(std::begin(DB_NAMES), std::end(DB_NAMES), db_name) == std::end(DB_NAMES)) {
+            error = strprintf("Unknown database '%s' in -dbprofile (available: %s)", db_name, ListDBNames());
+            return false;
+        }
+        if (FindDBProfile(profile_name) == nullptr) {
+            error = strprintf("Unknown database profile '%s' (available: %s)", profile_name, ListDBProfiles());
+            return false;
+        }
+    }
+    return true;
+}
+
+const DBProfile& GetDBProfile(const std::string& db_name)
+{
+    std::string profile_name = GetDefaultDBProfile(db_name);
+    // The last matching argument wins
+    for (const std::string& arg : gArgs.GetArgs("-dbprofile")) {
+        std::string arg_db_name, arg_profile_name;
+        if (ParseDBProfileArg(arg, arg_db_name, arg_profile_name) && arg_db_name == db_name && FindDBProfile(arg_profile_name) != nullptr)
+            profile_name = arg_profile_name;
+    }
+    return *FindDBProfile(profile_name);
+}
+
+static leveldb::Options GetOptions(size_t nCacheSize, const DBProfile& profile)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.compression = leveldb::kNoCompression;
+    options.block_cache = leveldb::NewLRUCache(nCacheSize / 100 * profile.block_cache_percent);
+    options.write_buffer_size = nCacheSize / 100 * profile.write_buffer_percent; // up to two write buffers may be held in memory simultaneously
+    options.block_size = profile.block_size;
+    options.max_file_size = profile.max_file_size;
+    if (profile.bloom_bits > 0)
+        options.filter_policy = leveldb::NewBloomFilterPolicy(profile.bloom_bits);
+    options.compression = profile.compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
     options.info_log = new CSyscoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -114,7 +219,7 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const DBProfile* profile)
     : m_name(fs::basename(path))
 {
     penv = nullptr;
@@ -122,7 +227,10 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    if (profile == nullptr)
+        profile = &GetDBProfile(m_name);
+    LogPrint(BCLog::LEVELDB, "Using LevelDB profile %s for %s\n", profile->name, m_name);
+    options = GetOptions(nCacheSize, *profile);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -233,6 +341,130 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
+std::unique_ptr<CDBSnapshot> CDBWrapper::GetSnapshot(const uint256& hashBlock) const
+{
+    return MakeUnique<CDBSnapshot>(*this, hashBlock);
+}
+
+CDBSnapshot::CDBSnapshot(const CDBWrapper& parentIn, const uint256& hashBlockIn) :
+    parent(parentIn), psnapshot(parentIn.pdb->GetSnapshot()), readoptions(parentIn.readoptions), iteroptions(parentIn.iteroptions), hashBlock(hashBlockIn)
+{
+    readoptions.snapshot = psnapshot;
+    iteroptions.snapshot = psnapshot;
+}
+
+CDBSnapshot::~CDBSnapshot()
+{
+    parent.pdb->ReleaseSnapshot(psnapshot);
+}
+
+namespace {
+
+/** Walks a database iterator and the records laid over it in one key order, the overlay winning on equal keys. */
+class CDBOverlayIterator : public leveldb::Iterator
+{
+private:
+    std::unique_ptr<leveldb::Iterator> pbase;
+    const CDBSnapshot::Overlay& overlay;
+    CDBSnapshot::Overlay::const_iterator itOverlay;
+    bool fOverlayCurrent;
+
+    //! Position on the first record at or after the two cursors that is not erased
+    void Settle()
+    {
+        while (true) {
+            if (itOverlay != overlay.end() && pbase->Valid()) {
+                const int nCmp = pbase->key().compare(leveldb::Slice(itOverlay->first));
+                if (nCmp == 0) {
+                    // The overlay replaces the database record
+                    pbase->Next();
+                    continue;
+                }
+                if (nCmp < 0) {
+                    fOverlayCurrent = false;
+                    return;
+                }
+            }
+            if (itOverlay == overlay.end()) {
+                fOverlayCurrent = false;
+                return;
+            }
+            if (itOverlay->second.empty()) {
+                ++itOverlay;
+                continue;
+            }
+            fOverlayCurrent = true;
+            return;
+        }
+    }
+
+public:
+    CDBOverlayIterator(leveldb::Iterator* pbaseIn, const CDBSnapshot::Overlay& overlayIn) :
+        pbase(pbaseIn), overlay(overlayIn), itOverlay(overlayIn.end()), fOverlayCurrent(false) {}
+
+    bool Valid() const override { return fOverlayCurrent || pbase->Valid(); }
+
+    void SeekToFirst() override
+    {
+        pbase->SeekToFirst();
+        itOverlay = overlay.begin();
+        Settle();
+    }
+
+    void Seek(const leveldb::Slice& target) override
+    {
+        pbase->Seek(target);
+        itOverlay = overlay.lower_bound(target.ToString());
+        Settle();
+    }
+
+    void Next() override
+    {
+        if (fOverlayCurrent)
+            ++itOverlay;
+        else
+            pbase->Next();
+        Settle();
+    }
+
+    // CDBIterator only walks forward
+    void SeekToLast() override { assert(false); }
+    void Prev() override { assert(false); }
+
+    leveldb::Slice key() const override
+    {
+        return fOverlayCurrent ? leveldb::Slice(itOverlay->first) : pbase->key();
+    }
+
+    leveldb::Slice value() const override
+    {
+        return fOverlayCurrent ? leveldb::Slice((const char*)itOverlay->second.data(), itOverlay->second.size()) : pbase->value();
+    }
+
+    leveldb::Status status() const override { return pbase->status(); }
+};
+
+} // namespace
+
+void CDBSnapshot::SetOverlay(Overlay&& overlayIn)
+{
+    overlay = std::move(overlayIn);
+    for (auto& item : overlay) {
+        if (item.second.empty())
+            continue;
+        CDataStream ssValue(item.second, SER_DISK, CLIENT_VERSION);
+        ssValue.Xor(parent.obfuscate_key);
+        item.second.assign(ssValue.begin(), ssValue.end());
+    }
+}
+
+CDBIterator* CDBSnapshot::NewIterator() const
+{
+    if (overlay.empty())
+        return new CDBIterator(parent, parent.pdb->NewIterator(iteroptions));
+    return new CDBIterator(parent, new CDBOverlayIterator(parent.pdb->NewIterator(iteroptions), overlay));
+}
+
 CDBIterator::~CDBIterator() { delete piter; }
 bool CDBIterator::Valid() const { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
@@ -9,6 +9,7 @@
 #include <fs.h>
 #include <serialize.h>
 #include <streams.h>
+#include <uint256.h>
 #include <util.h>
 #include <utilstrencodings.h>
 #include <version.h>
@@ -16,9 +17,49 @@
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
+/**
+ * LevelDB settings for one kind of workload. Every database gets a profile by
+ * its name (see GetDBProfile()), which -dbprofile=<database>:<profile> can
+ * override.
+ */
+struct DBProfile
+{
+    const char* name;
+    //! Compress tables with snappy; has no effect unless LevelDB was built with snappy
+    bool compression;
+    //! Uncompressed size of a table block; larger blocks compress better but cost more per point read
+    size_t block_size;
+    //! Bloom filter bits per key, 0 for no filter
+    int bloom_bits;
+    //! Shares of the cache budget for the block cache and for each of the two write buffers
+    int block_cache_percent;
+    int write_buffer_percent;
+    //! Size of a table file before a new one is started; larger files mean fewer, bigger compactions
+    size_t max_file_size;
+};
+
+/** Name of the profile used for a database unless -dbprofile overrides it. */
+const char* GetDefaultDBProfile(const std::string& db_name);
+/** Look up a profile by name. Returns nullptr if there is none. */
+const DBProfile* FindDBProfile(const std::string& profile_name);
+/** The profile a database is opened with. */
+const DBProfile& GetDBProfile(const std::string& db_name);
+/** Comma-separated names of all profiles. */
+std::string ListDBProfiles();
+/** Comma-separated names of the databases a profile can be chosen for. */
+std::string ListDBNames();
+/** Check the -dbprofile arguments. */
+bool CheckDBProfileArgs(std::string& error);
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -173,9 +214,12 @@ public:
 
 };
 
+class CDBSnapshot;
+
 class CDBWrapper
 {
     friend const std::vector<unsigned char>& dbwrapper_private::GetObfuscateKey(const CDBWrapper &w);
+    friend class CDBSnapshot;
 private:
     //! custom environment this database is using (may be nullptr in case of default environment)
     leveldb::Env* penv;
@@ -212,23 +256,8 @@ private:
 
     std::vector<unsigned char> CreateObfuscateKey() const;
 
-public:
-    /**
-     * @param[in] path        Location in the filesystem where leveldb data will be stored.
-     * @param[in] nCacheSize  Configures various leveldb cache settings.
-     * @param[in] fMemory     If true, use leveldb's memory environment.
-     * @param[in] fWipe       If true, remove all existing data.
-     * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
-     *                        with a zero'd byte array.
-     */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
-    ~CDBWrapper();
-
-    CDBWrapper(const CDBWrapper&) = delete;
-    CDBWrapper& operator=(const CDBWrapper&) = delete;
-
     template <typename K, typename V>
-    bool Read(const K& key, V& value) const
+    bool Read(const leveldb::ReadOptions& options, const K& key, V& value) const
     {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
@@ -236,7 +265,7 @@ public:
         leveldb::Slice slKey(ssKey.data(), ssKey.size());
 
         std::string strValue;
-        leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        leveldb::Status status = pdb->Get(options, slKey, &strValue);
         if (!status.ok()) {
             if (status.IsNotFound())
                 return false;
@@ -253,16 +282,8 @@ public:
         return true;
     }
 
-    template <typename K, typename V>
-    bool Write(const K& key, const V& value, bool fSync = false)
-    {
-        CDBBatch batch(*this);
-        batch.Write(key, value);
-        return WriteBatch(batch, fSync);
-    }
-
     template <typename K>
-    bool Exists(const K& key) const
+    bool Exists(const leveldb::ReadOptions& options, const K& key) const
     {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
@@ -270,7 +291,7 @@ public:
         leveldb::Slice slKey(ssKey.data(), ssKey.size());
 
         std::string strValue;
-        leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        leveldb::Status status = pdb->Get(options, slKey, &strValue);
         if (!status.ok()) {
             if (status.IsNotFound())
                 return false;
@@ -280,6 +301,86 @@ public:
         return true;
     }
 
+public:
+    /**
+     * @param[in] path        Location in the filesystem where leveldb data will be stored.
+     * @param[in] nCacheSize  Configures various leveldb cache settings.
+     * @param[in] fMemory     If true, use leveldb's memory environment.
+     * @param[in] fWipe       If true, remove all existing data.
+     * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
+     *                        with a zero'd byte array.
+     * @param[in] profile     LevelDB settings to use instead of the profile picked by GetDBProfile().
+     */
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const DBProfile* profile = nullptr);
+    ~CDBWrapper();
+
+    CDBWrapper(const CDBWrapper&) = delete;
+    CDBWrapper& operator=(const CDBWrapper&) = delete;
+
+    template <typename K, typename V>
+    bool Read(const K& key, V& value) const
+    {
+        return Read(readoptions, key, value);
+    }
+
+    /**
+     * Look up several keys at once. The keys are visited in database order
+     * through a single iterator, so neighbouring keys share the table block
+     * that the previous seek loaded instead of each doing a full Get().
+     * values[i] is only assigned when found[i] is set. Returns the number of
+     * keys found.
+     */
+    template <typename K, typename V>
+    size_t ReadMany(const std::vector<K>& keys, std::vector<V>& values, std::vector<bool>& found) const
+    {
+        std::vector<std::pair<std::string, size_t>> vKeys;
+        vKeys.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+            ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+            ssKey << keys[i];
+            vKeys.emplace_back(std::string(ssKey.begin(), ssKey.end()), i);
+        }
+        std::sort(vKeys.begin(), vKeys.end());
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+
+        size_t nFound = 0;
+        std::unique_ptr<leveldb::Iterator> it(pdb->NewIterator(readoptions));
+        for (const auto& key : vKeys) {
+            const leveldb::Slice slKey(key.first);
+            it->Seek(slKey);
+            if (!it->Valid() || it->key() != slKey)
+                continue;
+            try {
+                leveldb::Slice slValue = it->value();
+                CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
+                ssValue.Xor(obfuscate_key);
+                ssValue >> values[key.second];
+            } catch (const std::exception&) {
+                continue;
+            }
+            found[key.second] = true;
+            nFound++;
+        }
+        dbwrapper_private::HandleError(it->status());
+        return nFound;
+    }
+
+    template <typename K, typename V>
+    bool Write(const K& key, const V& value, bool fSync = false)
+    {
+        CDBBatch batch(*this);
+        batch.Write(key, value);
+        return WriteBatch(batch, fSync);
+    }
+
+    template <typename K>
+    bool Exists(const K& key) const
+    {
+        return Exists(readoptions, key);
+    }
+
     template <typename K>
     bool Erase(const K& key, bool fSync = false)
     {
@@ -310,6 +411,12 @@ public:
         return new CDBIterator(*this, pdb->NewIterator(iteroptions));
     }
 
+    /**
+     * Take a consistent read-only view of the database as it is now.
+     * @param[in] hashBlock  The chain tip the current contents belong to.
+     */
+    std::unique_ptr<CDBSnapshot> GetSnapshot(const uint256& hashBlock = uint256()) const;
+
     /**
      * Return true if the database managed by this class contains no entries.
      */
@@ -349,4 +456,84 @@ public:
 
 };
 
+/**
+ * Read-only view of a CDBWrapper as of the moment it was taken, backed by a
+ * LevelDB snapshot. Writes made afterwards are not visible through it, so a
+ * long scan sees a single state of the database without holding any lock
+ * while the database keeps being written to. The view must not outlive the
+ * database it was taken from.
+ *
+ * Changes that a cache in front of the database has not written yet can be
+ * laid over the view with SetOverlay(), so that it describes the cached state
+ * without flushing the cache first.
+ */
+class CDBSnapshot
+{
+public:
+    //! Serialized keys mapped to serialized records, an empty record meaning the key is erased
+    typedef std::map<std::string, std::vector<unsigned char>> Overlay;
+
+private:
+    const CDBWrapper &parent;
+    const leveldb::Snapshot* psnapshot;
+    leveldb::ReadOptions readoptions;
+    leveldb::ReadOptions iteroptions;
+    //! The chain tip the contents of the view belong to
+    const uint256 hashBlock;
+    //! Records that take precedence over the database, obfuscated like the database ones
+    Overlay overlay;
+
+    template <typename K>
+    Overlay::const_iterator FindOverlay(const K& key) const
+    {
+        if (overlay.empty())
+            return overlay.end();
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+        ssKey << key;
+        return overlay.find(std::string(ssKey.begin(), ssKey.end()));
+    }
+
+public:
+    CDBSnapshot(const CDBWrapper& parentIn, const uint256& hashBlockIn);
+    ~CDBSnapshot();
+
+    CDBSnapshot(const CDBSnapshot&) = delete;
+    CDBSnapshot& operator=(const CDBSnapshot&) = delete;
+
+    /** Make reads and iterators see the given records instead of the database ones. */
+    void SetOverlay(Overlay&& overlayIn);
+
+    template <typename K, typename V>
+    bool Read(const K& key, V& value) const
+    {
+        Overlay::const_iterator it = FindOverlay(key);
+        if (it == overlay.end())
+            return parent.Read(readoptions, key, value);
+        if (it->second.empty())
+            return false;
+        try {
+            CDataStream ssValue(it->second, SER_DISK, CLIENT_VERSION);
+            ssValue.Xor(parent.obfuscate_key);
+            ssValue >> value;
+        } catch (const std::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    template <typename K>
+    bool Exists(const K& key) const
+    {
+        Overlay::const_iterator it = FindOverlay(key);
+        if (it == overlay.end())
+            return parent.Exists(readoptions, key);
+        return !it->second.empty();
+    }
+
+    CDBIterator *NewIterator() const;
+
+    const uint256& GetBestBlock() const { return hashBlock; }
+};
+
 #endif // SYSCOIN_DBWRAPPER_H
@@ -0,0 +1,69 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <ethereum/RLPView.h>
+
+#include <limits>
+
+RLPView::RLPView(Span<const unsigned char> data) : RLPView()
+{
+    size_t nPayloadOffset, nPayloadSize;
+    if (!ParsePrefix(data, nPayloadOffset, nPayloadSize) || nPayloadOffset + nPayloadSize != (size_t)data.size())
+        return;
+    m_data = data;
+    m_nPayloadOffset = nPayloadOffset;
+    m_nPayloadSize = nPayloadSize;
+    m_fValid = true;
+}
+
+bool RLPView::ParsePrefix(Span<const unsigned char> data, size_t& nPayloadOffset, size_t& nPayloadSize)
+{
+    const size_t nSize = data.size();
+    if (nSize == 0)
+        return false;
+    const unsigned char nPrefix = data[0];
+    if (nPrefix < 0x80) {
+        nPayloadOffset = 0;
+        nPayloadSize = 1;
+        return true;
+    }
+    if (nPrefix <= 0xb7 || (nPrefix >= 0xc0 && nPrefix <= 0xf7)) {
+        // A single byte below 0x80 is encoded as itself
+        if (nPrefix == 0x81 && (nSize < 2 || data[1] < 0x80))
+            return false;
+        nPayloadOffset = 1;
+        nPayloadSize = nPrefix - (nPrefix < 0xc0 ? 0x80 : 0xc0);
+    } else {
+        const size_t nLengthSize = nPrefix - (nPrefix < 0xc0 ? 0xb7 : 0xf7);
+        if (nLengthSize > sizeof(size_t) || nSize <= nLengthSize || data[1] == 0)
+            return false;
+        nPayloadSize = 0;
+        for (size_t i = 1; i <= nLengthSize; i++)
+            nPayloadSize = (nPayloadSize << 8) | data[i];
+        // Payloads shorter than 56 bytes use the short form
+        if (nPayloadSize < 56 || nPayloadSize >= std::numeric_limits<size_t>::max() - 0x100)
+            return false;
+        nPayloadOffset = 1 + nLengthSize;
+    }
+    return nPayloadSize <= nSize - nPayloadOffset;
+}
+
+bool RLPView::GetItems(std::vector<RLPView>& vItems) const
+{
+    vItems.clear();
+    if (!IsList())
+        return false;
+    Span<const unsigned char> rest = Payload();
+    while (rest.size() > 0) {
+        RLPView item;
+        if (!ParsePrefix(rest, item.m_nPayloadOffset, item.m_nPayloadSize))
+            return false;
+        const size_t nItemSize = item.m_nPayloadOffset + item.m_nPayloadSize;
+        item.m_data = rest.first(nItemSize);
+        item.m_fValid = true;
+        vItems.push_back(item);
+        rest = rest.subspan(nItemSize);
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_ETHEREUM_RLPVIEW_H
+#define SYSCOIN_ETHEREUM_RLPVIEW_H
+
+#include <span.h>
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * Read-only view of one RLP encoded item, which neither copies nor throws.
+ *
+ * The view points into the bytes it was made from, so they must outlive it.
+ * A view is valid if the item prefix is well formed and canonical the way
+ * dev::RLP requires it, and the item covers the bytes exactly. Items nested
+ * in a list are checked only when the list is split with GetItems().
+ */
+class RLPView
+{
+    Span<const unsigned char> m_data;
+    size_t m_nPayloadOffset;
+    size_t m_nPayloadSize;
+    bool m_fValid;
+
+public:
+    /** An invalid view. */
+    RLPView() : m_nPayloadOffset(0), m_nPayloadSize(0), m_fValid(false) {}
+    /** View of the item encoded in data; invalid if data holds anything else. */
+    explicit RLPView(Span<const unsigned char> data);
+
+    bool IsValid() const { return m_fValid; }
+    bool IsList() const { return m_fValid && m_data[0] >= 0xc0; }
+    bool IsData() const { return m_fValid && m_data[0] < 0xc0; }
+    /** Whether this is a zero-length string or list. */
+    bool IsEmpty() const { return m_fValid && m_nPayloadSize == 0; }
+
+    /** The whole item, prefix included. */
+    Span<const unsigned char> Data() const { return m_data; }
+    /** The item without its prefix; for a single byte item, the byte itself. */
+    Span<const unsigned char> Payload() const { return m_data.subspan(m_nPayloadOffset, m_nPayloadSize); }
+
+    /** Split a list into its items. Returns false if this is not a list or one of its items is malformed. */
+    bool GetItems(std::vector<RLPView>& vItems) const;
+
+    /**
+     * Read the prefix of the item data starts with. Returns false if the prefix is
+     * malformed or not canonical, or if data is too short for the item.
+     */
+    static bool ParsePrefix(Span<const unsigned char> data, size_t& nPayloadOffset, size_t& nPayloadSize);
+};
+
+#endif // SYSCOIN_ETHEREUM_RLPVIEW_H
@@ -19,12 +19,22 @@
  * @date 2014
  */
 
+#if defined(HAVE_CONFIG_H)
+#include <config/syscoin-config.h>
+#endif
+
 #include "SHA3.h"
+#include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <crypto/common.h>
 #include "RLP.h"
+
+#if defined(USE_ASM) && defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
 using namespace std;
 using namespace dev;
 
@@ -62,16 +72,6 @@ decsha3(512)
 /******** The Keccak-f[1600] permutation ********/
 
 /*** Constants. ***/
-static const uint8_t rho[24] = \
-  { 1,  3,   6, 10, 15, 21,
-	28, 36, 45, 55,  2, 14,
-	27, 41, 56,  8, 25, 43,
-	62, 18, 39, 61, 20, 44};
-static const uint8_t pi[24] = \
-  {10,  7, 11, 17, 18, 3,
-	5, 16,  8, 21, 24, 4,
-   15, 23, 19, 13, 12, 2,
-   20, 14, 22,  9, 6,  1};
 static const uint64_t RC[24] = \
   {1ULL, 0x8082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
    0x808bULL, 0x80000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
@@ -80,84 +80,138 @@ static const uint64_t RC[24] = \
    0x8000000000008002ULL, 0x8000000000000080ULL, 0x800aULL, 0x800000008000000aULL,
    0x8000000080008081ULL, 0x8000000000008080ULL, 0x80000001ULL, 0x8000000080008008ULL};
 
-/*** Helper macros to unroll the permutation. ***/
-#define rol(x, s) (((x) << s) | ((x) >> (64 - s)))
-#define REPEAT6(e) e e e e e e
-#define REPEAT24(e) REPEAT6(e e e e)
-#define REPEAT5(e) e e e e e
-#define FOR5(v, s, e) \
-  v = 0;            \
-  REPEAT5(e; v += s;)
-
-/*** Keccak-f[1600] ***/
-static inline void keccakf(void* state) {
-  uint64_t* a = (uint64_t*)state;
-  uint64_t b[5] = {0};
-  uint64_t t = 0;
-  uint8_t x, y;
+static inline uint64_t rol(uint64_t x, int s) { return (x << s) | (x >> (64 - s)); }
+
+/*** Keccak-f[1600], with the 25 lanes kept in registers and the steps of a round unrolled. ***/
+static void keccakf(uint64_t* a) {
+  uint64_t Aba = a[0], Abe = a[1], Abi = a[2], Abo = a[3], Abu = a[4];
+  uint64_t Aga = a[5], Age = a[6], Agi = a[7], Ago = a[8], Agu = a[9];
+  uint64_t Aka = a[10], Ake = a[11], Aki = a[12], Ako = a[13], Aku = a[14];
+  uint64_t Ama = a[15], Ame = a[16], Ami = a[17], Amo = a[18], Amu = a[19];
+  uint64_t Asa = a[20], Ase = a[21], Asi = a[22], Aso = a[23], Asu = a[24];
+  uint64_t B0, B1, B2, B3, B4;
 
   for (int i = 0; i < 24; i++) {
 	// Theta
-	FOR5(x, 1,
-		 b[x] = 0;
-		 FOR5(y, 5,
-			  b[x] ^= a[x + y]; ))
-	FOR5(x, 1,
-		 FOR5(y, 5,
-			  a[y + x] ^= b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1); ))
-	// Rho and pi
-	t = a[1];
-	x = 0;
-	REPEAT24(b[0] = a[pi[x]];
-			 a[pi[x]] = rol(t, rho[x]);
-			 t = b[0];
-			 x++; )
-	// Chi
-	FOR5(y,
-	   5,
-	   FOR5(x, 1,
-			b[x] = a[y + x];)
-	   FOR5(x, 1,
-			a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]); ))
-	// Iota
-	a[0] ^= RC[i];
+	const uint64_t Ca = Aba ^ Aga ^ Aka ^ Ama ^ Asa;
+	const uint64_t Ce = Abe ^ Age ^ Ake ^ Ame ^ Ase;
+	const uint64_t Ci = Abi ^ Agi ^ Aki ^ Ami ^ Asi;
+	const uint64_t Co = Abo ^ Ago ^ Ako ^ Amo ^ Aso;
+	const uint64_t Cu = Abu ^ Agu ^ Aku ^ Amu ^ Asu;
+	const uint64_t Da = Cu ^ rol(Ce, 1);
+	const uint64_t De = Ca ^ rol(Ci, 1);
+	const uint64_t Di = Ce ^ rol(Co, 1);
+	const uint64_t Do = Ci ^ rol(Cu, 1);
+	const uint64_t Du = Co ^ rol(Ca, 1);
+
+	// Rho and pi, one output row at a time, followed by chi (and iota on the first lane)
+	B0 = Aba ^ Da;
+	B1 = rol(Age ^ De, 44);
+	B2 = rol(Aki ^ Di, 43);
+	B3 = rol(Amo ^ Do, 21);
+	B4 = rol(Asu ^ Du, 14);
+	const uint64_t Eba = B0 ^ (~B1 & B2) ^ RC[i];
+	const uint64_t Ebe = B1 ^ (~B2 & B3);
+	const uint64_t Ebi = B2 ^ (~B3 & B4);
+	const uint64_t Ebo = B3 ^ (~B4 & B0);
+	const uint64_t Ebu = B4 ^ (~B0 & B1);
+
+	B0 = rol(Abo ^ Do, 28);
+	B1 = rol(Agu ^ Du, 20);
+	B2 = rol(Aka ^ Da, 3);
+	B3 = rol(Ame ^ De, 45);
+	B4 = rol(Asi ^ Di, 61);
+	const uint64_t Ega = B0 ^ (~B1 & B2);
+	const uint64_t Ege = B1 ^ (~B2 & B3);
+	const uint64_t Egi = B2 ^ (~B3 & B4);
+	const uint64_t Ego = B3 ^ (~B4 & B0);
+	const uint64_t Egu = B4 ^ (~B0 & B1);
+
+	B0 = rol(Abe ^ De, 1);
+	B1 = rol(Agi ^ Di, 6);
+	B2 = rol(Ako ^ Do, 25);
+	B3 = rol(Amu ^ Du, 8);
+	B4 = rol(Asa ^ Da, 18);
+	const uint64_t Eka = B0 ^ (~B1 & B2);
+	const uint64_t Eke = B1 ^ (~B2 & B3);
+	const uint64_t Eki = B2 ^ (~B3 & B4);
+	const uint64_t Eko = B3 ^ (~B4 & B0);
+	const uint64_t Eku = B4 ^ (~B0 & B1);
+
+	B0 = rol(Abu ^ Du, 27);
+	B1 = rol(Aga ^ Da, 36);
+	B2 = rol(Ake ^ De, 10);
+	B3 = rol(Ami ^ Di, 15);
+	B4 = rol(Aso ^ Do, 56);
+	const uint64_t Ema = B0 ^ (~B1 & B2);
+	const uint64_t Eme = B1 ^ (~B2 & B3);
+	const uint64_t Emi = B2 ^ (~B3 & B4);
+	const uint64_t Emo = B3 ^ (~B4 & B0);
+	const uint64_t Emu = B4 ^ (~B0 & B1);
+
+	B0 = rol(Abi ^ Di, 62);
+	B1 = rol(Ago ^ Do, 55);
+	B2 = rol(Aku ^ Du, 39);
+	B3 = rol(Ama ^ Da, 41);
+	B4 = rol(Ase ^ De, 2);
+	const uint64_t Esa = B0 ^ (~B1 & B2);
+	const uint64_t Ese = B1 ^ (~B2 & B3);
+	const uint64_t Esi = B2 ^ (~B3 & B4);
+	const uint64_t Eso = B3 ^ (~B4 & B0);
+	const uint64_t Esu = B4 ^ (~B0 & B1);
+
+	Aba = Eba; Abe = Ebe; Abi = Ebi; Abo = Ebo; Abu = Ebu;
+	Aga = Ega; Age = Ege; Agi = Egi; Ago = Ego; Agu = Egu;
+	Aka = Eka; Ake = Eke; Aki = Eki; Ako = Eko; Aku = Eku;
+	Ama = Ema; Ame = Eme; Ami = Emi; Amo = Emo; Amu = Emu;
+	Asa = Esa; Ase = Ese; Asi = Esi; Aso = Eso; Asu = Esu;
   }
+
+  a[0] = Aba; a[1] = Abe; a[2] = Abi; a[3] = Abo; a[4] = Abu;
+  a[5] = Aga; a[6] = Age; a[7] = Agi; a[8] = Ago; a[9] = Agu;
+  a[10] = Aka; a[11] = Ake; a[12] = Aki; a[13] = Ako; a[14] = Aku;
+  a[15] = Ama; a[16] = Ame; a[17] = Ami; a[18] = Amo; a[19] = Amu;
+  a[20] = Asa; a[21] = Ase; a[22] = Asi; a[23] = Aso; a[24] = Asu;
 }
 
 /******** The FIPS202-defined functions. ********/
 
-/*** Some helper macros. ***/
+#define Plen 200
 
-#define _(S) do { S } while (0)
-#define FOR(i, ST, L, S) \
-  _(for (size_t i = 0; i < L; i += ST) { S; })
-#define mkapply_ds(NAME, S)                                          \
-  static inline void NAME(uint8_t* dst,                              \
-						  const uint8_t* src,                        \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
-  }
-#define mkapply_sd(NAME, S)                                          \
-  static inline void NAME(const uint8_t* src,                        \
-						  uint8_t* dst,                              \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
+/** Xor a block of rate bytes into the state, a lane at a time. */
+static inline void xorin(uint64_t* a, const uint8_t* src, size_t rate) {
+  for (size_t i = 0; i < rate / 8; i++) {
+	a[i] ^= ReadLE64(src + 8 * i);
   }
+}
 
-mkapply_ds(xorin, dst[i] ^= src[i])  // xorin
-mkapply_sd(setout, dst[i] = src[i])  // setout
-
-#define P keccakf
-#define Plen 200
+/** Absorb an input into the state and apply the final, padded block. */
+static inline void absorb(uint64_t* a, const uint8_t* in, size_t inlen,
+						  size_t rate, uint8_t delim) {
+  while (inlen >= rate) {
+	xorin(a, in, rate);
+	keccakf(a);
+	in += rate;
+	inlen -= rate;
+  }
+  uint8_t last[Plen] = {0};
+  if (inlen) {
+	memcpy(last, in, inlen);
+  }
+  last[inlen] ^= delim;
+  last[rate - 1] ^= 0x80;
+  xorin(a, last, rate);
+  keccakf(a);
+}
 
-// Fold P*F over the full blocks of an input.
-#define foldP(I, L, F) \
-  while (L >= rate) {  \
-	F(a, I, rate);     \
-	P(a);              \
-	I += rate;         \
-	L -= rate;         \
+/** Write the first len bytes of the state. */
+static inline void setout(const uint64_t* a, uint8_t* dst, size_t len) {
+  uint8_t block[Plen];
+  for (size_t i = 0; i < (len + 7) / 8; i++) {
+	WriteLE64(block + 8 * i, a[i]);
   }
+  memcpy(dst, block, len);
+}
 
 /** The sponge-based hash construction. **/
 static inline int hash(uint8_t* out, size_t outlen,
@@ -166,20 +220,17 @@ static inline int hash(uint8_t* out, size_t outlen,
   if ((out == NULL) || ((in == NULL) && inlen != 0) || (rate >= Plen)) {
 	return -1;
   }
-  uint8_t a[Plen] = {0};
-  // Absorb input.
-  foldP(in, inlen, xorin);
-  // Xor in the DS and pad frame.
-  a[inlen] ^= delim;
-  a[rate - 1] ^= 0x80;
-  // Xor in the last block.
-  xorin(a, in, inlen);
-  // Apply P
-  P(a);
+  uint64_t a[25] = {0};
+  absorb(a, in, inlen, rate, delim);
   // Squeeze output.
-  foldP(out, outlen, setout);
+  while (outlen >= rate) {
+	setout(a, out, rate);
+	keccakf(a);
+	out += rate;
+	outlen -= rate;
+  }
   setout(a, out, outlen);
-  memset(a, 0, 200);
+  memset(a, 0, sizeof(a));
   return 0;
 }
 
@@ -220,4 +271,164 @@ bool sha3(bytesConstRef _input, bytesRef o_output)
 	return true;
 }
 
+#if defined(ENABLE_AVX2)
+namespace keccak_avx2
+{
+void KeccakF_4way(uint64_t* s);
+}
+#endif
+
+namespace
+{
+
+/// Rate of Keccak-256 in bytes.
+const size_t c_sha3Rate = 136;
+
+/// Keccak-f[1600] over four interleaved states, if this CPU has one; set by SHA3AutoDetect().
+typedef void (*KeccakF4wayType)(uint64_t*);
+KeccakF4wayType KeccakF_4way = nullptr;
+
+/// Hash the inputs through KeccakF_4way. Each of the four lanes absorbs one block of its
+/// input per permutation and takes the next input once done; the last input left is
+/// finished with the scalar permutation.
+void sha3Multi4way(bytesConstRef const* _inputs, h256* o_outputs, size_t _count)
+{
+	// Lanes without an input are permuted along; keep their state defined
+	uint64_t s[100] = {0};
+	bytesConstRef rest[4];
+	size_t job[4];
+	bool active[4] = {false, false, false, false};
+	size_t next = 0;
+	auto start = [&](int _lane) {
+		active[_lane] = next < _count;
+		if (!active[_lane])
+			return;
+		job[_lane] = next;
+		rest[_lane] = _inputs[next++];
+		for (int i = 0; i < 25; i++)
+			s[4 * i + _lane] = 0;
+	};
+	for (int j = 0; j < 4; j++)
+		start(j);
+
+	while (active[0] + active[1] + active[2] + active[3] > 1)
+	{
+		bool done[4] = {false, false, false, false};
+		for (int j = 0; j < 4; j++)
+		{
+			if (!active[j])
+				continue;
+			uint8_t last[c_sha3Rate];
+			const uint8_t* block = rest[j].data();
+			if (rest[j].size() >= c_sha3Rate)
+				rest[j] = rest[j].cropped(c_sha3Rate);
+			else
+			{
+				memset(last, 0, sizeof(last));
+				if (!rest[j].empty())
+					memcpy(last, rest[j].data(), rest[j].size());
+				last[rest[j].size()] ^= 0x01;
+				last[c_sha3Rate - 1] ^= 0x80;
+				block = last;
+				done[j] = true;
+			}
+			for (size_t i = 0; i < c_sha3Rate / 8; i++)
+				s[4 * i + j] ^= ReadLE64(block + 8 * i);
+		}
+		KeccakF_4way(s);
+		for (int j = 0; j < 4; j++)
+		{
+			if (!done[j])
+				continue;
+			for (int i = 0; i < 4; i++)
+				WriteLE64(o_outputs[job[j]].data() + 8 * i, s[4 * i + j]);
+			start(j);
+		}
+	}
+
+	for (int j = 0; j < 4; j++)
+	{
+		if (!active[j])
+			continue;
+		uint64_t a[25];
+		for (int i = 0; i < 25; i++)
+			a[i] = s[4 * i + j];
+		keccak::absorb(a, rest[j].data(), rest[j].size(), c_sha3Rate, 0x01);
+		keccak::setout(a, o_outputs[job[j]].data(), 32);
+	}
+}
+
+/// Check the multi-message path against the single-message one and a known hash.
+bool SelfTest()
+{
+	if (sha3(bytesConstRef()) != h256("c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"))
+		return false;
+	static const size_t lengths[] = {0, 1, 135, 136, 137, 271, 272, 300, 600};
+	bytes data(600);
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = (uint8_t)(i * 7 + 3);
+	std::vector<bytesConstRef> inputs;
+	for (size_t length : lengths)
+		inputs.push_back(bytesConstRef(data.data(), length));
+	const std::vector<h256> hashes = sha3Multi(inputs);
+	for (size_t i = 0; i < inputs.size(); i++)
+		if (hashes[i] != sha3(inputs[i]))
+			return false;
+	return true;
+}
+
+#if defined(USE_ASM) && defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+// We can't use cpuid.h's __get_cpuid as it does not support subleafs.
+void inline cpuid(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d)
+{
+#ifdef __GNUC__
+	__cpuid_count(leaf, subleaf, a, b, c, d);
+#else
+	__asm__ ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "0"(leaf), "2"(subleaf));
+#endif
+}
+
+/// Check whether the OS has enabled AVX registers.
+bool AVXEnabled()
+{
+	uint32_t a, d;
+	__asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+	return (a & 6) == 6;
+}
+#endif
+
+}
+
+void sha3Multi(bytesConstRef const* _inputs, h256* o_outputs, size_t _count)
+{
+	if (KeccakF_4way && _count > 1)
+	{
+		sha3Multi4way(_inputs, o_outputs, _count);
+		return;
+	}
+	for (size_t i = 0; i < _count; i++)
+		sha3(_inputs[i], o_outputs[i].ref());
+}
+
+std::string SHA3AutoDetect()
+{
+	std::string ret = "standard";
+#if defined(USE_ASM) && defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+	uint32_t eax, ebx, ecx, edx;
+	cpuid(1, 0, eax, ebx, ecx, edx);
+	const bool have_xsave = (ecx >> 27) & 1;
+	const bool have_avx = (ecx >> 28) & 1;
+	const bool enabled_avx = have_xsave && have_avx && AVXEnabled();
+	cpuid(7, 0, eax, ebx, ecx, edx);
+	const bool have_avx2 = (ebx >> 5) & 1;
+	if (have_avx2 && enabled_avx)
+	{
+		KeccakF_4way = keccak_avx2::KeccakF_4way;
+		ret = "avx2(4way)";
+	}
+#endif
+	assert(SelfTest());
+	return ret;
+}
+
 }
@@ -61,6 +61,16 @@ template<unsigned N> inline SecureFixedHash<32> sha3Secure(SecureFixedHash<N> co
 /// Calculate SHA3-256 hash of the given input, possibly interpreting it as nibbles, and return the hash as a string filled with binary data.
 inline std::string sha3(std::string const& _input, bool _isNibbles) { return asString((_isNibbles ? sha3(fromHex(_input)) : sha3(bytesConstRef(&_input))).asBytes()); }
 
+/// Calculate the SHA3-256 hashes of _count inputs at once, loading the hash of _inputs[i] into o_outputs[i].
+/// Hashes several inputs in parallel when SHA3AutoDetect() found a multi-buffer implementation.
+void sha3Multi(bytesConstRef const* _inputs, h256* o_outputs, size_t _count);
+
+/// Calculate the SHA3-256 hashes of the given inputs, returning them in the same order.
+inline std::vector<h256> sha3Multi(std::vector<bytesConstRef> const& _inputs) { std::vector<h256> ret(_inputs.size()); sha3Multi(_inputs.data(), ret.data(), _inputs.size()); return ret; }
+
+/// Select the fastest Keccak implementation this CPU supports, returning a description of it.
+std::string SHA3AutoDetect();
+
 /// Calculate SHA3-256 MAC
 inline void sha3mac(bytesConstRef _secret, bytesConstRef _plain, bytesRef _output) { sha3(_secret.toBytes() + _plain.toBytes()).ref().populate(_output); }
 
@@ -0,0 +1,128 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace dev {
+namespace keccak_avx2 {
+namespace {
+
+const uint64_t RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Xor(__m256i x, __m256i y, __m256i z, __m256i w, __m256i v) { return Xor(Xor(Xor(x, y), Xor(z, w)), v); }
+__m256i inline Rol(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+/** x ^ (~y & z), the chi step for one lane. */
+__m256i inline Chi(__m256i x, __m256i y, __m256i z) { return Xor(x, _mm256_andnot_si256(y, z)); }
+
+__m256i inline Load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+void inline Store(uint64_t* p, __m256i x) { _mm256_storeu_si256((__m256i*)p, x); }
+
+}
+
+/** Apply Keccak-f[1600] to four interleaved states; lane i of state j is s[4 * i + j]. */
+void KeccakF_4way(uint64_t* s)
+{
+    __m256i Aba = Load(s + 0), Abe = Load(s + 4), Abi = Load(s + 8), Abo = Load(s + 12), Abu = Load(s + 16);
+    __m256i Aga = Load(s + 20), Age = Load(s + 24), Agi = Load(s + 28), Ago = Load(s + 32), Agu = Load(s + 36);
+    __m256i Aka = Load(s + 40), Ake = Load(s + 44), Aki = Load(s + 48), Ako = Load(s + 52), Aku = Load(s + 56);
+    __m256i Ama = Load(s + 60), Ame = Load(s + 64), Ami = Load(s + 68), Amo = Load(s + 72), Amu = Load(s + 76);
+    __m256i Asa = Load(s + 80), Ase = Load(s + 84), Asi = Load(s + 88), Aso = Load(s + 92), Asu = Load(s + 96);
+
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        const __m256i Ca = Xor(Aba, Aga, Aka, Ama, Asa);
+        const __m256i Ce = Xor(Abe, Age, Ake, Ame, Ase);
+        const __m256i Ci = Xor(Abi, Agi, Aki, Ami, Asi);
+        const __m256i Co = Xor(Abo, Ago, Ako, Amo, Aso);
+        const __m256i Cu = Xor(Abu, Agu, Aku, Amu, Asu);
+        const __m256i Da = Xor(Cu, Rol(Ce, 1));
+        const __m256i De = Xor(Ca, Rol(Ci, 1));
+        const __m256i Di = Xor(Ce, Rol(Co, 1));
+        const __m256i Do = Xor(Ci, Rol(Cu, 1));
+        const __m256i Du = Xor(Co, Rol(Ca, 1));
+
+        // Rho and pi, row by row of the output, followed by chi and iota
+        __m256i B0 = Xor(Aba, Da);
+        __m256i B1 = Rol(Xor(Age, De), 44);
+        __m256i B2 = Rol(Xor(Aki, Di), 43);
+        __m256i B3 = Rol(Xor(Amo, Do), 21);
+        __m256i B4 = Rol(Xor(Asu, Du), 14);
+        const __m256i Eba = Xor(Chi(B0, B1, B2), _mm256_set1_epi64x(RC[round]));
+        const __m256i Ebe = Chi(B1, B2, B3);
+        const __m256i Ebi = Chi(B2, B3, B4);
+        const __m256i Ebo = Chi(B3, B4, B0);
+        const __m256i Ebu = Chi(B4, B0, B1);
+
+        B0 = Rol(Xor(Abo, Do), 28);
+        B1 = Rol(Xor(Agu, Du), 20);
+        B2 = Rol(Xor(Aka, Da), 3);
+        B3 = Rol(Xor(Ame, De), 45);
+        B4 = Rol(Xor(Asi, Di), 61);
+        const __m256i Ega = Chi(B0, B1, B2);
+        const __m256i Ege = Chi(B1, B2, B3);
+        const __m256i Egi = Chi(B2, B3, B4);
+        const __m256i Ego = Chi(B3, B4, B0);
+        const __m256i Egu = Chi(B4, B0, B1);
+
+        B0 = Rol(Xor(Abe, De), 1);
+        B1 = Rol(Xor(Agi, Di), 6);
+        B2 = Rol(Xor(Ako, Do), 25);
+        B3 = Rol(Xor(Amu, Du), 8);
+        B4 = Rol(Xor(Asa, Da), 18);
+        const __m256i Eka = Chi(B0, B1, B2);
+        const __m256i Eke = Chi(B1, B2, B3);
+        const __m256i Eki = Chi(B2, B3, B4);
+        const __m256i Eko = Chi(B3, B4, B0);
+        const __m256i Eku = Chi(B4, B0, B1);
+
+        B0 = Rol(Xor(Abu, Du), 27);
+        B1 = Rol(Xor(Aga, Da), 36);
+        B2 = Rol(Xor(Ake, De), 10);
+        B3 = Rol(Xor(Ami, Di), 15);
+        B4 = Rol(Xor(Aso, Do), 56);
+        const __m256i Ema = Chi(B0, B1, B2);
+        const __m256i Eme = Chi(B1, B2, B3);
+        const __m256i Emi = Chi(B2, B3, B4);
+        const __m256i Emo = Chi(B3, B4, B0);
+        const __m256i Emu = Chi(B4, B0, B1);
+
+        B0 = Rol(Xor(Abi, Di), 62);
+        B1 = Rol(Xor(Ago, Do), 55);
+        B2 = Rol(Xor(Aku, Du), 39);
+        B3 = Rol(Xor(Ama, Da), 41);
+        B4 = Rol(Xor(Ase, De), 2);
+        const __m256i Esa = Chi(B0, B1, B2);
+        const __m256i Ese = Chi(B1, B2, B3);
+        const __m256i Esi = Chi(B2, B3, B4);
+        const __m256i Eso = Chi(B3, B4, B0);
+        const __m256i Esu = Chi(B4, B0, B1);
+
+        Aba = Eba; Abe = Ebe; Abi = Ebi; Abo = Ebo; Abu = Ebu;
+        Aga = Ega; Age = Ege; Agi = Egi; Ago = Ego; Agu = Egu;
+        Aka = Eka; Ake = Eke; Aki = Eki; Ako = Eko; Aku = Eku;
+        Ama = Ema; Ame = Eme; Ami = Emi; Amo = Emo; Amu = Emu;
+        Asa = Esa; Ase = Ese; Asi = Esi; Aso = Eso; Asu = Esu;
+    }
+
+    Store(s + 0, Aba); Store(s + 4, Abe); Store(s + 8, Abi); Store(s + 12, Abo); Store(s + 16, Abu);
+    Store(s + 20, Aga); Store(s + 24, Age); Store(s + 28, Agi); Store(s + 32, Ago); Store(s + 36, Agu);
+    Store(s + 40, Aka); Store(s + 44, Ake); Store(s + 48, Aki); Store(s + 52, Ako); Store(s + 56, Aku);
+    Store(s + 60, Ama); Store(s + 64, Ame); Store(s + 68, Ami); Store(s + 72, Amo); Store(s + 76, Amu);
+    Store(s + 80, Asa); Store(s + 84, Ase); Store(s + 88, Asi); Store(s + 92, Aso); Store(s + 96, Asu);
+}
+
+}
+}
+
+#endif
@@ -4,88 +4,91 @@
 
 #include "ethereum.h"
 #include "SHA3.h"
+#include <crypto/common.h>
 #include <services/assetallocation.h>
 using namespace dev;
 
 
-int nibblesToTraverse(const std::string &encodedPartialPath, const std::string &path, int pathPtr) {
-  std::string partialPath;
-  char pathPtrInt[2] = {encodedPartialPath[0], '\0'};
-  int partialPathInt = strtol(pathPtrInt, NULL, 10);
-  if(partialPathInt == 0 || partialPathInt == 2){
-    partialPath = encodedPartialPath.substr(2);
-  }else{
-    partialPath = encodedPartialPath.substr(1);
-  }
-  if(partialPath == path.substr(pathPtr, partialPath.size())){
-    return partialPath.size();
-  }else{
+/**
+ * Nibble of a byte string, counting the high nibble of each byte first.
+ */
+static unsigned char GetNibble(Span<const unsigned char> data, size_t nPos) {
+  return (nPos % 2 ? data[nPos / 2] : data[nPos / 2] >> 4) & 0x0f;
+}
+
+/**
+ * Match the hex-prefix encoded partial path of a trie node against the path at nPathPtr.
+ * Returns the number of nibbles the node consumes, or -1 if it does not match.
+ */
+static int nibblesToTraverse(Span<const unsigned char> encodedPartialPath, Span<const unsigned char> path, size_t nPathPtr) {
+  if(encodedPartialPath.size() == 0)
+    return -1;
+  // odd length paths carry their first nibble next to the flag; anything that is not a digit counts as a zero flag
+  const unsigned char nFlag = GetNibble(encodedPartialPath, 0);
+  const size_t nSkip = (nFlag == 0 || nFlag == 2 || nFlag > 9) ? 2 : 1;
+  const size_t nNibbles = 2 * encodedPartialPath.size() - nSkip;
+  if(nNibbles > 2 * path.size() - nPathPtr)
     return -1;
+  for(size_t i = 0; i < nNibbles; i++){
+    if(GetNibble(encodedPartialPath, nSkip + i) != GetNibble(path, nPathPtr + i))
+      return -1;
   }
+  return nNibbles;
 }
-bool VerifyProof(bytesConstRef path, const RLP& value, const RLP& parentNodes, const RLP& root) {
-    try{
-        dev::RLP currentNode;
-        const int len = parentNodes.itemCount();
-        dev::RLP nodeKey = root;       
-        int pathPtr = 0;
+bool VerifyProof(Span<const unsigned char> path, Span<const unsigned char> value, Span<const unsigned char> parentNodes, Span<const unsigned char> root) {
+    const RLPView rlpParentNodes(parentNodes);
+    RLPView nodeKey(root);
+    std::vector<RLPView> vNodes;
+    if(!nodeKey.IsValid() || !rlpParentNodes.GetItems(vNodes))
+        return false;
 
-    	const std::string pathString = toHex(path);
-  
-        int nibbles;
-        char pathPtrInt[2];
-        for (int i = 0 ; i < len ; i++) {
-          currentNode = parentNodes[i];
-          if(!nodeKey.payload().contentsEqual(sha3(currentNode.data()).ref().toVector())){
-            return false;
-          } 
+    // SYSCOIN hash all nodes of the proof together
+    std::vector<bytesConstRef> nodes;
+    nodes.reserve(vNodes.size());
+    for (const RLPView& node : vNodes)
+      nodes.emplace_back(node.Data().data(), node.Data().size());
+    const std::vector<h256> nodeHashes = sha3Multi(nodes);
 
-          if(pathPtr > (int)pathString.size()){
-            return false;
-          }
+    const size_t nPathNibbles = 2 * path.size();
+    size_t nPathPtr = 0;
+    int nibbles;
+    std::vector<RLPView> vItems;
+    vItems.reserve(17);
+    for (size_t i = 0 ; i < vNodes.size() ; i++) {
+      if(nodeKey.Payload() != Span<const unsigned char>(nodeHashes[i].data(), nodeHashes[i].size)){
+        return false;
+      } 
 
-          switch(currentNode.itemCount()){
-            case 17://branch node
-              if(pathPtr == (int)pathString.size()){
-                if(currentNode[16].payload().contentsEqual(value.data().toVector())){
-    
-                  return true;
-                }else{
-                  return false;
-                }
-              }
-          
-              pathPtrInt[0] = pathString[pathPtr];
-              pathPtrInt[1] = '\0';
+      if(nPathPtr > nPathNibbles){
+        return false;
+      }
 
-              nodeKey = currentNode[strtol(pathPtrInt, NULL, 16)]; //must == sha3(rlp.encode(currentNode[path[pathptr]]))
-              pathPtr += 1;
-              break;
-            case 2:
-              nibbles = nibblesToTraverse(toHex(currentNode[0].payload()), pathString, pathPtr);
+      if(!vNodes[i].GetItems(vItems)){
+        return false;
+      }
+      switch(vItems.size()){
+        case 17://branch node
+          if(nPathPtr == nPathNibbles){
+            return vItems[16].Payload() == value;
+          }
+          nodeKey = vItems[GetNibble(path, nPathPtr)]; //must == sha3(rlp.encode(currentNode[path[pathptr]]))
+          nPathPtr += 1;
+          break;
+        case 2:
+          nibbles = nibblesToTraverse(vItems[0].Payload(), path, nPathPtr);
+          if(nibbles <= -1)
+            return false;
+          nPathPtr += nibbles;
 
-              if(nibbles <= -1)
-                return false;
-              pathPtr += nibbles;
-      
-              if(pathPtr == (int)pathString.size()) { //leaf node
-                if(currentNode[1].payload().contentsEqual(value.data().toVector())){
-         
-                  return true;
-                } else {
-                  return false;
-                }
-              } else {//extension node
-                nodeKey = currentNode[1];
-              }
-              break;
-            default:
-              return false;
+          if(nPathPtr == nPathNibbles) { //leaf node
+            return vItems[1].Payload() == value;
+          } else {//extension node
+            nodeKey = vItems[1];
           }
-        }
-    }
-    catch(...){
-        return false;
+          break;
+        default:
+          return false;
+      }
     }
   return false;
 }
@@ -100,52 +103,38 @@ bool VerifyProof(bytesConstRef path, const RLP& value, const RLP& parentNodes, c
  * @param nAsset The asset burned or 0 for SYS 
  * @return true if everything is valid
  */
-bool parseEthMethodInputData(const std::vector<unsigned char>& vchInputExpectedMethodHash, const std::vector<unsigned char>& vchInputData, CAmount& outputAmount, uint32_t& nAsset, CWitnessAddress& witnessAddress) {
+bool parseEthMethodInputData(const std::vector<unsigned char>& vchInputExpectedMethodHash, Span<const unsigned char> vchInputData, CAmount& outputAmount, uint32_t& nAsset, CWitnessAddress& witnessAddress) {
     // 132 for the varint position + 1 for varint + 1 for version + 3 minimum for witness program bytes
     if(vchInputData.size() < 137) 
         return false;  
     // method hash is 4 bytes
-    std::vector<unsigned char>::const_iterator first = vchInputData.begin();
-    std::vector<unsigned char>::const_iterator last = first + 4;
-    const std::vector<unsigned char> vchMethodHash(first,last);
     // if the method hash doesn't match the expected method hash then return false
-    if(vchMethodHash != vchInputExpectedMethodHash) 
+    if(vchInputExpectedMethodHash.size() != 4 || !std::equal(vchInputExpectedMethodHash.begin(), vchInputExpectedMethodHash.end(), vchInputData.begin())) 
         return false;
 
     // get the first parameter and convert to CAmount and assign to output var
     // convert the vch into a int64_t (CAmount)
     // should be in position 36 walking backwards
-    uint64_t result = static_cast<uint64_t>(vchInputData[35]);
-    result |= static_cast<uint64_t>(vchInputData[34]) << 8;
-    result |= static_cast<uint64_t>(vchInputData[33]) << 16;
-    result |= static_cast<uint64_t>(vchInputData[32]) << 24;
-    result |= static_cast<uint64_t>(vchInputData[31]) << 32;
-    result |= static_cast<uint64_t>(vchInputData[30]) << 40;
-    result |= static_cast<uint64_t>(vchInputData[29]) << 48;
-    result |= static_cast<uint64_t>(vchInputData[28]) << 56;
-    outputAmount = (CAmount)result;
+    outputAmount = (CAmount)ReadBE64(vchInputData.data() + 28);
 
     // get the second parameter and convert to uint32_t and assign to output var
     // commented out for now since it's unused but I wanted it  here for clarity
     // and potential afuture enhancements
     // convert the vch into a uin32_t (nAsset)
     // should be in position 40 walking backwards
-    nAsset = static_cast<uint32_t>(vchInputData[39]);
-    nAsset |= static_cast<uint32_t>(vchInputData[38]) << 8;
-    nAsset |= static_cast<uint32_t>(vchInputData[37]) << 16;
-    nAsset |= static_cast<uint32_t>(vchInputData[36]) << 24;
+    nAsset = ReadBE32(vchInputData.data() + 36);
     
     // skip data position field (68 + 32) + 31 (offset to the varint _byte)
     int dataPos = 131;
     const unsigned char &dataLength = vchInputData[dataPos++];
     // witness programs can extend to 40 bytes, plus 1 for version, min length is 2 for min witness program + 1 for version
-    if(dataLength > 41 || dataLength < 3)
+    if(dataLength > 41 || dataLength < 3 || dataPos + dataLength > vchInputData.size())
         return false;
     // witness address information starting at position dataPos till the end
     // get version proceeded by witness program bytes
     const unsigned char& nVersion = vchInputData[dataPos++];
-    std::vector<unsigned char>::const_iterator firstWitness = vchInputData.begin()+dataPos;
-    std::vector<unsigned char>::const_iterator lastWitness = firstWitness + (dataLength-1);
+    const unsigned char* firstWitness = vchInputData.begin()+dataPos;
+    const unsigned char* lastWitness = firstWitness + (dataLength-1);
     witnessAddress = CWitnessAddress(nVersion, std::vector<unsigned char>(firstWitness,lastWitness));
     return witnessAddress.IsValid();
-}
\ No newline at end of file
+}
@@ -7,10 +7,11 @@
 
 #include <vector>
 #include "CommonData.h"
-#include "RLP.h"
+#include "RLPView.h"
 #include <amount.h>
+#include <span.h>
 class CWitnessAddress;
 
-bool VerifyProof(dev::bytesConstRef path, const dev::RLP& value, const dev::RLP& parentNodes, const dev::RLP& root); 
-bool parseEthMethodInputData(const std::vector<unsigned char>& vchInputExpectedMethodHash, const std::vector<unsigned char>& vchInputData, CAmount& outputAmount, uint32_t& nAsset, CWitnessAddress& witnessAddress);
+bool VerifyProof(Span<const unsigned char> path, Span<const unsigned char> value, Span<const unsigned char> parentNodes, Span<const unsigned char> root); 
+bool parseEthMethodInputData(const std::vector<unsigned char>& vchInputExpectedMethodHash, Span<const unsigned char> vchInputData, CAmount& outputAmount, uint32_t& nAsset, CWitnessAddress& witnessAddress);
 #endif // SYSCOIN_ETHEREUM_ETHEREUM_H
@@ -9,6 +9,7 @@
 #include <key_io.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <rpc/util.h>
 #include <random.h>
 #include <sync.h>
 #include <util.h>
@@ -17,6 +18,7 @@
 #include <crypto/hmac_sha256.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <boost/algorithm/string.hpp> // boost::trim
@@ -277,6 +279,22 @@ static bool checkPreflight(HTTPRequest* req)
     return false;
 }
 
+/** Handle an error raised while the result was being streamed. Unsent output is
+ * dropped so that a regular error reply can be sent; once part of the result is on
+ * the wire the only option left is to end the reply, leaving the JSON truncated.
+ * Returns true if the reply has been ended.
+ */
+static bool AbortStreamedReply(HTTPRequest* req, JSONStreamWriter& stream)
+{
+    if (!stream.Flushed()) {
+        stream.Discard();
+        return false;
+    }
+    LogPrintf("%s: error while streaming RPC result, reply truncated\n", __func__);
+    req->EndChunkedReply();
+    return true;
+}
+
 static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
 {
     // SYSCOIN Check if this is a preflight request - if so set the necessary
@@ -312,6 +330,19 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         return false;
     }
 
+    // Large results of singleton requests are streamed into a chunked reply, which is
+    // started only once the first JSON_STREAM_FLUSH_SIZE bytes of the result exist
+    bool fChunked = false;
+    JSONStreamWriter stream([req, &fChunked](const std::string& strChunk) {
+        if (!fChunked) {
+            req->WriteHeader("Content-Type", "application/json");
+            req->StartChunkedReply(HTTP_OK);
+            req->WriteReplyChunk("{\"result\":");
+            fChunked = true;
+        }
+        req->WriteReplyChunk(strChunk);
+    });
+
     try {
         // Parse request
         UniValue valRequest;
@@ -325,9 +356,17 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         // singleton request
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
+            jreq.stream = &stream;
 
             UniValue result = tableRPC.execute(jreq);
 
+            if (stream.Started()) {
+                stream.Flush();
+                req->WriteReplyChunk(",\"error\":null,\"id\":" + jreq.id.write() + "}\n");
+                req->EndChunkedReply();
+                return true;
+            }
+
             // Send reply
             strReply = JSONRPCReply(result, NullUniValue, jreq.id);
 
@@ -340,15 +379,129 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strReply);
     } catch (const UniValue& objError) {
-        JSONErrorReply(req, objError, jreq.id);
+        if (!AbortStreamedReply(req, stream))
+            JSONErrorReply(req, objError, jreq.id);
         return false;
     } catch (const std::exception& e) {
-        JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id);
+        if (!AbortStreamedReply(req, stream))
+            JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id);
         return false;
     }
     return true;
 }
 
+static bool IsJSONSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/** Skip a JSON string starting at the opening quote; returns the position past the
+ * closing quote, or nullptr if the string is unterminated.
+ */
+static const char* SkipJSONString(const char* p, const char* pend)
+{
+    for (++p; p != pend; ++p) {
+        if (*p == '\\') {
+            if (++p == pend)
+                break;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+/** Skip a JSON value (string, object, array or literal) at p; returns the position
+ * past it, or pend if the value is truncated.
+ */
+static const char* SkipJSONValue(const char* p, const char* pend)
+{
+    if (p == pend)
+        return pend;
+    if (*p == '"') {
+        p = SkipJSONString(p, pend);
+        return p ? p : pend;
+    }
+    if (*p != '{' && *p != '[') {
+        while (p != pend && *p != ',' && *p != '}' && *p != ']' && !IsJSONSpace(*p))
+            ++p;
+        return p;
+    }
+    int nDepth = 0;
+    while (p != pend) {
+        if (*p == '"') {
+            p = SkipJSONString(p, pend);
+            if (!p)
+                return pend;
+            continue;
+        }
+        if (*p == '{' || *p == '[') {
+            ++nDepth;
+        } else if (*p == '}' || *p == ']') {
+            if (--nDepth == 0)
+                return p + 1;
+        }
+        ++p;
+    }
+    return pend;
+}
+
+std::string JSONRPCPeekMethod(const char* pbegin, const char* pend)
+{
+    static const std::string strKey = "method";
+    const char* p = pbegin;
+    auto skipSpace = [&]() {
+        while (p != pend && IsJSONSpace(*p))
+            ++p;
+    };
+    skipSpace();
+    // batches are dispatched as a whole to the default class
+    if (p == pend || *p != '{')
+        return "";
+    ++p;
+    while (true) {
+        skipSpace();
+        if (p == pend || *p != '"')
+            return "";
+        const char* pKey = p + 1;
+        p = SkipJSONString(p, pend);
+        if (!p)
+            return "";
+        const bool fMethod = std::string(pKey, p - 1) == strKey;
+        skipSpace();
+        if (p == pend || *p != ':')
+            return "";
+        ++p;
+        skipSpace();
+        if (fMethod) {
+            if (p == pend || *p != '"')
+                return "";
+            const char* pMethod = p + 1;
+            p = SkipJSONString(p, pend);
+            if (!p)
+                return "";
+            std::string strMethod(pMethod, p - 1);
+            // escaped names are left to the real parser
+            if (strMethod.find('\\') != std::string::npos)
+                return "";
+            return strMethod;
+        }
+        p = SkipJSONValue(p, pend);
+        skipSpace();
+        if (p == pend || *p != ',')
+            return "";
+        ++p;
+    }
+}
+
+static std::string HTTPReq_JSONRPC_Method(HTTPRequest* req)
+{
+    std::pair<const char*, size_t> body = req->PeekBody();
+    if (!body.first)
+        return "";
+    return JSONRPCPeekMethod(body.first, body.first + body.second);
+}
+
 static bool InitRPCAuthentication()
 {
     if (gArgs.GetArg("-rpcpassword", "") == "")
@@ -377,10 +530,10 @@ bool StartHTTPRPC()
     if (!InitRPCAuthentication())
         return false;
 
-    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC);
+    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC, HTTPReq_JSONRPC_Method);
 #ifdef ENABLE_WALLET
     // ifdef can be removed once we switch to better endpoint support and API versioning
-    RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC);
+    RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC, HTTPReq_JSONRPC_Method);
 #endif
     assert(EventBase());
     httpRPCTimerInterface = MakeUnique<HTTPRPCTimerInterface>(EventBase());
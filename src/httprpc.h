@@ -20,6 +20,12 @@ void InterruptHTTPRPC();
  */
 void StopHTTPRPC();
 
+/** Return the top-level "method" of a singleton JSON-RPC request body without fully
+ * parsing it, or an empty string for batches, malformed bodies and escaped names.
+ * Only used to pick a -rpcworkclass queue; the request is parsed properly later.
+ */
+std::string JSONRPCPeekMethod(const char* pbegin, const char* pend);
+
 /** Start HTTP REST subsystem.
  * Precondition; HTTP and RPC has been started.
  */
@@ -12,7 +12,11 @@
 #include <rpc/protocol.h> // For HTTP status codes
 #include <sync.h>
 #include <ui_interface.h>
+#include <utiltime.h>
+#include <thread_pool/mpmc_bounded_queue.hpp>
 
+#include <atomic>
+#include <map>
 #include <memory>
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,6 +27,8 @@
 #include <signal.h>
 #include <future>
 
+#include <boost/algorithm/string.hpp>
+
 #include <event2/thread.h>
 #include <event2/buffer.h>
 #include <event2/bufferevent.h>
@@ -61,23 +67,67 @@ private:
     HTTPRequestHandler func;
 };
 
-/** Simple work queue for distributing work over multiple threads.
- * Work items are simply callable objects.
+/** Work queue for distributing work over multiple threads.
+ * Work items are simply callable objects. They are handed to the workers through
+ * a lock-free bounded queue; the mutex is only used to park and wake idle workers.
  */
 template <typename WorkItem>
 class WorkQueue
 {
 private:
-    /** Mutex protects entire object */
+    struct QueuedItem
+    {
+        std::unique_ptr<WorkItem> item;
+        int64_t nTimeQueued = 0;
+    };
+
+    tp::MPMCBoundedQueue<QueuedItem> queue;
+    /** Mutex and condition variable for sleeping workers, not needed to enqueue or dequeue */
     std::mutex cs;
     std::condition_variable cond;
-    std::deque<std::unique_ptr<WorkItem>> queue;
-    bool running;
-    size_t maxDepth;
+    std::atomic<bool> running;
+    std::atomic<int> nIdle;
+    const size_t maxDepth;
+    std::atomic<size_t> nDepth;
+
+    // Statistics
+    std::atomic<size_t> nPeakDepth;
+    std::atomic<uint64_t> nProcessed;
+    std::atomic<uint64_t> nRejected;
+    std::atomic<uint64_t> nTotalWaitMicros;
+    std::atomic<uint64_t> nMaxWaitMicros;
+    std::atomic<uint64_t> nTotalRunMicros;
+    std::atomic<uint64_t> nMaxRunMicros;
+
+    /** The lock-free queue needs a power of two capacity, depth is bounded separately */
+    static size_t QueueCapacity(size_t depth)
+    {
+        size_t capacity = 2;
+        while (capacity < depth)
+            capacity <<= 1;
+        return capacity;
+    }
+
+    template <typename T>
+    static void UpdateMax(std::atomic<T>& max, T value)
+    {
+        T prev = max.load();
+        while (prev < value && !max.compare_exchange_weak(prev, value)) {}
+    }
 
 public:
-    explicit WorkQueue(size_t _maxDepth) : running(true),
-                                 maxDepth(_maxDepth)
+    explicit WorkQueue(size_t _maxDepth) : queue(QueueCapacity(_maxDepth)),
+                                 running(true),
+                                 nIdle(0),
+                                 maxDepth(_maxDepth),
+                                 nDepth(0),
+                                 nPeakDepth(0),
+                                 nProcessed(0),
+                                 nRejected(0),
+                                 nTotalWaitMicros(0),
+                                 nMaxWaitMicros(0),
+                                 nTotalRunMicros(0),
+                                 nMaxRunMicros(0)
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
@@ -88,29 +138,55 @@ public:
     /** Enqueue a work item */
     bool Enqueue(WorkItem* item)
     {
-        std::unique_lock<std::mutex> lock(cs);
-        if (queue.size() >= maxDepth) {
+        if (nDepth.fetch_add(1) >= maxDepth) {
+            nDepth.fetch_sub(1);
+            nRejected++;
+            return false;
+        }
+        QueuedItem queued;
+        queued.item.reset(item);
+        queued.nTimeQueued = GetTimeMicros();
+        if (!queue.push(std::move(queued))) {
+            // caller keeps ownership on failure
+            queued.item.release();
+            nDepth.fetch_sub(1);
+            nRejected++;
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
-        cond.notify_one();
+        UpdateMax(nPeakDepth, nDepth.load());
+        // Pairs with the increment of nIdle in Run(): either the worker sees the item or we see the worker
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (nIdle.load() > 0) {
+            std::unique_lock<std::mutex> lock(cs);
+            cond.notify_one();
+        }
         return true;
     }
     /** Thread function */
     void Run()
     {
-        while (true) {
-            std::unique_ptr<WorkItem> i;
-            {
+        while (running) {
+            QueuedItem i;
+            if (!queue.pop(i)) {
                 std::unique_lock<std::mutex> lock(cs);
-                while (running && queue.empty())
+                nIdle++;
+                while (running && !queue.pop(i))
                     cond.wait(lock);
-                if (!running)
-                    break;
-                i = std::move(queue.front());
-                queue.pop_front();
+                nIdle--;
             }
-            (*i)();
+            if (!running)
+                break;
+            nDepth.fetch_sub(1);
+            const int64_t nTimeStart = GetTimeMicros();
+            (*i.item)();
+            const int64_t nTimeEnd = GetTimeMicros();
+            const uint64_t nWait = std::max<int64_t>(nTimeStart - i.nTimeQueued, 0);
+            const uint64_t nRun = std::max<int64_t>(nTimeEnd - nTimeStart, 0);
+            nProcessed++;
+            nTotalWaitMicros += nWait;
+            nTotalRunMicros += nRun;
+            UpdateMax(nMaxWaitMicros, nWait);
+            UpdateMax(nMaxRunMicros, nRun);
         }
     }
     /** Interrupt and exit loops */
@@ -120,18 +196,46 @@ public:
         running = false;
         cond.notify_all();
     }
+    /** Fill in queue depth and latency statistics */
+    void GetStats(HTTPWorkQueueStats& stats) const
+    {
+        stats.depth = nDepth.load();
+        stats.max_depth = maxDepth;
+        stats.peak_depth = nPeakDepth.load();
+        stats.processed = nProcessed.load();
+        stats.rejected = nRejected.load();
+        stats.total_wait_us = nTotalWaitMicros.load();
+        stats.max_wait_us = nMaxWaitMicros.load();
+        stats.total_run_us = nTotalRunMicros.load();
+        stats.max_run_us = nMaxRunMicros.load();
+    }
+};
+
+/** A class of requests with its own work queue and worker threads, see -rpcworkclass */
+struct HTTPWorkClass
+{
+    HTTPWorkClass(const std::string& _name, int _threads, size_t depth):
+        name(_name), threads(_threads), queue(depth)
+    {
+    }
+    std::string name;
+    int threads;
+    std::vector<std::string> methods;
+    WorkQueue<HTTPClosure> queue;
+    std::vector<std::thread> workers;
 };
 
 struct HTTPPathHandler
 {
     HTTPPathHandler() {}
-    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
-        prefix(_prefix), exactMatch(_exactMatch), handler(_handler)
+    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler, HTTPRequestClassifier _classifier):
+        prefix(_prefix), exactMatch(_exactMatch), handler(_handler), classifier(_classifier)
     {
     }
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
+    HTTPRequestClassifier classifier;
 };
 
 /** HTTP module state */
@@ -142,8 +246,10 @@ static struct event_base* eventBase = nullptr;
 struct evhttp* eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
-//! Work queue for handling longer requests off the event loop thread
-static WorkQueue<HTTPClosure>* workQueue = nullptr;
+//! Work queues for handling longer requests off the event loop thread, the first one is the default class
+static std::vector<std::unique_ptr<HTTPWorkClass>> workClasses;
+//! Work class index by request method (RPC method name)
+static std::map<std::string, size_t> mapWorkClassByMethod;
 //! Handlers for (sub)paths
 std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
@@ -266,12 +372,19 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        assert(!workClasses.empty());
+        HTTPWorkClass* workClass = workClasses.front().get();
+        // Only look at the request when some methods have their own work class
+        if (!mapWorkClassByMethod.empty() && i->classifier) {
+            auto it = mapWorkClassByMethod.find(i->classifier(hreq.get()));
+            if (it != mapWorkClassByMethod.end())
+                workClass = workClasses[it->second].get();
+        }
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
-        assert(workQueue);
-        if (workQueue->Enqueue(item.get()))
+        if (workClass->queue.Enqueue(item.get()))
             item.release(); /* if true, queue took ownership */
         else {
-            LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
+            LogPrintf("WARNING: request rejected because http work queue depth of class %s exceeded, it can be increased with the -rpcworkqueue= setting\n", workClass->name);
             item->req->WriteReply(HTTP_INTERNAL, "Work queue depth exceeded");
         }
     } else {
@@ -342,6 +455,42 @@ static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue)
     queue->Run();
 }
 
+/** Set up the default work class and the ones given with -rpcworkclass=<name>:<threads>:<method>[,<method>...] */
+static bool InitHTTPWorkClasses(int workQueueDepth)
+{
+    workClasses.clear();
+    mapWorkClassByMethod.clear();
+    int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
+    workClasses.emplace_back(new HTTPWorkClass("default", rpcThreads, workQueueDepth));
+
+    for (const std::string& strClass : gArgs.GetArgs("-rpcworkclass")) {
+        std::vector<std::string> vParts;
+        boost::split(vParts, strClass, boost::is_any_of(":"));
+        int nThreads = 0;
+        if (vParts.size() != 3 || vParts[0].empty() || !ParseInt32(vParts[1], &nThreads) || nThreads < 1 || vParts[2].empty()) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf("Invalid -rpcworkclass specification: %s. Valid is <name>:<threads>:<method>[,<method>...]", strClass),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        workClasses.emplace_back(new HTTPWorkClass(vParts[0], nThreads, workQueueDepth));
+        std::vector<std::string> vMethods;
+        boost::split(vMethods, vParts[2], boost::is_any_of(","));
+        for (const std::string& strMethod : vMethods) {
+            if (strMethod.empty())
+                continue;
+            if (!mapWorkClassByMethod.emplace(strMethod, workClasses.size() - 1).second) {
+                uiInterface.ThreadSafeMessageBox(
+                    strprintf("Method %s is assigned to more than one -rpcworkclass", strMethod),
+                    "", CClientUIInterface::MSG_ERROR);
+                return false;
+            }
+            workClasses.back()->methods.push_back(strMethod);
+        }
+    }
+    return true;
+}
+
 /** libevent event log callback */
 static void libevent_log_cb(int severity, const char *msg)
 {
@@ -413,9 +562,10 @@ bool InitHTTPServer()
 
     LogPrint(BCLog::HTTP, "Initialized HTTP server\n");
     int workQueueDepth = std::max((long)gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
+    if (!InitHTTPWorkClasses(workQueueDepth))
+        return false;
+    LogPrintf("HTTP: creating %u work queues of depth %d\n", workClasses.size(), workQueueDepth);
 
-    workQueue = new WorkQueue<HTTPClosure>(workQueueDepth);
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -438,19 +588,19 @@ bool UpdateHTTPServerLogging(bool enable) {
 
 std::thread threadHTTP;
 std::future<bool> threadResult;
-static std::vector<std::thread> g_thread_http_workers;
 
 void StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
-    int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogPrintf("HTTP: starting %d worker threads\n", rpcThreads);
     std::packaged_task<bool(event_base*)> task(ThreadHTTP);
     threadResult = task.get_future();
     threadHTTP = std::thread(std::move(task), eventBase);
 
-    for (int i = 0; i < rpcThreads; i++) {
-        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueue);
+    for (auto& workClass : workClasses) {
+        LogPrintf("HTTP: starting %d worker threads for work class %s\n", workClass->threads, workClass->name);
+        for (int i = 0; i < workClass->threads; i++) {
+            workClass->workers.emplace_back(HTTPWorkQueueRun, &workClass->queue);
+        }
     }
 }
 
@@ -465,21 +615,23 @@ void InterruptHTTPServer()
         // Reject requests on current connections
         evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
     }
-    if (workQueue)
-        workQueue->Interrupt();
+    for (auto& workClass : workClasses)
+        workClass->queue.Interrupt();
 }
 
 void StopHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Stopping HTTP server\n");
-    if (workQueue) {
+    if (!workClasses.empty()) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
-        for (auto& thread: g_thread_http_workers) {
-            thread.join();
+        for (auto& workClass : workClasses) {
+            for (auto& thread: workClass->workers) {
+                thread.join();
+            }
+            workClass->workers.clear();
         }
-        g_thread_http_workers.clear();
-        delete workQueue;
-        workQueue = nullptr;
+        workClasses.clear();
+        mapWorkClassByMethod.clear();
     }
     if (eventBase) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP event thread to exit\n");
@@ -540,12 +692,34 @@ void HTTPEvent::trigger(struct timeval* tv)
         evtimer_add(ev, tv); // trigger after timeval passed
 }
 HTTPRequest::HTTPRequest(struct evhttp_request* _req) : req(_req),
-                                                       replySent(false)
+                                                       replySent(false),
+                                                       chunkedReplyStarted(false)
 {
 }
+
+/** Re-enable reading from the socket once a reply has been sent. This is the second
+ * part of the libevent workaround in http_request_cb. Runs on the event loop thread.
+ */
+static void ReenableReading(struct evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
 HTTPRequest::~HTTPRequest()
 {
-    if (!replySent) {
+    if (chunkedReplyStarted) {
+        // Handler left without finishing its chunked reply; terminate it so the
+        // request does not leak
+        LogPrintf("%s: Unfinished chunked reply\n", __func__);
+        EndChunkedReply();
+    } else if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL, "Unhandled request");
@@ -564,6 +738,18 @@ std::pair<bool, std::string> HTTPRequest::GetHeader(const std::string& hdr)
         return std::make_pair(false, "");
 }
 
+std::pair<const char*, size_t> HTTPRequest::PeekBody()
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return std::make_pair(nullptr, 0);
+    size_t size = evbuffer_get_length(buf);
+    const char* data = (const char*)evbuffer_pullup(buf, size);
+    if (!data)
+        return std::make_pair(nullptr, 0);
+    return std::make_pair(data, size);
+}
+
 std::string HTTPRequest::ReadBody()
 {
     struct evbuffer* buf = evhttp_request_get_input_buffer(req);
@@ -606,23 +792,57 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
-        }
+        ReenableReading(req_copy);
     });
     ev->trigger(nullptr);
     replySent = true;
     req = nullptr; // transferred back to main thread
 }
 
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && !chunkedReplyStarted && req);
+    auto req_copy = req;
+    // Events are activated, and therefore run, in the order they are triggered, so
+    // the chunks below are sent after the reply has been started
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    ev->trigger(nullptr);
+    chunkedReplyStarted = true;
+}
+
+void HTTPRequest::WriteReplyChunk(const std::string& strChunk)
+{
+    assert(chunkedReplyStarted && req);
+    if (strChunk.empty())
+        return; // an empty chunk would terminate the reply
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, strChunk]{
+        struct evbuffer* evb = evbuffer_new();
+        if (!evb)
+            return;
+        evbuffer_add(evb, strChunk.data(), strChunk.size());
+        evhttp_send_reply_chunk(req_copy, evb);
+        evbuffer_free(evb);
+    });
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(chunkedReplyStarted && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy]{
+        evhttp_send_reply_end(req_copy);
+        ReenableReading(req_copy);
+    });
+    ev->trigger(nullptr);
+    chunkedReplyStarted = false;
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
 CService HTTPRequest::GetPeer()
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
@@ -667,10 +887,10 @@ HTTPRequest::RequestMethod HTTPRequest::GetRequestMethod()
     }
 }
 
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPRequestClassifier &classifier)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
-    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler));
+    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler, classifier));
 }
 
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
@@ -698,3 +918,17 @@ std::string urlDecode(const std::string &urlEncoded) {
     }
     return res;
 }
+
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats()
+{
+    std::vector<HTTPWorkQueueStats> vStats;
+    for (const auto& workClass : workClasses) {
+        HTTPWorkQueueStats stats;
+        stats.name = workClass->name;
+        stats.threads = workClass->threads;
+        stats.methods = workClass->methods;
+        workClass->queue.GetStats(stats);
+        vStats.push_back(stats);
+    }
+    return vStats;
+}
@@ -8,6 +8,7 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <vector>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
@@ -38,14 +39,38 @@ bool UpdateHTTPServerLogging(bool enable);
 
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
+/** Classifier returning the method of a request (e.g. the RPC method name), used to
+ * pick the work class configured with -rpcworkclass. Runs on the event loop thread.
+ */
+typedef std::function<std::string(HTTPRequest* req)> HTTPRequestClassifier;
 /** Register handler for prefix.
  * If multiple handlers match a prefix, the first-registered one will
  * be invoked.
  */
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler);
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPRequestClassifier &classifier = nullptr);
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Queue depth and latency statistics of one HTTP work class */
+struct HTTPWorkQueueStats
+{
+    std::string name;
+    int threads = 0;
+    std::vector<std::string> methods;
+    size_t depth = 0;
+    size_t max_depth = 0;
+    size_t peak_depth = 0;
+    uint64_t processed = 0;
+    uint64_t rejected = 0;
+    uint64_t total_wait_us = 0;
+    uint64_t max_wait_us = 0;
+    uint64_t total_run_us = 0;
+    uint64_t max_run_us = 0;
+};
+
+/** Get statistics for all HTTP work classes, the default class first */
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats();
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -59,6 +84,7 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    bool chunkedReplyStarted;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req);
@@ -99,6 +125,12 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Look at the request body without consuming it.
+     * Returns a pointer to the contiguous body and its size, or (nullptr, 0).
+     */
+    std::pair<const char*, size_t> PeekBody();
+
     /**
      * Write output header.
      *
@@ -115,6 +147,23 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Start a chunked HTTP reply, for bodies that are produced incrementally.
+     * Follow with any number of WriteReplyChunk calls and a final EndChunkedReply.
+     *
+     * @note call WriteHeader before this. Can be called only once, instead of WriteReply.
+     */
+    void StartChunkedReply(int nStatus);
+
+    /** Send the next part of a chunked reply. */
+    void WriteReplyChunk(const std::string& strChunk);
+
+    /**
+     * Finish a chunked reply. Like WriteReply, this gives the request back to
+     * the main thread; do not call any other HTTPRequest methods afterwards.
+     */
+    void EndChunkedReply();
 };
 
 /** Event handler closure.
@@ -89,6 +89,7 @@ void BaseIndex::ThreadSync()
 
         int64_t last_log_time = 0;
         int64_t last_locator_write_time = 0;
+        CBlockPrefetcher prefetcher;
         while (true) {
             if (m_interrupt) {
                 WriteBestBlock(pindex);
@@ -105,6 +106,8 @@ void BaseIndex::ThreadSync()
                     break;
                 }
                 pindex = pindex_next;
+                // SYSCOIN read the following blocks while indexing this one
+                prefetcher.Advance(pindex);
             }
 
             int64_t current_time = GetTime();
@@ -120,7 +123,8 @@ void BaseIndex::ThreadSync()
             }
 
             CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+            // SYSCOIN indexes only need the transactions
+            if (!ReadBlockFromDisk(block, pindex, consensus_params, false)) {
                 FatalError("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
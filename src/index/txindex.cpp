@@ -264,7 +264,8 @@ bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRe
         return false;
     }
 
-    CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
+    // SYSCOIN the header is only read to get past it and for its hash
+    CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION | SERIALIZE_BLOCK_NO_AUXPOW);
     if (file.IsNull()) {
         return error("%s: OpenBlockFile failed", __func__);
     }
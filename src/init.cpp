@@ -11,6 +11,7 @@
 
 #include <addrman.h>
 #include <amount.h>
+#include <blockfilemap.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -63,8 +64,10 @@
 #include <netfulfilledman.h>
 #include <flat-database.h>
 // SYSCOIN services
+#include <services/addresscoins.h>
 #include <services/asset.h>
 #include <services/assetallocation.h>
+#include <ethereum/SHA3.h>
 extern AssetBalanceMap mempoolMapAssetBalances;
 extern ArrivalTimesMapImpl arrivalTimesMap; 
 #include <thread_pool/thread_pool.hpp>
@@ -180,6 +183,16 @@ public:
             abort();
         }
     }
+    // SYSCOIN
+    size_t GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const override {
+        try {
+            return base->GetCoins(outpoints, coins);
+        } catch(const std::runtime_error& e) {
+            uiInterface.ThreadSafeMessageBox(_("Error reading from database, shutting down."), "", CClientUIInterface::MSG_ERROR);
+            LogPrintf("Error reading from database: %s\n", e.what());
+            abort();
+        }
+    }
     // Writes do not need similar protection, as failure to write is handled by the caller.
 };
 
@@ -290,7 +303,13 @@ void PrepareShutdown()
     // next startup faster by avoiding rescan.
     // SYSCOIN
     arrivalTimesMap.clear();
+    if (paddresscoincache) {
+        UnregisterValidationInterface(paddresscoincache.get());
+        paddresscoincache.reset();
+    }
     FlushSyscoinDBs();
+    passetcache.reset();
+    passetallocationcache.reset();
     passetdb.reset();
     passetallocationdb.reset();
     passetallocationtransactionsdb.reset();
@@ -307,6 +326,7 @@ void PrepareShutdown()
         }
         pcoinsTip.reset();
         pcoinscatcher.reset();
+        pcoinswritebehind.reset();
         pcoinsdbview.reset();
         pblocktree.reset();
     }
@@ -426,12 +446,15 @@ void SetupServerArgs()
     gArgs.AddArg("-assumevalid=<hex>", strprintf("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s)", defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex()), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-blocksdir=<dir>", "Specify blocks directory (default: <datadir>/blocks)", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-blocknotify=<cmd>", "Execute command when the best block changes (%s in cmd is replaced by block hash)", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-blockprefetch=<n>", strprintf("Number of blocks to read ahead of sequential block scans such as wallet rescans, index sync and -reindex-chainstate (0 to disable, default: %d)", DEFAULT_BLOCK_PREFETCH), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-blockreconstructionextratxn=<n>", strprintf("Extra transactions to keep in memory for compact block reconstructions (default: %u)", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-blocksonly", strprintf("Whether to operate in a blocks only mode (default: %u)", DEFAULT_BLOCKSONLY), true, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-coinswritebehind", strprintf("Write the UTXO cache to disk in the background when it is flushed, so block processing does not stall on the write. Memory use can temporarily exceed -dbcache while a write is in progress (default: %u)", DEFAULT_COINS_WRITE_BEHIND), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-conf=<file>", strprintf("Specify configuration file. Relative paths will be prefixed by datadir location. (default: %s)", SYSCOIN_CONF_FILENAME), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-datadir=<dir>", "Specify data directory", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbcache=<n>", strprintf("Set database cache size in megabytes (%d to %d, default: %d)", nMinDbCache, nMaxDbCache, nDefaultDbCache), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-dbprofile=<database>:<profile>", strprintf("Open a database (%s) with a different LevelDB tuning profile (%s). Can be specified multiple times", ListDBNames(), ListDBProfiles()), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-debuglogfile=<file>", strprintf("Specify location of debug log file. Relative paths will be prefixed by a net-specific datadir location. (-nodebuglogfile to disable; default: %s)", DEFAULT_DEBUGLOGFILE), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", false, OptionsCategory::OPTIONS);
@@ -440,6 +463,7 @@ void SetupServerArgs()
     gArgs.AddArg("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()), true, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-mmapblocks", strprintf("Read blocks from memory-mapped block files where supported (default: %u)", DEFAULT_MMAP_BLOCKS), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), false, OptionsCategory::OPTIONS);
@@ -495,6 +519,7 @@ void SetupServerArgs()
     gArgs.AddArg("-proxy=<ip:port>", "Connect through SOCKS5 proxy, set -noproxy to disable (default: disabled)", false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-proxyrandomize", strprintf("Randomize credentials for every proxy connection. This enables Tor stream isolation (default: %u)", DEFAULT_PROXYRANDOMIZE), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-seednode=<ip>", "Connect to a node to retrieve peer addresses, and disconnect. This option can be specified multiple times to connect to multiple nodes.", false, OptionsCategory::CONNECTION);
+    gArgs.AddArg("-syscoinmsgthreads=<n>", strprintf("Number of threads handling masternode, governance and spork messages apart from block and transaction relay, 0 = handle them on the main message handler thread (0-%d, default: %d)", MAX_SYSCOIN_MSG_THREADS, DEFAULT_SYSCOIN_MSG_THREADS), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-timeout=<n>", strprintf("Specify connection timeout in milliseconds (minimum: 1, default: %d)", DEFAULT_CONNECT_TIMEOUT), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-torcontrol=<ip>:<port>", strprintf("Tor control port to use if onion listening enabled (default: %s)", DEFAULT_TOR_CONTROL), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-torpassword=<pass>", "Tor control port password (default: empty)", false, OptionsCategory::CONNECTION);
@@ -521,6 +546,9 @@ void SetupServerArgs()
     // SYSCOIN
     gArgs.AddArg("-zmqpubassetallocation=<address>", _("Enable publish raw asset allocation payload in <address>"), false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubassetrecord=<address>", _("Enable publish raw asset payload in <address>"), false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubassetallocationraw=<address>", _("Enable publish serialized asset allocation events in <address>"), false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubassetrecordraw=<address>", _("Enable publish serialized asset events in <address>"), false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqsyscoinbatch", strprintf(_("Publish the serialized asset and asset allocation events of a connected block as one multipart message (default: %u)"), DEFAULT_ZMQ_SYSCOIN_BATCH), false, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
@@ -529,8 +557,12 @@ void SetupServerArgs()
     // SYSCOIN
     hidden_args.emplace_back("-zmqpubassetallocation=<address>");
     hidden_args.emplace_back("-zmqpubassetrecord=<address>");
+    hidden_args.emplace_back("-zmqpubassetallocationraw=<address>");
+    hidden_args.emplace_back("-zmqpubassetrecordraw=<address>");
+    hidden_args.emplace_back("-zmqsyscoinbatch");
 #endif
 
+    gArgs.AddArg("-maxsyscoinnotifyqueue=<n>", strprintf("Number of queued asset and asset allocation notifications beyond which unconfirmed ones are dropped (default: %u)", DEFAULT_MAX_SYSCOIN_NOTIFY_QUEUE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checklevel=<n>", strprintf("How thorough the block verification of -checkblocks is (0-4, default: %u)", DEFAULT_CHECKLEVEL), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. (default: %u)", defaultChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
@@ -581,6 +613,8 @@ void SetupServerArgs()
     gArgs.AddArg("-blockmaxweight=<n>", strprintf("Set maximum BIP141 block weight (default: %d)", DEFAULT_BLOCK_MAX_WEIGHT), false, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-blockmintxfee=<amt>", strprintf("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)", CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)), false, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-blockversion=<n>", "Override block version to test forking scenarios", true, OptionsCategory::BLOCK_CREATION);
+    // SYSCOIN
+    gArgs.AddArg("-incrementaltemplate", strprintf("Build block templates by adding new mempool transactions to the last template while the chain tip is unchanged and it was not full (default: %u)", DEFAULT_INCREMENTAL_TEMPLATE), false, OptionsCategory::BLOCK_CREATION);
 
     gArgs.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", false, OptionsCategory::RPC);
@@ -593,6 +627,7 @@ void SetupServerArgs()
     gArgs.AddArg("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT), true, OptionsCategory::RPC);
     gArgs.AddArg("-rpcthreads=<n>", strprintf("Set the number of threads to service RPC calls (default: %d)", DEFAULT_HTTP_THREADS), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcuser=<user>", "Username for JSON-RPC connections", false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcworkclass=<name>:<threads>:<method>[,<method>...]", "Handle the given RPC methods on a separate work queue with its own <threads> worker threads, so they neither wait for nor delay other calls. This option can be specified multiple times (default: all methods share the -rpcthreads queue)", true, OptionsCategory::RPC);
     gArgs.AddArg("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE), true, OptionsCategory::RPC);
     gArgs.AddArg("-gethwebsocketport=<port>", strprintf("Listen for GETH Web Socket connections on <port> for the relayer (default: %u)", 8546), false, OptionsCategory::RPC);
     gArgs.AddArg("-gethtestnet", strprintf("Connect to Ethereum Rinkeby testnet network (default: %d)", false), false, OptionsCategory::RPC);
@@ -1149,6 +1184,10 @@ bool AppInitParameterInteraction()
     else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
         nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
 
+    std::string strDBProfileError;
+    if (!CheckDBProfileArgs(strDBProfileError))
+        return InitError(strDBProfileError);
+
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg = gArgs.GetArg("-prune", 0);
     if (nPruneArg < 0) {
@@ -1228,6 +1267,9 @@ bool AppInitParameterInteraction()
 
     nMaxTipAge = gArgs.GetArg("-maxtipage", DEFAULT_MAX_TIP_AGE);
 
+    g_blockfilemap.SetEnabled(gArgs.GetBoolArg("-mmapblocks", DEFAULT_MMAP_BLOCKS));
+    nBlockPrefetch = std::max<int64_t>(0, gArgs.GetArg("-blockprefetch", DEFAULT_BLOCK_PREFETCH));
+
     fEnableReplacement = gArgs.GetBoolArg("-mempoolreplacement", DEFAULT_ENABLE_REPLACEMENT);
     if ((!fEnableReplacement) && gArgs.IsArgSet("-mempoolreplacement")) {
         // Minimal effort at forwards compatibility
@@ -1293,6 +1335,9 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    // SYSCOIN
+    std::string keccak_algo = dev::SHA3AutoDetect();
+    LogPrintf("Using the '%s' Keccak implementation\n", keccak_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1385,6 +1430,8 @@ bool AppInitMain()
 
     GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
     GetMainSignals().RegisterWithMempoolSignals(mempool);
+    // SYSCOIN
+    GetMainSignals().SetSyscoinQueueLimit(std::max<int64_t>(1, gArgs.GetArg("-maxsyscoinnotifyqueue", DEFAULT_MAX_SYSCOIN_NOTIFY_QUEUE)));
 
     /* Register RPC commands regardless of -server setting so they will be
      * available in the GUI RPC console even if external calls are disabled.
@@ -1522,6 +1569,8 @@ bool AppInitMain()
     // SYSCOIN
     pdsNotificationInterface = new CDSNotificationInterface(connman);
     RegisterValidationInterface(pdsNotificationInterface);
+    paddresscoincache.reset(new CAddressCoinCache());
+    RegisterValidationInterface(paddresscoincache.get());
     
     uint64_t nMaxOutboundLimit = 0; //unlimited unless -maxuploadtarget is set
     uint64_t nMaxOutboundTimeframe = MAX_UPLOAD_TIMEFRAME;
@@ -1571,11 +1620,13 @@ bool AppInitMain()
             try {
                 UnloadBlockIndex();
                 pcoinsTip.reset();
-                pcoinsdbview.reset();
                 pcoinscatcher.reset();
+                pcoinswritebehind.reset();
+                pcoinsdbview.reset();
                 
                 // SYSCOIN
-                
+                passetcache.reset();
+                passetallocationcache.reset();
                 passetdb.reset();
                 passetallocationdb.reset();
                 passetallocationtransactionsdb.reset();
@@ -1584,6 +1635,8 @@ bool AppInitMain()
                 
                 passetdb.reset(new CAssetDB(nCoinDBCache*16, false, fReset));
                 passetallocationdb.reset(new CAssetAllocationDB(nCoinDBCache*32, false, fReset));
+                passetcache.reset(new CAssetCache(*passetdb, "assets"));
+                passetallocationcache.reset(new CAssetAllocationCache(*passetallocationdb, "asset allocations"));
                 passetallocationtransactionsdb.reset(new CAssetAllocationTransactionsDB(0, false, fReset));
                 passetallocationmempooldb.reset(new CAssetAllocationMempoolDB(0, false, fReset));
                 {
@@ -1645,7 +1698,10 @@ bool AppInitMain()
                 // block tree into mapBlockIndex!
 
                 pcoinsdbview.reset(new CCoinsViewDB(nCoinDBCache, false, fReset || fReindexChainState));
-                pcoinscatcher.reset(new CCoinsViewErrorCatcher(pcoinsdbview.get()));
+                // SYSCOIN
+                if (gArgs.GetBoolArg("-coinswritebehind", DEFAULT_COINS_WRITE_BEHIND))
+                    pcoinswritebehind.reset(new CCoinsViewWriteBehind(pcoinsdbview.get()));
+                pcoinscatcher.reset(new CCoinsViewErrorCatcher(pcoinswritebehind ? static_cast<CCoinsView*>(pcoinswritebehind.get()) : pcoinsdbview.get()));
 
                 // If necessary, upgrade from older database format.
                 // This is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
@@ -1817,6 +1873,8 @@ bool AppInitMain()
     fAssetAllocationIndex = gArgs.GetBoolArg("-assetallocationindex", false);
     fZMQAssetAllocation = gArgs.IsArgSet("-zmqpubassetallocation");
     fZMQAsset = gArgs.IsArgSet("-zmqpubassetrecord");
+    fZMQAssetAllocationRaw = gArgs.IsArgSet("-zmqpubassetallocationraw");
+    fZMQAssetRaw = gArgs.IsArgSet("-zmqpubassetrecordraw");
 
     //lite mode disables all Syscoin-specific functionality
     fLiteMode = gArgs.GetBoolArg("-litemode", false);
@@ -1952,6 +2010,8 @@ bool AppInitMain()
     connOptions.nSendBufferMaxSize = 1000*gArgs.GetArg("-maxsendbuffer", DEFAULT_MAXSENDBUFFER);
     connOptions.nReceiveFloodSize = 1000*gArgs.GetArg("-maxreceivebuffer", DEFAULT_MAXRECEIVEBUFFER);
     connOptions.m_added_nodes = gArgs.GetArgs("-addnode");
+    // SYSCOIN
+    connOptions.nSyscoinMsgThreads = gArgs.GetArg("-syscoinmsgthreads", DEFAULT_SYSCOIN_MSG_THREADS);
 
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
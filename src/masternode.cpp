@@ -330,7 +330,7 @@ void CMasternode::UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScan
             mnpayments.mapMasternodeBlocks[BlockReading->nHeight].HasPayeeWithVotes(mnpayee, 2, payee))
         {
             CBlock block;
-			if (!ReadBlockFromDisk(block, BlockReading, Params().GetConsensus())) {
+			if (!ReadBlockFromDisk(block, BlockReading, Params().GetConsensus(), false)) {
 				if (BlockReading->pprev == NULL) { assert(BlockReading); break; }
 				BlockReading = BlockReading->pprev;
 				LogPrint(BCLog::MNPAYMENT, "CMasternode::UpdateLastPaidBlock -- Could not read block from disk\n");
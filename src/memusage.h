@@ -5,7 +5,9 @@
 #ifndef SYSCOIN_MEMUSAGE_H
 #define SYSCOIN_MEMUSAGE_H
 
+#include <arenamap.h>
 #include <indirectmap.h>
+#include <prevector.h>
 
 #include <stdlib.h>
 
@@ -165,6 +167,15 @@ static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z>& m)
     return MallocUsage(sizeof(unordered_node<std::pair<const X, Y> >)) * m.size() + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+template<typename X, typename Y, typename Z>
+static inline size_t DynamicUsage(const arenamap<X, Y, Z>& m)
+{
+    size_t usage = MallocUsage(m.TableBytes()) + MallocUsage(m.ChunkVectorBytes());
+    for (size_t i = 0; i < m.ChunkCount(); i++)
+        usage += MallocUsage(m.ChunkBytes(i));
+    return usage;
+}
+
 }
 
 #endif // SYSCOIN_MEMUSAGE_H
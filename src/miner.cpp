@@ -41,6 +41,30 @@
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockWeight = 0;
 
+// SYSCOIN
+/**
+ * The last template CreateNewBlock built. Later calls on the same chain state
+ * start from its transactions, so they only select and validate what entered
+ * the mempool since, or reuse it outright if nothing did.
+ */
+struct CachedBlockTemplate
+{
+    uint256 hashPrevBlock;
+    int nHeight = 0;
+    int64_t nMedianTimePast = 0;
+    CScript scriptPubKey;
+    bool fIncludeWitness = false;
+    unsigned int nBlockMaxWeight = 0;
+    CFeeRate blockMinFeeRate;
+    unsigned int nTransactionsUpdated = 0;
+    unsigned int nAssetAllocationsUpdated = 0;
+    bool fSelectionLimited = false;
+    //! Selected transactions in the order they were added, before ordering by arrival time
+    std::vector<uint256> vSelected;
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+};
+static CachedBlockTemplate cachedTemplate GUARDED_BY(cs_main);
+
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
 {
     int64_t nOldTime = pblock->nTime;
@@ -59,11 +83,15 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 BlockAssembler::Options::Options() {
     blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     nBlockMaxWeight = DEFAULT_BLOCK_MAX_WEIGHT;
+    // SYSCOIN
+    fIncrementalTemplate = DEFAULT_INCREMENTAL_TEMPLATE;
 }
 
 BlockAssembler::BlockAssembler(const CChainParams& params, const Options& options) : chainparams(params)
 {
     blockMinFeeRate = options.blockMinFeeRate;
+    // SYSCOIN
+    fIncrementalTemplate = options.fIncrementalTemplate;
     // Limit weight to between 4K and MAX_BLOCK_WEIGHT-4K for sanity:
     nBlockMaxWeight = std::max<size_t>(4000, std::min<size_t>(MAX_BLOCK_WEIGHT - 4000, options.nBlockMaxWeight));
 }
@@ -81,6 +109,8 @@ static BlockAssembler::Options DefaultOptions()
     } else {
         options.blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     }
+    // SYSCOIN
+    options.fIncrementalTemplate = gArgs.GetBoolArg("-incrementaltemplate", DEFAULT_INCREMENTAL_TEMPLATE);
     return options;
 }
 
@@ -89,6 +119,8 @@ BlockAssembler::BlockAssembler(const CChainParams& params) : BlockAssembler(para
 void BlockAssembler::resetBlock()
 {
     inBlock.clear();
+    // SYSCOIN
+    fSelectionLimited = false;
 
     // Reserve space for coinbase tx
     nBlockWeight = 4000;
@@ -149,12 +181,27 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     // transaction (which in most cases can be a no-op).
     fIncludeWitness = IsWitnessEnabled(pindexPrev, chainparams.GetConsensus()) && fMineWitnessTx;
 
+    // SYSCOIN start from the last template, which is complete as is if neither the mempool nor
+    // the ZDAG state (arrival order and conflicts) changed since
+    const unsigned int nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    const unsigned int nAssetAllocationsUpdated = mempool.GetAssetAllocationsUpdated();
+    // set when this is a retry without the transactions that failed the syscoin input checks
+    const bool fExcludesFailed = !txsToRemove.empty();
+    const bool fFromCache = fIncrementalTemplate && !fExcludesFailed && LoadCachedTemplate(pindexPrev, nMedianTimePast, scriptPubKeyIn);
+    const bool fUnchanged = fFromCache && nTransactionsUpdated == cachedTemplate.nTransactionsUpdated &&
+            nAssetAllocationsUpdated == cachedTemplate.nAssetAllocationsUpdated;
+
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
-    addPackageTxs(nPackagesSelected, nDescendantsUpdated, txsToRemove);
+    if (!fUnchanged)
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated, txsToRemove);
 
     int64_t nTime1 = GetTimeMicros();
 
+    std::vector<uint256> vSelected;
+    for (size_t i = 1; i < pblock->vtx.size(); i++)
+        vSelected.push_back(pblock->vtx[i]->GetHash());
+
     nLastBlockTx = nBlockTx;
     nLastBlockWeight = nBlockWeight;
 
@@ -185,6 +232,15 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     // Update coinbase transaction with additional info about masternode and governance payments,
     // get some info back to pass to getblocktemplate
     FillBlockPayments(coinbaseTx, nHeight, blockReward, nFees, pblocktemplate->txoutMasternode, pblocktemplate->voutSuperblock);
+
+    // SYSCOIN with the same transactions and payments the last template needs no revalidation
+    if (fUnchanged && pblocktemplate->txoutMasternode == cachedTemplate.pblocktemplate->txoutMasternode &&
+            pblocktemplate->voutSuperblock == cachedTemplate.pblocktemplate->voutSuperblock) {
+        std::unique_ptr<CBlockTemplate> pcachedtemplate(new CBlockTemplate(*cachedTemplate.pblocktemplate));
+        UpdateTime(&pcachedtemplate->block, chainparams.GetConsensus(), pindexPrev);
+        LogPrint(BCLog::BENCH, "CreateNewBlock() reused the last template: %.2fms\n", 0.001 * (GetTimeMicros() - nTimeStart));
+        return pcachedtemplate;
+    }
     // LogPrintf("CreateNewBlock -- nBlockHeight %d blockReward %lld txoutMasternode %s coinbaseTx %s",
     //             nHeight, blockReward, pblocktemplate->txoutMasternode.ToString(), coinbaseTx.ToString());
     
@@ -201,7 +257,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     CValidationState stateInputs;
     txsToRemove.clear();
     bool bOverflow = false;
-    CheckSyscoinInputs(false, *pblock->vtx[0], stateInputs, viewOld, false, bOverflow, nHeight, *pblock, false, true, txsToRemove);
+    const bool fSyscoinInputsValid = CheckSyscoinInputs(false, *pblock->vtx[0], stateInputs, viewOld, false, bOverflow, nHeight, *pblock, false, true, txsToRemove);
     if(bOverflow)
         ResyncAssetAllocationStates();
 
@@ -209,6 +265,9 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
         LogPrint(BCLog::SYS, "CreateNewBlock: CheckSyscoinInputs failed removed %d transactions and trying again...\n", txsToRemove.size());
         return CreateNewBlock(scriptPubKeyIn, fMineWitnessTx, txsToRemove);
     }
+    // TestBlockValidity does not repeat these checks for a template
+    if(!fSyscoinInputsValid)
+        throw std::runtime_error(strprintf("%s: CheckSyscoinInputs failed: %s", __func__, FormatStateMessage(stateInputs)));
     LogPrintf("CreateNewBlock(): block weight: %u txs: %u fees: %ld sigops %d\n", GetBlockWeight(*pblock), nBlockTx, nFees, nBlockSigOpsCost);
 
     // Fill in header
@@ -221,12 +280,28 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
 
     CValidationState state;
-    if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
+    if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false, true)) {
         throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
     }
     int64_t nTime2 = GetTimeMicros();
 
-    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants%s), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, fFromCache ? ", extending the last template" : "", 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+
+    // SYSCOIN a template without failed transactions is not what a fresh selection gives, so it is not kept
+    if (fIncrementalTemplate && !fExcludesFailed) {
+        cachedTemplate.hashPrevBlock = pindexPrev->GetBlockHash();
+        cachedTemplate.nHeight = nHeight;
+        cachedTemplate.nMedianTimePast = nMedianTimePast;
+        cachedTemplate.scriptPubKey = scriptPubKeyIn;
+        cachedTemplate.fIncludeWitness = fIncludeWitness;
+        cachedTemplate.nBlockMaxWeight = nBlockMaxWeight;
+        cachedTemplate.blockMinFeeRate = blockMinFeeRate;
+        cachedTemplate.nTransactionsUpdated = nTransactionsUpdated;
+        cachedTemplate.nAssetAllocationsUpdated = nAssetAllocationsUpdated;
+        cachedTemplate.fSelectionLimited = fSelectionLimited;
+        cachedTemplate.vSelected = std::move(vSelected);
+        cachedTemplate.pblocktemplate.reset(new CBlockTemplate(*pblocktemplate));
+    }
 
     return std::move(pblocktemplate);
 }
@@ -429,6 +504,8 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
         }
 
         if (!TestPackage(packageSize, packageSigOpsCost)) {
+            // SYSCOIN
+            fSelectionLimited = true;
             if (fUsingModified) {
                 // Since we always look at the best entry in mapModifiedTx,
                 // we must erase failed entries so that we can consider the
@@ -484,6 +561,31 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     }
 }
 
+// SYSCOIN
+bool BlockAssembler::LoadCachedTemplate(const CBlockIndex* pindexPrev, int64_t nMedianTimePast, const CScript& scriptPubKeyIn)
+{
+    // A template that left packages out for lack of room may not hold the best of them any more
+    if (!cachedTemplate.pblocktemplate || cachedTemplate.fSelectionLimited)
+        return false;
+    if (cachedTemplate.hashPrevBlock != pindexPrev->GetBlockHash() || cachedTemplate.nHeight != nHeight ||
+            cachedTemplate.nMedianTimePast != nMedianTimePast || cachedTemplate.scriptPubKey != scriptPubKeyIn ||
+            cachedTemplate.fIncludeWitness != fIncludeWitness || cachedTemplate.nBlockMaxWeight != nBlockMaxWeight ||
+            cachedTemplate.blockMinFeeRate != blockMinFeeRate)
+        return false;
+
+    std::vector<CTxMemPool::txiter> vEntries;
+    vEntries.reserve(cachedTemplate.vSelected.size());
+    for (const uint256& hash : cachedTemplate.vSelected) {
+        CTxMemPool::txiter it = mempool.mapTx.find(hash);
+        if (it == mempool.mapTx.end() || it->GetModifiedFee() != it->GetFee())
+            return false;
+        vEntries.push_back(it);
+    }
+    for (CTxMemPool::txiter it : vEntries)
+        AddToBlock(it);
+    return true;
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
@@ -22,6 +22,9 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+// SYSCOIN
+/** Default for -incrementaltemplate, extending the last block template instead of rebuilding it */
+static const bool DEFAULT_INCREMENTAL_TEMPLATE = true;
 
 struct CBlockTemplate
 {
@@ -137,6 +140,8 @@ private:
     bool fIncludeWitness;
     unsigned int nBlockMaxWeight;
     CFeeRate blockMinFeeRate;
+    // SYSCOIN
+    bool fIncrementalTemplate;
 
     // Information on the current status of the block
     uint64_t nBlockWeight;
@@ -144,6 +149,8 @@ private:
     uint64_t nBlockSigOpsCost;
     CAmount nFees;
     CTxMemPool::setEntries inBlock;
+    // SYSCOIN
+    bool fSelectionLimited; //!< Whether block weight or sigops kept a package out
 
     // Chain context for the block
     int nHeight;
@@ -155,6 +162,8 @@ public:
         Options();
         size_t nBlockMaxWeight;
         CFeeRate blockMinFeeRate;
+        // SYSCOIN
+        bool fIncrementalTemplate;
     };
 
     explicit BlockAssembler(const CChainParams& params);
@@ -195,6 +204,11 @@ private:
       * state updated assuming given transactions are inBlock. Returns number
       * of updated descendants. */
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set &mapModifiedTx) EXCLUSIVE_LOCKS_REQUIRED(mempool.cs);
+    // SYSCOIN
+    /** Add the transactions of the last template if it was built for the same
+      * chain state and settings and all of them are still in the mempool
+      * unprioritised. Returns false, adding nothing, otherwise. */
+    bool LoadCachedTemplate(const CBlockIndex* pindexPrev, int64_t nMedianTimePast, const CScript& scriptPubKeyIn) EXCLUSIVE_LOCKS_REQUIRED(cs_main, mempool.cs);
 };
 
 /** Modify the extranonce in a block */
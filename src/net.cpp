@@ -819,6 +819,17 @@ int CNode::GetSendVersion() const
 }
 
 
+// SYSCOIN
+void SplitSyscoinLaneMessages(std::list<CNetMessage>& vRecvMsg, std::list<CNetMessage>::iterator itEnd, std::list<CNetMessage>& vSyscoinMsg)
+{
+    auto it(vRecvMsg.begin());
+    while (it != itEnd) {
+        auto itCur = it++;
+        if (IsSyscoinLaneMessageType(itCur->hdr.GetCommand()))
+            vSyscoinMsg.splice(vSyscoinMsg.end(), vRecvMsg, itCur);
+    }
+}
+
 int CNetMessage::readHeader(const char *pch, unsigned int nBytes)
 {
     // copy data to temporary parsing buffer
@@ -1399,13 +1410,23 @@ void CConnman::ThreadSocketHandler()
                                 break;
                             nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
                         }
+                        // SYSCOIN once the handshake is done, masternode/governance messages go to their own lane
+                        std::list<CNetMessage> vSyscoinMsg;
+                        if (nSyscoinMsgThreads > 0 && pnode->fSuccessfullyConnected)
+                            SplitSyscoinLaneMessages(pnode->vRecvMsg, it, vSyscoinMsg);
+                        const bool fMainMsg = pnode->vRecvMsg.begin() != it;
+                        const bool fSyscoinMsg = !vSyscoinMsg.empty();
                         {
                             LOCK(pnode->cs_vProcessMsg);
                             pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
+                            pnode->vProcessSyscoinMsg.splice(pnode->vProcessSyscoinMsg.end(), vSyscoinMsg);
                             pnode->nProcessQueueSize += nSizeAdded;
                             pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
                         }
-                        WakeMessageHandler();
+                        if (fMainMsg)
+                            WakeMessageHandler();
+                        if (fSyscoinMsg)
+                            WakeSyscoinMessageHandlers();
                     }
                 }
                 else if (nBytes == 0)
@@ -1491,6 +1512,15 @@ void CConnman::WakeMessageHandler()
     condMsgProc.notify_one();
 }
 
+void CConnman::WakeSyscoinMessageHandlers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexSyscoinMsgProc);
+        nSyscoinMsgProcWake++;
+    }
+    condSyscoinMsgProc.notify_all();
+}
+
 
 
 
@@ -2140,6 +2170,51 @@ void CConnman::ThreadMessageHandler()
     }
 }
 
+// SYSCOIN
+void CConnman::ThreadSyscoinMessageHandler(int nWorker)
+{
+    uint64_t nLastWake = 0;
+    while (!flagInterruptMsgProc)
+    {
+        // Every peer is pinned to one worker so its lane messages are handled in arrival order
+        std::vector<CNode*> vNodesCopy;
+        {
+            LOCK(cs_vNodes);
+            for (CNode* pnode : vNodes) {
+                if (pnode->GetId() % nSyscoinMsgThreads != nWorker)
+                    continue;
+                pnode->AddRef();
+                vNodesCopy.push_back(pnode);
+            }
+        }
+
+        bool fMoreWork = false;
+
+        for (CNode* pnode : vNodesCopy)
+        {
+            if (pnode->fDisconnect)
+                continue;
+
+            bool fMoreNodeWork = m_msgproc->ProcessSyscoinMessages(pnode, flagInterruptMsgProc);
+            fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
+            if (flagInterruptMsgProc)
+                return;
+        }
+
+        {
+            LOCK(cs_vNodes);
+            for (CNode* pnode : vNodesCopy)
+                pnode->Release();
+        }
+
+        std::unique_lock<std::mutex> lock(mutexSyscoinMsgProc);
+        if (!fMoreWork) {
+            condSyscoinMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this, nLastWake] { return nSyscoinMsgProcWake != nLastWake || flagInterruptMsgProc; });
+        }
+        nLastWake = nSyscoinMsgProcWake;
+    }
+}
+
 
 
 
@@ -2287,6 +2362,7 @@ CConnman::CConnman(uint64_t nSeed0In, uint64_t nSeed1In) : nSeed0(nSeed0In), nSe
     nSendBufferMaxSize = 0;
     nReceiveFloodSize = 0;
     flagInterruptMsgProc = false;
+    nSyscoinMsgProcWake = 0;
     SetTryNewOutboundPeer(false);
 
     Options connOptions;
@@ -2449,6 +2525,11 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     // Process messages
     threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
 
+    // SYSCOIN Process masternode, governance and spork messages
+    for (int i = 0; i < nSyscoinMsgThreads; i++) {
+        threadSyscoinMessageHandlers.emplace_back(&TraceThread<std::function<void()> >, "sysmsghand", std::function<void()>(std::bind(&CConnman::ThreadSyscoinMessageHandler, this, i)));
+    }
+
     // Dump network addresses
     scheduler.scheduleEvery(std::bind(&CConnman::DumpData, this), DUMP_ADDRESSES_INTERVAL * 1000);
 
@@ -2486,6 +2567,11 @@ void CConnman::Interrupt()
         flagInterruptMsgProc = true;
     }
     condMsgProc.notify_all();
+    // SYSCOIN
+    {
+        std::lock_guard<std::mutex> lock(mutexSyscoinMsgProc);
+    }
+    condSyscoinMsgProc.notify_all();
 
     interruptNet();
     InterruptSocks5(true);
@@ -2513,6 +2599,12 @@ void CConnman::Stop()
 {
     if (threadMessageHandler.joinable())
         threadMessageHandler.join();
+    // SYSCOIN
+    for (std::thread& thread : threadSyscoinMessageHandlers) {
+        if (thread.joinable())
+            thread.join();
+    }
+    threadSyscoinMessageHandlers.clear();
     if (threadOpenMasternodeConnections.joinable())
         threadOpenMasternodeConnections.join();    
     if (threadOpenConnections.joinable())
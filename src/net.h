@@ -90,6 +90,10 @@ static const bool DEFAULT_FORCEDNSSEED = false;
 // SYSCOIN
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 50 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 10 * 1000;
+/** Default for -syscoinmsgthreads, number of threads handling masternode, governance and spork messages */
+static const int DEFAULT_SYSCOIN_MSG_THREADS = 2;
+/** Maximum number of threads handling masternode, governance and spork messages */
+static const int MAX_SYSCOIN_MSG_THREADS = 16;
 
 // NOTE: When adjusting this, update rpcnet:setban's help ("24h")
 static const unsigned int DEFAULT_MISBEHAVING_BANTIME = 60 * 60 * 24;  // Default 24-hour ban
@@ -152,6 +156,8 @@ public:
         bool m_use_addrman_outgoing = true;
         std::vector<std::string> m_specified_outgoing;
         std::vector<std::string> m_added_nodes;
+        // SYSCOIN
+        int nSyscoinMsgThreads = 0;
     };
 
     void Init(const Options& connOptions) {
@@ -165,6 +171,8 @@ public:
         m_msgproc = connOptions.m_msgproc;
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
+        // SYSCOIN
+        nSyscoinMsgThreads = std::max(0, std::min(connOptions.nSyscoinMsgThreads, MAX_SYSCOIN_MSG_THREADS));
         {
             LOCK(cs_totalBytesSent);
             nMaxOutboundTimeframe = connOptions.nMaxOutboundTimeframe;
@@ -384,6 +392,8 @@ public:
     unsigned int GetReceiveFloodSize() const;
 
     void WakeMessageHandler();
+    // SYSCOIN
+    void WakeSyscoinMessageHandlers();
 
     /** Attempts to obfuscate tx time through exponentially distributed emitting.
         Works assuming that a single interval is used.
@@ -416,6 +426,8 @@ private:
     void ProcessOneShot();
     void ThreadOpenConnections(std::vector<std::string> connect);
     void ThreadMessageHandler();
+    // SYSCOIN
+    void ThreadSyscoinMessageHandler(int nWorker);
     void AcceptConnection(const ListenSocket& hListenSocket);
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
@@ -517,6 +529,13 @@ private:
     std::mutex mutexMsgProc;
     std::atomic<bool> flagInterruptMsgProc;
 
+    // SYSCOIN number of masternode/governance message lane workers, 0 if the lane is disabled
+    int nSyscoinMsgThreads;
+    /** generation counter for waking the masternode/governance message lane workers */
+    uint64_t nSyscoinMsgProcWake;
+    std::condition_variable condSyscoinMsgProc;
+    std::mutex mutexSyscoinMsgProc;
+
     CThreadInterrupt interruptNet;
 
     std::thread threadDNSAddressSeed;
@@ -525,6 +544,8 @@ private:
     std::thread threadOpenConnections;
     std::thread threadOpenMasternodeConnections;
     std::thread threadMessageHandler;
+    // SYSCOIN
+    std::vector<std::thread> threadSyscoinMessageHandlers;
 
     /** flag for deciding to connect to an extra outbound peer,
      *  in excess of nMaxOutbound
@@ -566,6 +587,8 @@ class NetEventsInterface
 public:
     virtual bool ProcessMessages(CNode* pnode, std::atomic<bool>& interrupt) = 0;
     virtual bool SendMessages(CNode* pnode) = 0;
+    // SYSCOIN process masternode/governance messages queued on the separate message lane
+    virtual bool ProcessSyscoinMessages(CNode* pnode, std::atomic<bool>& interrupt) = 0;
     virtual void InitializeNode(CNode* pnode) = 0;
     virtual void FinalizeNode(NodeId id, bool& update_connection_time) = 0;
 
@@ -700,6 +723,14 @@ public:
     int readData(const char *pch, unsigned int nBytes);
 };
 
+// SYSCOIN
+/**
+ * Move the masternode/governance/spork messages in [vRecvMsg.begin(), itEnd) to the end of vSyscoinMsg.
+ * Messages keep their relative order within each lane, but a lane message may be handled before or
+ * after main lane messages the peer sent around it, so lane handlers must not depend on them.
+ */
+void SplitSyscoinLaneMessages(std::list<CNetMessage>& vRecvMsg, std::list<CNetMessage>::iterator itEnd, std::list<CNetMessage>& vSyscoinMsg);
+
 
 /** Information about a peer */
 class CNode
@@ -719,6 +750,9 @@ public:
 
     CCriticalSection cs_vProcessMsg;
     std::list<CNetMessage> vProcessMsg;
+    // SYSCOIN messages for the masternode/governance lane, guarded by cs_vProcessMsg and counted in nProcessQueueSize.
+    // Only ordered relative to each other, see SplitSyscoinLaneMessages
+    std::list<CNetMessage> vProcessSyscoinMsg;
     size_t nProcessQueueSize;
 
     CCriticalSection cs_sendProcessing;
@@ -796,6 +830,7 @@ public:
     // SYSCOIN List of non-tx/non-block inventory items
     std::vector<CInv> vInventoryOtherToSend;
     CCriticalSection cs_inventory;
+    // guarded by cs_main, also on the syscoin message lanes
     std::set<uint256> setAskFor;
     std::multimap<int64_t, CInv> mapAskFor;
     int64_t nNextInvSend;
@@ -1725,6 +1725,16 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
     return true;
 }
 
+// SYSCOIN
+static void ProcessSyscoinMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman* connman)
+{
+    mnodeman.ProcessMessage(pfrom, strCommand, vRecv, *connman);
+    mnpayments.ProcessMessage(pfrom, strCommand, vRecv, *connman);
+    sporkManager.ProcessSpork(pfrom, strCommand, vRecv, *connman);
+    masternodeSync.ProcessMessage(pfrom, strCommand, vRecv);
+    governance.ProcessMessage(pfrom, strCommand, vRecv, *connman);
+}
+
 bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, const std::atomic<bool>& interruptMsgProc, bool enable_bip61)
 {
     // SYSCOIN
@@ -3127,11 +3137,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         if (found)
         {
             //probably one the extensions
-            mnodeman.ProcessMessage(pfrom, strCommand, vRecv, *connman);
-            mnpayments.ProcessMessage(pfrom, strCommand, vRecv,*connman);
-            sporkManager.ProcessSpork(pfrom, strCommand, vRecv, *connman);
-            masternodeSync.ProcessMessage(pfrom, strCommand, vRecv);
-            governance.ProcessMessage(pfrom, strCommand, vRecv,*connman);
+            ProcessSyscoinMessage(pfrom, strCommand, vRecv, connman);
         }
         else
         {
@@ -3177,46 +3183,9 @@ static bool SendRejectsAndCheckIfBanned(CNode* pnode, CConnman* connman, bool en
     return false;
 }
 
-bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
+/** Check message start, header and checksum of a message taken off a peer's process queue */
+static bool CheckNetMessage(CNode* pfrom, CNetMessage& msg, const CChainParams& chainparams)
 {
-    const CChainParams& chainparams = Params();
-    //
-    // Message format
-    //  (4) message start
-    //  (12) command
-    //  (4) size
-    //  (4) checksum
-    //  (x) data
-    //
-    bool fMoreWork = false;
-
-    if (!pfrom->vRecvGetData.empty())
-        ProcessGetData(pfrom, chainparams, connman, interruptMsgProc);
-
-    if (pfrom->fDisconnect)
-        return false;
-
-    // this maintains the order of responses
-    if (!pfrom->vRecvGetData.empty()) return true;
-
-    // Don't bother if send buffer is too full to respond anyway
-    if (pfrom->fPauseSend)
-        return false;
-
-    std::list<CNetMessage> msgs;
-    {
-        LOCK(pfrom->cs_vProcessMsg);
-        if (pfrom->vProcessMsg.empty())
-            return false;
-        // Just take one message
-        msgs.splice(msgs.begin(), pfrom->vProcessMsg, pfrom->vProcessMsg.begin());
-        pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
-        pfrom->fPauseRecv = pfrom->nProcessQueueSize > connman->GetReceiveFloodSize();
-        fMoreWork = !pfrom->vProcessMsg.empty();
-    }
-    CNetMessage& msg(msgs.front());
-
-    msg.SetVersion(pfrom->GetRecvVersion());
     // Scan for message start
     if (memcmp(msg.hdr.pchMessageStart, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE) != 0) {
         LogPrint(BCLog::NET, "PROCESSMESSAGE: INVALID MESSAGESTART %s peer=%d\n", SanitizeString(msg.hdr.GetCommand()), pfrom->GetId());
@@ -3229,38 +3198,32 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     if (!hdr.IsValid(chainparams.MessageStart()))
     {
         LogPrint(BCLog::NET, "PROCESSMESSAGE: ERRORS IN HEADER %s peer=%d\n", SanitizeString(hdr.GetCommand()), pfrom->GetId());
-        return fMoreWork;
+        return false;
     }
-    std::string strCommand = hdr.GetCommand();
-
-    // Message size
-    unsigned int nMessageSize = hdr.nMessageSize;
 
     // Checksum
-    CDataStream& vRecv = msg.vRecv;
     const uint256& hash = msg.GetMessageHash();
     if (memcmp(hash.begin(), hdr.pchChecksum, CMessageHeader::CHECKSUM_SIZE) != 0)
     {
         LogPrint(BCLog::NET, "%s(%s, %u bytes): CHECKSUM ERROR expected %s was %s\n", __func__,
-           SanitizeString(strCommand), nMessageSize,
+           SanitizeString(hdr.GetCommand()), hdr.nMessageSize,
            HexStr(hash.begin(), hash.begin()+CMessageHeader::CHECKSUM_SIZE),
            HexStr(hdr.pchChecksum, hdr.pchChecksum+CMessageHeader::CHECKSUM_SIZE));
-        return fMoreWork;
+        return false;
     }
+    return true;
+}
 
-    // Process message
-    bool fRet = false;
+/** Run a message handler, logging (and for malformed messages rejecting) anything it throws */
+static bool ProcessMessageCatchExceptions(CNode* pfrom, const std::string& strCommand, unsigned int nMessageSize, CConnman* connman, bool enable_bip61, const std::function<bool()>& handler)
+{
     try
     {
-        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc, m_enable_bip61);
-        if (interruptMsgProc)
-            return false;
-        if (!pfrom->vRecvGetData.empty())
-            fMoreWork = true;
+        return handler();
     }
     catch (const std::ios_base::failure& e)
     {
-        if (m_enable_bip61) {
+        if (enable_bip61) {
             connman->PushMessage(pfrom, CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::REJECT, strCommand, REJECT_MALFORMED, std::string("error parsing message")));
         }
         if (strstr(e.what(), "end of data"))
@@ -3288,6 +3251,64 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     } catch (...) {
         PrintExceptionContinue(nullptr, "ProcessMessages()");
     }
+    return false;
+}
+
+bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
+{
+    const CChainParams& chainparams = Params();
+    //
+    // Message format
+    //  (4) message start
+    //  (12) command
+    //  (4) size
+    //  (4) checksum
+    //  (x) data
+    //
+    bool fMoreWork = false;
+
+    if (!pfrom->vRecvGetData.empty())
+        ProcessGetData(pfrom, chainparams, connman, interruptMsgProc);
+
+    if (pfrom->fDisconnect)
+        return false;
+
+    // this maintains the order of responses
+    if (!pfrom->vRecvGetData.empty()) return true;
+
+    // Don't bother if send buffer is too full to respond anyway
+    if (pfrom->fPauseSend)
+        return false;
+
+    std::list<CNetMessage> msgs;
+    {
+        LOCK(pfrom->cs_vProcessMsg);
+        if (pfrom->vProcessMsg.empty())
+            return false;
+        // Just take one message
+        msgs.splice(msgs.begin(), pfrom->vProcessMsg, pfrom->vProcessMsg.begin());
+        pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
+        pfrom->fPauseRecv = pfrom->nProcessQueueSize > connman->GetReceiveFloodSize();
+        fMoreWork = !pfrom->vProcessMsg.empty();
+    }
+    CNetMessage& msg(msgs.front());
+
+    msg.SetVersion(pfrom->GetRecvVersion());
+    if (!CheckNetMessage(pfrom, msg, chainparams))
+        return pfrom->fDisconnect ? false : fMoreWork;
+
+    std::string strCommand = msg.hdr.GetCommand();
+    unsigned int nMessageSize = msg.hdr.nMessageSize;
+    CDataStream& vRecv = msg.vRecv;
+
+    // Process message
+    bool fRet = ProcessMessageCatchExceptions(pfrom, strCommand, nMessageSize, connman, m_enable_bip61, [&]() {
+        return ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc, m_enable_bip61);
+    });
+    if (interruptMsgProc)
+        return false;
+    if (!pfrom->vRecvGetData.empty())
+        fMoreWork = true;
 
     if (!fRet) {
         LogPrint(BCLog::NET, "%s(%s, %u bytes) FAILED peer=%d\n", __func__, SanitizeString(strCommand), nMessageSize, pfrom->GetId());
@@ -3299,6 +3320,63 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     return fMoreWork;
 }
 
+// SYSCOIN
+bool PeerLogicValidation::ProcessSyscoinMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
+{
+    const CChainParams& chainparams = Params();
+    bool fMoreWork = false;
+
+    if (pfrom->fDisconnect)
+        return false;
+
+    // Don't bother if send buffer is too full to respond anyway
+    if (pfrom->fPauseSend)
+        return false;
+
+    std::list<CNetMessage> msgs;
+    {
+        LOCK(pfrom->cs_vProcessMsg);
+        if (pfrom->vProcessSyscoinMsg.empty())
+            return false;
+        // Just take one message
+        msgs.splice(msgs.begin(), pfrom->vProcessSyscoinMsg, pfrom->vProcessSyscoinMsg.begin());
+        pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
+        pfrom->fPauseRecv = pfrom->nProcessQueueSize > connman->GetReceiveFloodSize();
+        fMoreWork = !pfrom->vProcessSyscoinMsg.empty();
+    }
+    CNetMessage& msg(msgs.front());
+
+    msg.SetVersion(pfrom->GetRecvVersion());
+    if (!CheckNetMessage(pfrom, msg, chainparams))
+        return pfrom->fDisconnect ? false : fMoreWork;
+
+    std::string strCommand = msg.hdr.GetCommand();
+    unsigned int nMessageSize = msg.hdr.nMessageSize;
+    CDataStream& vRecv = msg.vRecv;
+    // Same gates as ProcessMessage applies to the messages it handles itself
+    if(!fGethSynced && !fLiteMode)
+        return fMoreWork;
+    LogPrint(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(strCommand), nMessageSize, pfrom->GetId());
+    if (gArgs.IsArgSet("-dropmessagestest") && GetRand(gArgs.GetArg("-dropmessagestest", 0)) == 0)
+    {
+        LogPrintf("dropmessagestest DROPPING RECV MESSAGE\n");
+        return fMoreWork;
+    }
+
+    ProcessMessageCatchExceptions(pfrom, strCommand, nMessageSize, connman, m_enable_bip61, [&]() {
+        ProcessSyscoinMessage(pfrom, strCommand, vRecv, connman);
+        return true;
+    });
+    if (interruptMsgProc)
+        return false;
+
+    // Handlers take cs_main themselves when they need it, only punishment is serialized here
+    LOCK(cs_main);
+    SendRejectsAndCheckIfBanned(pfrom, connman, m_enable_bip61);
+
+    return fMoreWork;
+}
+
 void PeerLogicValidation::ConsiderEviction(CNode *pto, int64_t time_in_seconds)
 {
     AssertLockHeld(cs_main);
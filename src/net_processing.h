@@ -59,6 +59,15 @@ public:
     * @return                      True if there is more work to be done
     */
     bool SendMessages(CNode* pto) override EXCLUSIVE_LOCKS_REQUIRED(pto->cs_sendProcessing);
+    /**
+    * SYSCOIN Process masternode, governance and spork messages queued on the separate
+    * message lane of a given node. Runs on the -syscoinmsgthreads workers.
+    *
+    * @param[in]   pfrom           The node which we have received messages from.
+    * @param[in]   interrupt       Interrupt condition for processing threads
+    * @return                      True if there is more work to be done
+    */
+    bool ProcessSyscoinMessages(CNode* pfrom, std::atomic<bool>& interrupt) override;
 
     /** Consider evicting an outbound peer based on the amount of time they've been behind our tip */
     void ConsiderEviction(CNode *pto, int64_t time_in_seconds);
@@ -14,6 +14,16 @@
 
 #include <memory>
 
+/** Stream version flag for reading blocks and headers without their auxpow.
+ * The auxpow is skipped and left unset even if IsAuxpow(); such a header must
+ * not be written out again or have its PoW checked. */
+static const int SERIALIZE_BLOCK_NO_AUXPOW = 0x20000000;
+
+template<typename Stream>
+inline void SkipAuxpow(Stream& s, CSerActionUnserialize) { CAuxPow::Skip(s); }
+template<typename Stream>
+inline void SkipAuxpow(Stream& s, CSerActionSerialize) { assert(!"auxpow cannot be skipped when writing"); }
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -41,6 +51,12 @@ public:
 
         if (this->IsAuxpow())
         {
+            // SYSCOIN
+            if (ser_action.ForRead() && (s.GetVersion() & SERIALIZE_BLOCK_NO_AUXPOW)) {
+                SkipAuxpow(s, ser_action);
+                auxpow.reset();
+                return;
+            }
             if (ser_action.ForRead())
                 auxpow = std::make_shared<CAuxPow>();
             assert(auxpow != nullptr);
@@ -88,7 +104,15 @@ public:
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
         READWRITEAS(CBlockHeader, *this);
-        READWRITE(vtx);
+        // SYSCOIN read the transactions first, so that their hashes are computed together
+        if (ser_action.ForRead()) {
+            std::vector<CMutableTransaction> txs;
+            READWRITE(txs);
+            vtx.clear();
+            MakeTransactionRefs(std::move(txs), vtx);
+        } else {
+            READWRITE(vtx);
+        }
     }
 
     void SetNull()
@@ -5,7 +5,9 @@
 
 #include <primitives/transaction.h>
 
+#include <crypto/sha256.h>
 #include <hash.h>
+#include <streams.h>
 #include <tinyformat.h>
 #include <utilstrencodings.h>
 // SYSCOIN
@@ -84,6 +86,49 @@ uint256 CTransaction::ComputeWitnessHash() const
 CTransaction::CTransaction() : vin(), vout(), nVersion(CTransaction::CURRENT_VERSION), nLockTime(0), hash{}, m_witness_hash{} {}
 CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), nVersion(tx.nVersion), nLockTime(tx.nLockTime), hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
 CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nLockTime(tx.nLockTime), hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx, const uint256& hashIn, const uint256& witnessHashIn) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nLockTime(tx.nLockTime), hash{hashIn}, m_witness_hash{witnessHashIn} {}
+
+void MakeTransactionRefs(std::vector<CMutableTransaction>&& txs, std::vector<CTransactionRef>& vtx)
+{
+    vtx.reserve(vtx.size() + txs.size());
+    if (txs.size() < 2) {
+        for (CMutableTransaction& tx : txs)
+            vtx.push_back(MakeTransactionRef(std::move(tx)));
+        return;
+    }
+    // Serialize every transaction without witness, and those that have one with
+    // it too, into one buffer; then hash all of them together
+    std::vector<unsigned char> data;
+    std::vector<size_t> offsets, lengths;
+    std::vector<int> witness_index(txs.size(), -1);
+    auto Append = [&](const CMutableTransaction& tx, int nVersion) {
+        const size_t offset = data.size();
+        CVectorWriter(SER_GETHASH, nVersion, data, offset, tx);
+        offsets.push_back(offset);
+        lengths.push_back(data.size() - offset);
+    };
+    for (const CMutableTransaction& tx : txs)
+        Append(tx, SERIALIZE_TRANSACTION_NO_WITNESS);
+    for (size_t i = 0; i < txs.size(); i++) {
+        if (txs[i].HasWitness()) {
+            witness_index[i] = offsets.size();
+            Append(txs[i], 0);
+        }
+    }
+    std::vector<const unsigned char*> inputs(offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++)
+        inputs[i] = data.data() + offsets[i];
+    std::vector<unsigned char> out(CSHA256::OUTPUT_SIZE * inputs.size());
+    SHA256DMulti(out.data(), inputs.data(), lengths.data(), inputs.size());
+    std::vector<uint256> hashes(inputs.size());
+    for (size_t i = 0; i < hashes.size(); i++)
+        memcpy(hashes[i].begin(), out.data() + CSHA256::OUTPUT_SIZE * i, CSHA256::OUTPUT_SIZE);
+
+    for (size_t i = 0; i < txs.size(); i++) {
+        const uint256& witness_hash = witness_index[i] < 0 ? hashes[i] : hashes[witness_index[i]];
+        vtx.push_back(CTransactionRef(new CTransaction(std::move(txs[i]), hashes[i], witness_hash)));
+    }
+}
 // SYSCOIN
 CTransaction& CTransaction::operator=(const CTransaction &tx) {
     *const_cast<int*>(&nVersion) = tx.nVersion;
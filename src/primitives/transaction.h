@@ -292,6 +292,10 @@ private:
     uint256 ComputeHash() const;
     uint256 ComputeWitnessHash() const;
 
+    /** Convert a CMutableTransaction whose hashes were computed already (see MakeTransactionRefs). */
+    CTransaction(CMutableTransaction&& tx, const uint256& hashIn, const uint256& witnessHashIn);
+    friend void MakeTransactionRefs(std::vector<CMutableTransaction>&& txs, std::vector<std::shared_ptr<const CTransaction>>& vtx);
+
 public:
     /** Construct a CTransaction that qualifies as IsNull() */
     CTransaction();
@@ -405,5 +409,9 @@ struct CMutableTransaction
 typedef std::shared_ptr<const CTransaction> CTransactionRef;
 static inline CTransactionRef MakeTransactionRef() { return std::make_shared<const CTransaction>(); }
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
+/** Convert many transactions at once, appending them to vtx. Their txids and
+ *  witness hashes are computed together (see SHA256DMulti), which is faster
+ *  than converting them one by one. */
+void MakeTransactionRefs(std::vector<CMutableTransaction>&& txs, std::vector<CTransactionRef>& vtx);
 
 #endif // SYSCOIN_PRIMITIVES_TRANSACTION_H
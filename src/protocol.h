@@ -259,6 +259,9 @@ extern const char *MNVERIFY;
 /* Get a vector of all valid message types (see above) */
 const std::vector<std::string> &getAllNetMessageTypes();
 
+/* SYSCOIN Whether a message type may be dispatched to the masternode/governance message lane */
+bool IsSyscoinLaneMessageType(const std::string& strCommand);
+
 /** nServices flags */
 enum ServiceFlags : uint64_t {
     // Nothing
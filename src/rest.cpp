@@ -13,6 +13,7 @@
 #include <httpserver.h>
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
+#include <rpc/util.h>
 #include <streams.h>
 #include <sync.h>
 #include <txmempool.h>
@@ -122,6 +123,22 @@ static bool CheckWarmup(HTTPRequest* req)
     return true;
 }
 
+/** Send a JSON reply that is produced incrementally as a chunked reply, so that
+ * large documents are never held in memory as a whole.
+ */
+static void WriteStreamedJSON(HTTPRequest* req, const std::function<void(JSONStreamWriter&)>& writeJSON)
+{
+    req->WriteHeader("Content-Type", "application/json");
+    req->StartChunkedReply(HTTP_OK);
+    JSONStreamWriter stream([req](const std::string& strChunk) {
+        req->WriteReplyChunk(strChunk);
+    });
+    writeJSON(stream);
+    stream.Flush();
+    req->WriteReplyChunk("\n");
+    req->EndChunkedReply();
+}
+
 static bool rest_headers(HTTPRequest* req,
                          const std::string& strURIPart)
 {
@@ -244,14 +261,10 @@ static bool rest_block(HTTPRequest* req,
     }
 
     case RetFormat::JSON: {
-        UniValue objBlock;
-        {
+        WriteStreamedJSON(req, [&block, pblockindex, showTxDetails](JSONStreamWriter& stream) {
             LOCK(cs_main);
-            objBlock = blockToJSON(block, pblockindex, showTxDetails);
-        }
-        std::string strJSON = objBlock.write() + "\n";
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+            blockToJSON(stream, block, pblockindex, showTxDetails);
+        });
         return true;
     }
 
@@ -328,11 +341,9 @@ static bool rest_mempool_contents(HTTPRequest* req, const std::string& strURIPar
 
     switch (rf) {
     case RetFormat::JSON: {
-        UniValue mempoolObject = mempoolToJSON(true);
-
-        std::string strJSON = mempoolObject.write() + "\n";
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        WriteStreamedJSON(req, [](JSONStreamWriter& stream) {
+            mempoolToJSON(stream, true);
+        });
         return true;
     }
     default: {
@@ -21,6 +21,7 @@
 #include <primitives/transaction.h>
 #include <rpc/rawtransaction.h>
 #include <rpc/server.h>
+#include <rpc/util.h>
 #include <script/descriptor.h>
 #include <streams.h>
 #include <sync.h>
@@ -147,10 +148,11 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     return result;
 }
 
-UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+/** Block fields that come before (head) and after (tail) the "tx" array */
+static void blockFieldsToJSON(const CBlock& block, const CBlockIndex* blockindex, UniValue& head, UniValue& tail)
 {
     AssertLockHeld(cs_main);
-    UniValue result(UniValue::VOBJ);
+    UniValue& result = head;
     result.pushKV("hash", blockindex->GetBlockHash().GetHex());
     int confirmations = -1;
     // Only report confirmations if the block is on the main chain
@@ -164,38 +166,65 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     result.pushKV("version", block.nVersion);
     result.pushKV("versionHex", strprintf("%08x", block.nVersion));
     result.pushKV("merkleroot", block.hashMerkleRoot.GetHex());
-    UniValue txs(UniValue::VARR);
-    for(const auto& tx : block.vtx)
-    {
-        if(txDetails)
-        {
-            UniValue objTx(UniValue::VOBJ);
-            TxToUniv(*tx, uint256(), objTx, true, RPCSerializationFlags());
-            txs.push_back(objTx);
-        }
-        else
-            txs.push_back(tx->GetHash().GetHex());
-    }
-    result.pushKV("tx", txs);
-    result.pushKV("time", block.GetBlockTime());
-    result.pushKV("mediantime", (int64_t)blockindex->GetMedianTimePast());
-    result.pushKV("nonce", (uint64_t)block.nNonce);
-    result.pushKV("bits", strprintf("%08x", block.nBits));
-    result.pushKV("difficulty", GetDifficulty(blockindex));
-    result.pushKV("chainwork", blockindex->nChainWork.GetHex());
-    result.pushKV("nTx", (uint64_t)blockindex->nTx);
+    tail.pushKV("time", block.GetBlockTime());
+    tail.pushKV("mediantime", (int64_t)blockindex->GetMedianTimePast());
+    tail.pushKV("nonce", (uint64_t)block.nNonce);
+    tail.pushKV("bits", strprintf("%08x", block.nBits));
+    tail.pushKV("difficulty", GetDifficulty(blockindex));
+    tail.pushKV("chainwork", blockindex->nChainWork.GetHex());
+    tail.pushKV("nTx", (uint64_t)blockindex->nTx);
 
     if (block.auxpow)
-        result.pushKV("auxpow", AuxpowToJSON(*block.auxpow));
+        tail.pushKV("auxpow", AuxpowToJSON(*block.auxpow));
 
     if (blockindex->pprev)
-        result.pushKV("previousblockhash", blockindex->pprev->GetBlockHash().GetHex());
+        tail.pushKV("previousblockhash", blockindex->pprev->GetBlockHash().GetHex());
     CBlockIndex *pnext = chainActive.Next(blockindex);
     if (pnext)
-        result.pushKV("nextblockhash", pnext->GetBlockHash().GetHex());
+        tail.pushKV("nextblockhash", pnext->GetBlockHash().GetHex());
+}
+
+static UniValue blockTxToJSON(const CTransaction& tx, bool txDetails)
+{
+    if (!txDetails)
+        return tx.GetHash().GetHex();
+    UniValue objTx(UniValue::VOBJ);
+    TxToUniv(tx, uint256(), objTx, true, RPCSerializationFlags());
+    return objTx;
+}
+
+UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+{
+    UniValue result(UniValue::VOBJ);
+    UniValue tail(UniValue::VOBJ);
+    blockFieldsToJSON(block, blockindex, result, tail);
+    UniValue txs(UniValue::VARR);
+    for(const auto& tx : block.vtx)
+        txs.push_back(blockTxToJSON(*tx, txDetails));
+    result.pushKV("tx", txs);
+    result.pushKVs(tail);
     return result;
 }
 
+void blockToJSON(JSONStreamWriter& stream, const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+{
+    UniValue head(UniValue::VOBJ);
+    UniValue tail(UniValue::VOBJ);
+    blockFieldsToJSON(block, blockindex, head, tail);
+    stream.BeginObject();
+    for (size_t i = 0; i < head.size(); i++)
+        stream.KeyValue(head.getKeys()[i], head.getValues()[i]);
+    // Only one transaction is held in memory at a time
+    stream.Key("tx");
+    stream.BeginArray();
+    for(const auto& tx : block.vtx)
+        stream.Value(blockTxToJSON(*tx, txDetails));
+    stream.EndArray();
+    for (size_t i = 0; i < tail.size(); i++)
+        stream.KeyValue(tail.getKeys()[i], tail.getValues()[i]);
+    stream.EndObject();
+}
+
 static UniValue getblockcount(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -499,6 +528,32 @@ UniValue mempoolToJSON(bool fVerbose)
     }
 }
 
+void mempoolToJSON(JSONStreamWriter& stream, bool fVerbose)
+{
+    if (fVerbose)
+    {
+        LOCK(mempool.cs);
+        stream.BeginObject();
+        for (const CTxMemPoolEntry& e : mempool.mapTx)
+        {
+            UniValue info(UniValue::VOBJ);
+            entryToJSON(info, e);
+            stream.KeyValue(e.GetTx().GetHash().ToString(), info);
+        }
+        stream.EndObject();
+    }
+    else
+    {
+        std::vector<uint256> vtxid;
+        mempool.queryHashes(vtxid);
+
+        stream.BeginArray();
+        for (const uint256& hash : vtxid)
+            stream.Value(hash.ToString());
+        stream.EndArray();
+    }
+}
+
 static UniValue getrawmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 1)
@@ -528,6 +583,10 @@ static UniValue getrawmempool(const JSONRPCRequest& request)
     if (!request.params[0].isNull())
         fVerbose = request.params[0].get_bool();
 
+    if (request.stream) {
+        mempoolToJSON(*request.stream, fVerbose);
+        return NullUniValue;
+    }
     return mempoolToJSON(fVerbose);
 }
 
@@ -875,6 +934,10 @@ static UniValue getblock(const JSONRPCRequest& request)
         return strHex;
     }
 
+    if (request.stream) {
+        blockToJSON(*request.stream, block, pblockindex, verbosity >= 2);
+        return NullUniValue;
+    }
     return blockToJSON(block, pblockindex, verbosity >= 2);
 }
 
@@ -11,6 +11,7 @@
 
 class CBlock;
 class CBlockIndex;
+class JSONStreamWriter;
 class UniValue;
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
@@ -29,12 +30,16 @@ void RPCNotifyBlockChange(bool ibd, const CBlockIndex *);
 
 /** Block description to JSON */
 UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false);
+/** Block description written to a JSON stream, one transaction at a time */
+void blockToJSON(JSONStreamWriter& stream, const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false);
 
 /** Mempool information to JSON */
 UniValue mempoolInfoToJSON();
 
 /** Mempool to JSON */
 UniValue mempoolToJSON(bool fVerbose = false);
+/** Mempool written to a JSON stream, one entry at a time */
+void mempoolToJSON(JSONStreamWriter& stream, bool fVerbose = false);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* blockindex);
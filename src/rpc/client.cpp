@@ -182,6 +182,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "syscointxfund", 2, "output_index" },
     { "assetallocationsend", 0, "asset" },
     { "assetallocationsend", 2, "inputs" },
+    { "assetallocationsendbatch", 0, "jobs" },
+    { "assetallocationsendbatch", 2, "broadcast" },
     { "assetallocationburn", 0, "asset" },
     { "assetallocationburn", 2, "amount" },
     { "assetallocationmint", 0, "asset" },
@@ -476,6 +476,58 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     }
 }
 
+static UniValue getrpcworkqueueinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getrpcworkqueueinfo\n"
+            "Returns queue depth and latency statistics for every RPC work class (see -rpcworkclass).\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"name\": \"xxxx\",            (string) Name of the work class, \"default\" for methods without a class\n"
+            "    \"threads\": n,               (numeric) Number of worker threads\n"
+            "    \"methods\": [ \"xxxx\", ... ], (array) Methods dispatched to this class\n"
+            "    \"depth\": n,                 (numeric) Number of queued requests\n"
+            "    \"max_depth\": n,             (numeric) Maximum number of queued requests\n"
+            "    \"peak_depth\": n,            (numeric) Highest number of queued requests seen\n"
+            "    \"processed\": n,             (numeric) Number of requests handled\n"
+            "    \"rejected\": n,              (numeric) Number of requests rejected because the queue was full\n"
+            "    \"avg_wait_us\": n,           (numeric) Average time a request waited in the queue, in microseconds\n"
+            "    \"max_wait_us\": n,           (numeric) Longest time a request waited in the queue, in microseconds\n"
+            "    \"avg_run_us\": n,            (numeric) Average time spent handling a request, in microseconds\n"
+            "    \"max_run_us\": n             (numeric) Longest time spent handling a request, in microseconds\n"
+            "  },\n"
+            "  ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getrpcworkqueueinfo", "")
+            + HelpExampleRpc("getrpcworkqueueinfo", "")
+        );
+
+    UniValue ret(UniValue::VARR);
+    for (const HTTPWorkQueueStats& stats : GetHTTPWorkQueueStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("name", stats.name);
+        obj.pushKV("threads", stats.threads);
+        UniValue methods(UniValue::VARR);
+        for (const std::string& method : stats.methods)
+            methods.push_back(method);
+        obj.pushKV("methods", methods);
+        obj.pushKV("depth", (uint64_t)stats.depth);
+        obj.pushKV("max_depth", (uint64_t)stats.max_depth);
+        obj.pushKV("peak_depth", (uint64_t)stats.peak_depth);
+        obj.pushKV("processed", stats.processed);
+        obj.pushKV("rejected", stats.rejected);
+        obj.pushKV("avg_wait_us", stats.processed > 0 ? stats.total_wait_us / stats.processed : 0);
+        obj.pushKV("max_wait_us", stats.max_wait_us);
+        obj.pushKV("avg_run_us", stats.processed > 0 ? stats.total_run_us / stats.processed : 0);
+        obj.pushKV("max_run_us", stats.max_run_us);
+        ret.push_back(obj);
+    }
+    return ret;
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -592,6 +644,7 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
+    { "control",            "getrpcworkqueueinfo",    &getrpcworkqueueinfo,    {} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
     { "util",               "validateaddress",        &validateaddress,        {"address"} }, /* uses wallet if enabled */
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys","address_type"} },
@@ -20,6 +20,7 @@
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
 
 class CRPCCommand;
+class JSONStreamWriter;
 
 namespace RPCServer
 {
@@ -46,8 +47,11 @@ public:
     std::string URI;
     std::string authUser;
     std::string peerAddr;
+    /** Set when the transport can stream the result. A handler that writes its result
+     * here (see RPCResultArray) returns null instead of building the whole UniValue. */
+    JSONStreamWriter* stream;
 
-    JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false) {}
+    JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false), stream(nullptr) {}
     void parse(const UniValue& valRequest);
 };
 
@@ -5,6 +5,7 @@
 #include <key_io.h>
 #include <keystore.h>
 #include <rpc/protocol.h>
+#include <rpc/server.h>
 #include <rpc/util.h>
 #include <tinyformat.h>
 #include <utilstrencodings.h>
@@ -126,3 +127,113 @@ UniValue DescribeAddress(const CTxDestination& dest)
 {
     return boost::apply_visitor(DescribeAddressVisitor(), dest);
 }
+
+JSONStreamWriter::JSONStreamWriter(const Sink& _sink, size_t _nFlushSize) :
+    sink(_sink), nFlushSize(_nFlushSize), fAfterKey(false), fStarted(false), fFlushed(false)
+{
+}
+
+void JSONStreamWriter::Write(const std::string& str)
+{
+    fStarted = true;
+    strBuffer += str;
+    if (strBuffer.size() >= nFlushSize)
+        Flush();
+}
+
+void JSONStreamWriter::BeginElement()
+{
+    if (fAfterKey) {
+        fAfterKey = false;
+        return;
+    }
+    if (vFirstElement.empty())
+        return;
+    if (!vFirstElement.back())
+        strBuffer += ',';
+    vFirstElement.back() = false;
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    BeginElement();
+    vFirstElement.push_back(true);
+    Write("{");
+}
+
+void JSONStreamWriter::EndObject()
+{
+    assert(!vFirstElement.empty() && !fAfterKey);
+    vFirstElement.pop_back();
+    Write("}");
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    BeginElement();
+    vFirstElement.push_back(true);
+    Write("[");
+}
+
+void JSONStreamWriter::EndArray()
+{
+    assert(!vFirstElement.empty() && !fAfterKey);
+    vFirstElement.pop_back();
+    Write("]");
+}
+
+void JSONStreamWriter::Key(const std::string& key)
+{
+    assert(!fAfterKey);
+    BeginElement();
+    // UniValue takes care of escaping
+    Write(UniValue(key).write() + ":");
+    fAfterKey = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    BeginElement();
+    Write(value.write());
+}
+
+void JSONStreamWriter::Flush()
+{
+    if (strBuffer.empty())
+        return;
+    fFlushed = true;
+    sink(strBuffer);
+    strBuffer.clear();
+}
+
+void JSONStreamWriter::Discard()
+{
+    assert(!fFlushed);
+    strBuffer.clear();
+    vFirstElement.clear();
+    fAfterKey = false;
+    fStarted = false;
+}
+
+RPCResultArray::RPCResultArray(const JSONRPCRequest& request) : stream(request.stream), array(UniValue::VARR)
+{
+    if (stream)
+        stream->BeginArray();
+}
+
+void RPCResultArray::push_back(const UniValue& value)
+{
+    if (stream)
+        stream->Value(value);
+    else
+        array.push_back(value);
+}
+
+UniValue RPCResultArray::get()
+{
+    if (stream) {
+        stream->EndArray();
+        return NullUniValue;
+    }
+    return array;
+}
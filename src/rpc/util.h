@@ -11,12 +11,17 @@
 
 #include <boost/variant/static_visitor.hpp>
 
+#include <functional>
 #include <string>
 #include <vector>
 
 class CKeyStore;
 class CPubKey;
 class CScript;
+class JSONRPCRequest;
+
+/** Size of buffered JSON output after which JSONStreamWriter hands it to its sink */
+static const size_t JSON_STREAM_FLUSH_SIZE = 64 * 1024;
 
 CPubKey HexToPubKey(const std::string& hex_in);
 CPubKey AddrToPubKey(CKeyStore* const keystore, const std::string& addr_in);
@@ -24,4 +29,71 @@ CScript CreateMultisigRedeemscript(const int required, const std::vector<CPubKey
 
 UniValue DescribeAddress(const CTxDestination& dest);
 
+/**
+ * Incremental JSON writer. Large results are emitted piece by piece, with only
+ * the current element held as a UniValue, and are handed to the sink in chunks
+ * of about nFlushSize bytes. Commas between elements are inserted automatically.
+ */
+class JSONStreamWriter
+{
+public:
+    typedef std::function<void(const std::string&)> Sink;
+
+    explicit JSONStreamWriter(const Sink& sink, size_t nFlushSize = JSON_STREAM_FLUSH_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    /** Write the key of the next object member */
+    void Key(const std::string& key);
+    /** Write a complete value (array element or, after Key, object member) */
+    void Value(const UniValue& value);
+    void KeyValue(const std::string& key, const UniValue& value)
+    {
+        Key(key);
+        Value(value);
+    }
+    /** Hand all buffered output to the sink */
+    void Flush();
+    /** Drop output that has not been handed to the sink yet */
+    void Discard();
+
+    /** Whether anything has been written */
+    bool Started() const { return fStarted; }
+    /** Whether output has already been handed to the sink, i.e. can no longer be discarded */
+    bool Flushed() const { return fFlushed; }
+
+private:
+    Sink sink;
+    const size_t nFlushSize;
+    std::string strBuffer;
+    /** One entry per open object/array, true until its first element is written */
+    std::vector<bool> vFirstElement;
+    bool fAfterKey;
+    bool fStarted;
+    bool fFlushed;
+
+    void BeginElement();
+    void Write(const std::string& str);
+};
+
+/**
+ * Array result of an RPC call. Elements are streamed to the client when the
+ * request carries a JSONStreamWriter, otherwise they are collected in a UniValue.
+ */
+class RPCResultArray
+{
+public:
+    explicit RPCResultArray(const JSONRPCRequest& request);
+
+    void push_back(const UniValue& value);
+    /** Finish the array and return it, or null if it has been streamed */
+    UniValue get();
+
+private:
+    JSONStreamWriter* stream;
+    UniValue array;
+};
+
 #endif // SYSCOIN_RPC_UTIL_H
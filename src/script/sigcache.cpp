@@ -12,7 +12,6 @@
 #include <util.h>
 
 #include <cuckoocache.h>
-#include <boost/thread.hpp>
 
 namespace {
 /**
@@ -25,9 +24,9 @@ class CSignatureCache
 private:
      //! Entries are SHA256(nonce || signature hash || public key || signature):
     uint256 nonce;
-    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    // SYSCOIN the script check threads share the cache, so it locks per shard
+    typedef CuckooCache::sharded_cache<uint256, SignatureCacheHasher> map_type;
     map_type setValid;
-    boost::shared_mutex cs_sigcache;
 
 public:
     CSignatureCache()
@@ -44,13 +43,11 @@ public:
     bool
     Get(const uint256& entry, const bool erase)
     {
-        boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
         return setValid.contains(entry, erase);
     }
 
     void Set(uint256& entry)
     {
-        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
         setValid.insert(entry);
     }
     uint32_t setup_bytes(size_t n)
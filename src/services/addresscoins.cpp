@@ -0,0 +1,179 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <services/addresscoins.h>
+
+#include <primitives/block.h>
+
+std::unique_ptr<CAddressCoinCache> paddresscoincache;
+
+void CAddressCoinCache::SpendCoin(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs);
+    mapReserved.erase(outpoint);
+    auto it = mapCoinOwner.find(outpoint);
+    if (it == mapCoinOwner.end())
+        return;
+    auto itAddress = mapAddresses.find(it->second);
+    if (itAddress != mapAddresses.end())
+        itAddress->second.mapCoins.erase(outpoint);
+    mapCoinOwner.erase(it);
+}
+
+void CAddressCoinCache::EvictAddress()
+{
+    AssertLockHeld(cs);
+    auto itOldest = mapAddresses.begin();
+    for (auto it = mapAddresses.begin(); it != mapAddresses.end(); ++it) {
+        if (it->second.nLastUse < itOldest->second.nLastUse)
+            itOldest = it;
+    }
+    for (const auto& coin : itOldest->second.mapCoins)
+        mapCoinOwner.erase(coin.first);
+    mapAddresses.erase(itOldest);
+}
+
+bool CAddressCoinCache::GetCoins(const CScript& scriptPubKey, std::vector<AddressCoin>& vCoins)
+{
+    LOCK(cs);
+    auto it = mapAddresses.find(scriptPubKey);
+    if (it == mapAddresses.end())
+        return false;
+    it->second.nLastUse = ++nUseCounter;
+    vCoins.assign(it->second.mapCoins.begin(), it->second.mapCoins.end());
+    return true;
+}
+
+void CAddressCoinCache::BeginAddress(const CScript& scriptPubKey)
+{
+    LOCK(cs);
+    mapPending.emplace(scriptPubKey, PendingAddress());
+}
+
+void CAddressCoinCache::AddAddress(const CScript& scriptPubKey, const std::vector<AddressCoin>& vCoins)
+{
+    LOCK(cs);
+    PendingAddress pending;
+    auto itPending = mapPending.find(scriptPubKey);
+    if (itPending != mapPending.end()) {
+        pending = std::move(itPending->second);
+        mapPending.erase(itPending);
+        if (pending.fAbandoned)
+            return;
+    }
+    auto it = mapAddresses.find(scriptPubKey);
+    if (it == mapAddresses.end()) {
+        if (mapAddresses.size() >= MAX_FUNDING_ADDRESSES)
+            EvictAddress();
+        it = mapAddresses.emplace(scriptPubKey, AddressEntry()).first;
+    }
+    it->second.nLastUse = ++nUseCounter;
+    for (const AddressCoin& coin : vCoins) {
+        it->second.mapCoins[coin.first] = coin.second;
+        mapCoinOwner[coin.first] = scriptPubKey;
+    }
+    // Blocks the scan may or may not have seen; replaying them over it is harmless
+    for (const auto& coin : pending.mapAdded) {
+        it->second.mapCoins[coin.first] = coin.second;
+        mapCoinOwner[coin.first] = scriptPubKey;
+    }
+    for (const COutPoint& outpoint : pending.setSpent)
+        SpendCoin(outpoint);
+}
+
+void CAddressCoinCache::AbandonAddress(const CScript& scriptPubKey)
+{
+    LOCK(cs);
+    mapPending.erase(scriptPubKey);
+}
+
+void CAddressCoinCache::Spend(const COutPoint& outpoint)
+{
+    LOCK(cs);
+    SpendCoin(outpoint);
+}
+
+void CAddressCoinCache::Reserve(const std::vector<COutPoint>& vOutpoints, int64_t nNow)
+{
+    LOCK(cs);
+    // Drop reservations whose transaction never showed up
+    for (auto it = mapReserved.begin(); it != mapReserved.end();) {
+        if (it->second <= nNow)
+            it = mapReserved.erase(it);
+        else
+            ++it;
+    }
+    for (const COutPoint& outpoint : vOutpoints)
+        mapReserved[outpoint] = nNow + FUNDING_RESERVATION_SECONDS;
+}
+
+bool CAddressCoinCache::IsReserved(const COutPoint& outpoint, int64_t nNow) const
+{
+    LOCK(cs);
+    auto it = mapReserved.find(outpoint);
+    return it != mapReserved.end() && it->second > nNow;
+}
+
+void CAddressCoinCache::Clear()
+{
+    LOCK(cs);
+    mapAddresses.clear();
+    mapCoinOwner.clear();
+    for (auto& pending : mapPending)
+        pending.second.fAbandoned = true;
+}
+
+size_t CAddressCoinCache::AddressCount() const
+{
+    LOCK(cs);
+    return mapAddresses.size();
+}
+
+void CAddressCoinCache::TransactionAddedToMempool(const CTransactionRef& ptx)
+{
+    LOCK(cs);
+    // The mempool guards the spent coins from here on
+    for (const CTxIn& txin : ptx->vin)
+        mapReserved.erase(txin.prevout);
+}
+
+void CAddressCoinCache::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted)
+{
+    LOCK(cs);
+    if (mapAddresses.empty() && mapReserved.empty() && mapPending.empty())
+        return;
+    for (const CTransactionRef& ptx : block->vtx) {
+        if (!ptx->IsCoinBase()) {
+            for (const CTxIn& txin : ptx->vin) {
+                SpendCoin(txin.prevout);
+                for (auto& pending : mapPending) {
+                    pending.second.mapAdded.erase(txin.prevout);
+                    pending.second.setSpent.insert(txin.prevout);
+                }
+            }
+        }
+        for (size_t n = 0; n < ptx->vout.size(); n++) {
+            const CTxOut& txout = ptx->vout[n];
+            auto itPending = mapPending.find(txout.scriptPubKey);
+            if (itPending != mapPending.end())
+                itPending->second.mapAdded[COutPoint(ptx->GetHash(), n)] = txout.nValue;
+            auto it = mapAddresses.find(txout.scriptPubKey);
+            if (it == mapAddresses.end())
+                continue;
+            const COutPoint outpoint(ptx->GetHash(), n);
+            it->second.mapCoins[outpoint] = txout.nValue;
+            mapCoinOwner[outpoint] = txout.scriptPubKey;
+        }
+    }
+}
+
+void CAddressCoinCache::BlockDisconnected(const std::shared_ptr<const CBlock>& block)
+{
+    LOCK(cs);
+    // The outputs the block spent come back, but which addresses they belong to is not known here
+    mapAddresses.clear();
+    mapCoinOwner.clear();
+    for (auto& pending : mapPending)
+        pending.second.fAbandoned = true;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_SERVICES_ADDRESSCOINS_H
+#define SYSCOIN_SERVICES_ADDRESSCOINS_H
+
+#include <amount.h>
+#include <coins.h>
+#include <script/script.h>
+#include <sync.h>
+#include <validationinterface.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** Number of addresses whose coins are kept by CAddressCoinCache */
+static const unsigned int MAX_FUNDING_ADDRESSES = 128;
+/** Seconds a coin handed out by syscointxfund stays reserved unless its spend shows up earlier */
+static const int64_t FUNDING_RESERVATION_SECONDS = 60;
+
+/**
+ * Unspent outputs of the addresses syscointxfund funds from.
+ *
+ * The coins of an address are loaded with one UTXO set scan the first time
+ * it is asked for, and then kept up to date from validation events: outputs
+ * to a known address are added as blocks connect, and spent outputs are
+ * dropped. A disconnected block forgets everything, as the outputs it spent
+ * are not known here; the next request scans again. Events are delivered on a
+ * background thread and may lag behind the chain, so callers still check a
+ * coin against the UTXO set before spending it, and report coins found spent
+ * with Spend(). Blocks connected while an address is being scanned are
+ * recorded from BeginAddress() on and applied over the scan by AddAddress().
+ *
+ * Coins handed out by a funding call are reserved for a short while, so that
+ * concurrent callers do not pick the same coins before the first transaction
+ * reaches the mempool. A reservation ends when it expires or when a
+ * transaction spending the coin enters the mempool or a block.
+ */
+class CAddressCoinCache : public CValidationInterface
+{
+public:
+    typedef std::pair<COutPoint, CAmount> AddressCoin;
+
+private:
+    struct AddressEntry {
+        std::map<COutPoint, CAmount> mapCoins;
+        int64_t nLastUse;
+    };
+    //! Block changes seen while an address is being scanned
+    struct PendingAddress {
+        std::map<COutPoint, CAmount> mapAdded;
+        std::set<COutPoint> setSpent;
+        //! A block was disconnected, so the scan may not match the chain any more
+        bool fAbandoned = false;
+    };
+
+    mutable CCriticalSection cs;
+    std::map<CScript, AddressEntry> mapAddresses;
+    std::map<CScript, PendingAddress> mapPending;
+    //! Address every cached coin belongs to
+    std::unordered_map<COutPoint, CScript, SaltedOutpointHasher> mapCoinOwner;
+    //! Reserved coins and when their reservation ends
+    std::unordered_map<COutPoint, int64_t, SaltedOutpointHasher> mapReserved;
+    int64_t nUseCounter;
+
+    void SpendCoin(const COutPoint& outpoint);
+    void EvictAddress();
+
+public:
+    CAddressCoinCache() : nUseCounter(0) {}
+    virtual ~CAddressCoinCache() = default;
+
+    /** Coins of an address, ordered by outpoint. Returns false if the address is not loaded. */
+    bool GetCoins(const CScript& scriptPubKey, std::vector<AddressCoin>& vCoins);
+    /** Start recording the blocks that connect while the UTXO set is scanned for an address. */
+    void BeginAddress(const CScript& scriptPubKey);
+    /** Load the coins of an address as found by a scan of the UTXO set, together with the
+     *  changes recorded since BeginAddress(). Nothing is loaded if a block was disconnected
+     *  in the meantime. */
+    void AddAddress(const CScript& scriptPubKey, const std::vector<AddressCoin>& vCoins);
+    /** Stop recording for an address whose scan failed. */
+    void AbandonAddress(const CScript& scriptPubKey);
+    /** Forget a coin that turned out to be spent. */
+    void Spend(const COutPoint& outpoint);
+
+    /** Reserve coins for FUNDING_RESERVATION_SECONDS from nNow (unix time). */
+    void Reserve(const std::vector<COutPoint>& vOutpoints, int64_t nNow);
+    /** Whether a coin is reserved at time nNow. */
+    bool IsReserved(const COutPoint& outpoint, int64_t nNow) const;
+
+    void Clear();
+    size_t AddressCount() const;
+
+protected:
+    // CValidationInterface
+    void TransactionAddedToMempool(const CTransactionRef& ptx) override;
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block) override;
+};
+
+extern std::unique_ptr<CAddressCoinCache> paddresscoincache;
+
+#endif // SYSCOIN_SERVICES_ADDRESSCOINS_H
@@ -4,6 +4,7 @@
 
 #include "services/asset.h"
 #include "services/assetallocation.h"
+#include "services/addresscoins.h"
 #include "init.h"
 #include "validation.h"
 #include "util.h"
@@ -28,6 +29,8 @@ extern ArrivalTimesMapImpl arrivalTimesMap;
 unsigned int MAX_UPDATES_PER_BLOCK = 2;
 std::unique_ptr<CAssetDB> passetdb;
 std::unique_ptr<CAssetAllocationDB> passetallocationdb;
+std::unique_ptr<CAssetCache> passetcache;
+std::unique_ptr<CAssetAllocationCache> passetallocationcache;
 std::unique_ptr<CAssetAllocationTransactionsDB> passetallocationtransactionsdb;
 std::unique_ptr<CAssetAllocationMempoolDB> passetallocationmempooldb;
 std::unique_ptr<CEthereumTxRootsDB> pethereumtxrootsdb;
@@ -75,6 +78,60 @@ CAmount getaddressbalance(const string& strAddress)
     UniValue resUTXOs = scantxoutset(request);
     return AmountFromValue(find_value(resUTXOs.get_obj(), "total_amount"));
 }
+/** Unspent outputs of an address. They come from the address coin cache, which is filled
+ *  with a scan of the UTXO set the first time an address is asked for. */
+static void GetAddressCoins(const string& strAddress, vector<CAddressCoinCache::AddressCoin>& vecCoins)
+{
+    const CScript& scriptPubKey = GetScriptForDestination(DecodeDestination(strAddress));
+    if (paddresscoincache && paddresscoincache->GetCoins(scriptPubKey, vecCoins))
+        return;
+    UniValue paramsUTXO(UniValue::VARR);
+    UniValue utxoParams(UniValue::VARR);
+    utxoParams.push_back("addr(" + strAddress + ")");
+    paramsUTXO.push_back("start");
+    paramsUTXO.push_back(utxoParams);
+    JSONRPCRequest request;
+    request.params = paramsUTXO;
+    // Blocks connecting during the scan are recorded by the cache and applied on top of it
+    if (paddresscoincache)
+        paddresscoincache->BeginAddress(scriptPubKey);
+    UniValue resUTXOs;
+    try {
+        resUTXOs = scantxoutset(request);
+    } catch (...) {
+        if (paddresscoincache)
+            paddresscoincache->AbandonAddress(scriptPubKey);
+        throw;
+    }
+    if (paddresscoincache && (!resUTXOs.isObject() || !find_value(resUTXOs.get_obj(), "unspents").isArray()))
+        paddresscoincache->AbandonAddress(scriptPubKey);
+    if (!resUTXOs.isObject())
+        throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5501 - " + _("No funds found in addresses provided"));
+    const UniValue& resUtxoUnspents = find_value(resUTXOs.get_obj(), "unspents");
+    if (!resUtxoUnspents.isArray())
+        throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5501 - " + _("No unspent outputs found in addresses provided"));
+    const UniValue& utxoArray = resUtxoUnspents.get_array();
+    vecCoins.clear();
+    vecCoins.reserve(utxoArray.size());
+    for (unsigned int i = 0; i < utxoArray.size(); i++) {
+        const UniValue& utxoObj = utxoArray[i].get_obj();
+        const uint256& txid = uint256S(find_value(utxoObj, "txid").get_str());
+        const int& nOut = find_value(utxoObj, "vout").get_int();
+        vecCoins.emplace_back(COutPoint(txid, nOut), AmountFromValue(find_value(utxoObj, "amount")));
+    }
+    if (paddresscoincache)
+        paddresscoincache->AddAddress(scriptPubKey, vecCoins);
+}
+/** IsOutpointMature() for a coin of the address coin cache, which forgets the coin if it
+ *  turns out to be spent already (the cache hears about blocks with a delay). */
+static bool IsAddressCoinMature(const COutPoint& outpoint)
+{
+    if (IsOutpointMature(outpoint))
+        return true;
+    if (paddresscoincache && GetUTXOHeight(outpoint) < 0)
+        paddresscoincache->Spend(outpoint);
+    return false;
+}
 string stringFromValue(const UniValue& value) {
 	string strName = value.get_str();
 	return strName;
@@ -244,19 +301,14 @@ bool FlushSyscoinDBs() {
 	return ret;
 }
 void CTxMemPool::removeExpiredMempoolBalances(setEntries& stage){ 
-    vector<vector<unsigned char> > vvch;
-    int op;
-    char type;
     int count = 0;
     for (const txiter& it : stage) {
-        const CTransaction& tx = it->GetTx();
-        if(tx.nVersion == SYSCOIN_TX_VERSION_ASSET && DecodeAndParseAssetAllocationTx(tx, op, vvch, type)){
-            CAssetAllocation allocation(tx);
-            if(allocation.assetAllocationTuple.IsNull())
-                continue;
-            if(ResetAssetAllocation(allocation.assetAllocationTuple.ToString(), tx.GetHash())){
-                count++;
-            }
+        // only asset allocation sends are in the arrival index, along with their sender
+        indexed_arrival_set::const_iterator arrival = mapAssetAllocationArrivals.find(it->GetTx().GetHash());
+        if(arrival == mapAssetAllocationArrivals.end())
+            continue;
+        if(ResetAssetAllocation(arrival->strSender, arrival->txHash)){
+            count++;
         }
     }
     if(count > 0)
@@ -485,45 +537,35 @@ public:
 	template<typename X>
 	void operator()(const X &none) {}
 };
-UniValue syscointxfund(const JSONRPCRequest& request) {
-	std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
-	CWallet* const pwallet = wallet.get();
-	const UniValue &params = request.params;
-	if (request.fHelp || 1 > params.size() || 3 < params.size())
-		throw runtime_error(
-			"syscointxfund\n"
-			"\nFunds a new syscoin transaction with inputs used from wallet or an array of addresses specified.\n"
-			"\nArguments:\n"
-			"  \"hexstring\" (string, required) The raw syscoin transaction output given from rpc (ie: assetnew, assetupdate)\n"
-			"  \"address\"  (string, required) Address belonging to this asset transaction. \n"
-			"  \"output_index\"  (number, optional) Output index from available UTXOs in address. Defaults to selecting all that are needed to fund the transaction. \n"
-			"\nExamples:\n"
-			+ HelpExampleCli("syscointxfund", " <hexstring> \"175tWpb8K1S7NmH4Zx6rewF9WQrcZv245W\"")
-			+ HelpExampleCli("syscointxfund", " <hexstring> \"175tWpb8K1S7NmH4Zx6rewF9WQrcZv245W\" 0")
-			+ HelpRequiringPassphrase(pwallet));
-
-	const string &hexstring = params[0].get_str();
-    const string &strAddress = params[1].get_str();
-	CMutableTransaction tx;
-    // decode as non-witness
-	if (!DecodeHexTx(tx, hexstring, true, false))
-		throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5500 - " + _("Could not send raw transaction: Cannot decode transaction from hex string: ") + hexstring);
-
-	UniValue addressArray(UniValue::VARR);	
-	int output_index = -1;
-    if (params.size() > 2) {
-        output_index = params[2].get_int();
+/** Whether a coin of the address may fund a transaction: it was not picked before, no
+ *  mempool transaction spends it and no other funding call reserved it. */
+static bool IsFundingCoinAvailable(CWallet* const pwallet, const CFundingCoins& coins, const COutPoint& outPoint, const int64_t nNow)
+{
+    if (coins.setSpent.count(outPoint))
+        return false;
+    // outputs of transactions funded earlier in the same series are not in the chain or the mempool yet
+    if (coins.setUnconfirmed.count(outPoint))
+        return true;
+    if (mempool.mapNextTx.find(outPoint) != mempool.mapNextTx.end())
+        return false;
+    if (paddresscoincache && paddresscoincache->IsReserved(outPoint, nNow))
+        return false;
+    {
+        LOCK(pwallet->cs_wallet);
+        if (pwallet->IsLockedCoin(outPoint.hash, outPoint.n))
+            return false;
     }
- 
+    return IsAddressCoinMature(outPoint);
+}
+int FundSyscoinTransaction(CWallet* const pwallet, CMutableTransaction& tx, const string& strAddress, const int output_index, CFundingCoins& coins, vector<COutPoint>& vecReserve)
+{
     CRecipient addressRecipient;
     CScript scriptPubKeyFromOrig = GetScriptForDestination(DecodeDestination(strAddress));
     CreateAssetRecipient(scriptPubKeyFromOrig, addressRecipient);  
-    addressArray.push_back("addr(" + strAddress + ")"); 
-    
     
-    CTransaction txIn_t(tx);    
- 
     
+    CTransaction txIn_t(tx);
+
     // add total output amount of transaction to desired amount
     CAmount nDesiredAmount = txIn_t.GetValueOut();
     CAmount nCurrentAmount = 0;
@@ -550,61 +592,39 @@ UniValue syscointxfund(const JSONRPCRequest& request) {
     }
     
     
-	UniValue paramsBalance(UniValue::VARR);
-	paramsBalance.push_back("start");
-	paramsBalance.push_back(addressArray);
-	JSONRPCRequest request1;
-	request1.params = paramsBalance;
-
-	UniValue resUTXOs = scantxoutset(request1);
-	UniValue utxoArray(UniValue::VARR);
-	if (resUTXOs.isObject()) {
-		const UniValue& resUtxoUnspents = find_value(resUTXOs.get_obj(), "unspents");
-		if (!resUtxoUnspents.isArray())
-			throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5501 - " + _("No unspent outputs found in addresses provided"));
-		utxoArray = resUtxoUnspents.get_array();
-	}
-	else
-		throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5501 - " + _("No funds found in addresses provided"));
+    if (!coins.fLoaded) {
+        GetAddressCoins(strAddress, coins.vecCoins);
+        coins.fLoaded = true;
+    }
+    const vector<CAddressCoinCache::AddressCoin>& vecCoins = coins.vecCoins;
+    // coins handed out by other calls whose transactions are not in the mempool yet are left alone
+    const int64_t nNow = GetTime();
+    vector<COutPoint> vecPicked;
 
     const CAmount &minFee = GetFee(3000);
     if (nCurrentAmount < (nDesiredAmount + nFees)) {
         // only look for small inputs if addresses were passed in, if looking through wallet we do not want to fund via small inputs as we may end up spending small inputs inadvertently
-        if ((tx.nVersion == SYSCOIN_TX_VERSION_ASSET ||  tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN ||  tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET) && params.size() > 1) {
+        if (tx.nVersion == SYSCOIN_TX_VERSION_ASSET ||  tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN ||  tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET) {
             LOCK(mempool.cs);
             int countInputs = 0;
             // fund with small inputs first
-            for (unsigned int i = 0; i < utxoArray.size(); i++)
+            for (unsigned int i = 0; i < vecCoins.size(); i++)
             {
-                bool bOutputIndex = i == output_index || output_index < 0;
-                const UniValue& utxoObj = utxoArray[i].get_obj();
-                const string &strTxid = find_value(utxoObj, "txid").get_str();
-                const uint256& txid = uint256S(strTxid);
-                const int& nOut = find_value(utxoObj, "vout").get_int();
-                const std::vector<unsigned char> &data(ParseHex(find_value(utxoObj, "scriptPubKey").get_str()));
-                const CScript& scriptPubKey = CScript(data.begin(), data.end());
-                const CAmount &nValue = AmountFromValue(find_value(utxoObj, "amount"));
-                const CTxIn txIn(txid, nOut, scriptPubKey);
-                const COutPoint outPoint(txid, nOut);
+                const COutPoint& outPoint = vecCoins[i].first;
+                const CAmount &nValue = vecCoins[i].second;
+                const CTxIn txIn(outPoint, scriptPubKeyFromOrig);
                 if (std::find(tx.vin.begin(), tx.vin.end(), txIn) != tx.vin.end())
                     continue;
                 // look for small inputs only, if not selecting all
                 if (nValue <= minFee || (output_index >= 0 && output_index == i)) {
-
-                    if (mempool.mapNextTx.find(outPoint) != mempool.mapNextTx.end())
-                        continue;
-                    {
-                        LOCK(pwallet->cs_wallet);
-                        if (pwallet->IsLockedCoin(txid, nOut))
-                            continue;
-                    }
-                    if (!IsOutpointMature(outPoint))
+                    if (!IsFundingCoinAvailable(pwallet, coins, outPoint, nNow))
                         continue;
                     int numSigs = 0;
-                    CCountSigsVisitor(*pwallet, numSigs).Process(scriptPubKey);
+                    CCountSigsVisitor(*pwallet, numSigs).Process(scriptPubKeyFromOrig);
                     // add fees to account for every input added to this transaction
                     nFees += GetFee(numSigs * 200);
                     tx.vin.push_back(txIn);
+                    vecPicked.push_back(outPoint);
                     countInputs++;
                     nCurrentAmount += nValue;
                     if (nCurrentAmount >= (nDesiredAmount + nFees) || (output_index >= 0 && output_index == i)) {
@@ -626,36 +646,24 @@ UniValue syscointxfund(const JSONRPCRequest& request) {
 		if (nCurrentAmount < (nDesiredAmount + nFees)) {
 
 			LOCK(mempool.cs);
-			for (unsigned int i = 0; i < utxoArray.size(); i++)
+			for (unsigned int i = 0; i < vecCoins.size(); i++)
 			{
-				const UniValue& utxoObj = utxoArray[i].get_obj();
-				const string &strTxid = find_value(utxoObj, "txid").get_str();
-				const uint256& txid = uint256S(strTxid);
-				const int& nOut = find_value(utxoObj, "vout").get_int();
-				const std::vector<unsigned char> &data(ParseHex(find_value(utxoObj, "scriptPubKey").get_str()));
-				const CScript& scriptPubKey = CScript(data.begin(), data.end());
-				const CAmount &nValue = AmountFromValue(find_value(utxoObj, "amount"));
-				const CTxIn txIn(txid, nOut, scriptPubKey);
-				const COutPoint outPoint(txid, nOut);
+				const COutPoint& outPoint = vecCoins[i].first;
+				const CAmount &nValue = vecCoins[i].second;
+				const CTxIn txIn(outPoint, scriptPubKeyFromOrig);
 				if (std::find(tx.vin.begin(), tx.vin.end(), txIn) != tx.vin.end())
 					continue;
                 // look for bigger inputs
                 if (nValue <= minFee)
                     continue;
-				if (mempool.mapNextTx.find(outPoint) != mempool.mapNextTx.end())
-					continue;
-				{
-					LOCK(pwallet->cs_wallet);
-					if (pwallet->IsLockedCoin(txid, nOut))
-						continue;
-				}
-				if (!IsOutpointMature(outPoint))
+				if (!IsFundingCoinAvailable(pwallet, coins, outPoint, nNow))
 					continue;
 				int numSigs = 0;
-				CCountSigsVisitor(*pwallet, numSigs).Process(scriptPubKey);
+				CCountSigsVisitor(*pwallet, numSigs).Process(scriptPubKeyFromOrig);
 				// add fees to account for every input added to this transaction
 				nFees += GetFee(numSigs * 200);
 				tx.vin.push_back(txIn);
+				vecPicked.push_back(outPoint);
 				nCurrentAmount += nValue;
 				if (nCurrentAmount >= (nDesiredAmount + nFees)) {
 					break;
@@ -673,11 +681,52 @@ UniValue syscointxfund(const JSONRPCRequest& request) {
 	const CTxDestination & dest = DecodeDestination(strAddress);
 	if (!IsValidDestination(dest))
 		throw runtime_error("Change address is not valid");
+	for (const COutPoint& outPoint : vecPicked) {
+		coins.setSpent.insert(outPoint);
+		if (!coins.setUnconfirmed.count(outPoint))
+			vecReserve.push_back(outPoint);
+	}
 	CTxOut changeOut(nChange, GetScriptForDestination(dest));
-	if (!IsDust(changeOut, dustRelayFee))
-		tx.vout.push_back(changeOut);
-	
-    
+	if (IsDust(changeOut, dustRelayFee))
+		return -1;
+	tx.vout.push_back(changeOut);
+	return tx.vout.size() - 1;
+}
+UniValue syscointxfund(const JSONRPCRequest& request) {
+	std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
+	CWallet* const pwallet = wallet.get();
+	const UniValue &params = request.params;
+	if (request.fHelp || 1 > params.size() || 3 < params.size())
+		throw runtime_error(
+			"syscointxfund\n"
+			"\nFunds a new syscoin transaction with inputs used from wallet or an array of addresses specified.\n"
+			"\nArguments:\n"
+			"  \"hexstring\" (string, required) The raw syscoin transaction output given from rpc (ie: assetnew, assetupdate)\n"
+			"  \"address\"  (string, required) Address belonging to this asset transaction. \n"
+			"  \"output_index\"  (number, optional) Output index from available UTXOs in address. Defaults to selecting all that are needed to fund the transaction. \n"
+			"\nExamples:\n"
+			+ HelpExampleCli("syscointxfund", " <hexstring> \"175tWpb8K1S7NmH4Zx6rewF9WQrcZv245W\"")
+			+ HelpExampleCli("syscointxfund", " <hexstring> \"175tWpb8K1S7NmH4Zx6rewF9WQrcZv245W\" 0")
+			+ HelpRequiringPassphrase(pwallet));
+
+	const string &hexstring = params[0].get_str();
+    const string &strAddress = params[1].get_str();
+	CMutableTransaction tx;
+    // decode as non-witness
+	if (!DecodeHexTx(tx, hexstring, true, false))
+		throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5500 - " + _("Could not send raw transaction: Cannot decode transaction from hex string: ") + hexstring);
+
+	int output_index = -1;
+    if (params.size() > 2) {
+        output_index = params[2].get_int();
+    }
+ 
+    CFundingCoins coins;
+    vector<COutPoint> vecReserve;
+    FundSyscoinTransaction(pwallet, tx, strAddress, output_index, coins, vecReserve);
+	if (paddresscoincache)
+		paddresscoincache->Reserve(vecReserve, GetTime());
+
 	// pass back new raw transaction
 	UniValue res(UniValue::VARR);
 	res.push_back(EncodeHexTx(tx));
@@ -834,41 +883,28 @@ int GenerateSyscoinGuid()
 }
 unsigned int addressunspent(const string& strAddressFrom, COutPoint& outpoint)
 {
-	UniValue paramsUTXO(UniValue::VARR);
-	UniValue param(UniValue::VOBJ);
-	UniValue utxoParams(UniValue::VARR);
-	utxoParams.push_back("addr(" + strAddressFrom + ")");
-	paramsUTXO.push_back("start");
-	paramsUTXO.push_back(utxoParams);
-	JSONRPCRequest request;
-	request.params = paramsUTXO;
-	UniValue resUTXOs = scantxoutset(request);
-	UniValue utxoArray(UniValue::VARR);
-    if (resUTXOs.isObject()) {
-        const UniValue& resUtxoUnspents = find_value(resUTXOs.get_obj(), "unspents");
-        if (!resUtxoUnspents.isArray())
-            throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5501 - " + _("No unspent outputs found in addresses provided"));
-        utxoArray = resUtxoUnspents.get_array();
-    }   
-    else
-        throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 5501 - " + _("No unspent outputs found in addresses provided"));
+	vector<CAddressCoinCache::AddressCoin> vecCoins;
+	GetAddressCoins(strAddressFrom, vecCoins);
         
 	unsigned int count = 0;
 	{
-		LOCK(mempool.cs);
+		LOCK2(cs_main, mempool.cs);
 		const CAmount &minFee = GetFee(3000);
-		for (unsigned int i = 0; i < utxoArray.size(); i++)
+		for (unsigned int i = 0; i < vecCoins.size(); i++)
 		{
-			const UniValue& utxoObj = utxoArray[i].get_obj();
-			const uint256& txid = uint256S(find_value(utxoObj, "txid").get_str());
-			const int& nOut = find_value(utxoObj, "vout").get_int();
-			const CAmount &nValue = AmountFromValue(find_value(utxoObj, "amount"));
+			const CAmount &nValue = vecCoins[i].second;
 			if (nValue > minFee)
 				continue;
-			const COutPoint &outPointToCheck = COutPoint(txid, nOut);
+			const COutPoint &outPointToCheck = vecCoins[i].first;
 
 			if (mempool.mapNextTx.find(outPointToCheck) != mempool.mapNextTx.end())
 				continue;
+			// the cache may not have heard of the block spending it yet
+			if (GetUTXOHeight(outPointToCheck) < 0) {
+				if (paddresscoincache)
+					paddresscoincache->Spend(outPointToCheck);
+				continue;
+			}
 			if (outpoint.IsNull())
 				outpoint = outPointToCheck;
 			count++;
@@ -1005,16 +1041,27 @@ void CMintSyscoin::Serialize( vector<unsigned char> &vchData) {
     vchData = vector<unsigned char>(dsMint.begin(), dsMint.end());
 
 }
+void NotifySyscoinEventRaw(const char *topic, const CTransaction& tx, const int& op, const int& nHeight, const bool& confirmed, const std::vector<unsigned char> &vchPayload) {
+    CDataStream ssEvent(SER_NETWORK, PROTOCOL_VERSION);
+    ssEvent << tx.GetHash() << tx.nVersion << op << nHeight << confirmed << vchPayload;
+    GetMainSignals().NotifySyscoinUpdateRaw(std::vector<unsigned char>(ssEvent.begin(), ssEvent.end()), topic, confirmed);
+}
 void CAssetDB::WriteAssetIndex(const CTransaction& tx, const CAsset& dbAsset, const int& op, const int& nHeight) {
 	if (fZMQAsset) {
 		UniValue oName(UniValue::VOBJ);
         AssetTxToJSON(op, tx, dbAsset, nHeight, oName);
         GetMainSignals().NotifySyscoinUpdate(oName.write().c_str(), "assetrecord");
 	}
+    // SYSCOIN the raw topic carries the asset record as stored after this transaction
+    if (fZMQAssetRaw) {
+        CDataStream dsAsset(SER_NETWORK, PROTOCOL_VERSION);
+        dsAsset << dbAsset;
+        NotifySyscoinEventRaw("assetrecordraw", tx, op, nHeight, true, std::vector<unsigned char>(dsAsset.begin(), dsAsset.end()));
+    }
 }
 bool GetAsset(const int &nAsset,
         CAsset& txPos) {
-    if (passetdb == nullptr || !passetdb->ReadAsset(nAsset, txPos))
+    if (passetcache == nullptr || !passetcache->Read((uint32_t)nAsset, txPos))
         return false;
     return true;
 }
@@ -1155,7 +1202,7 @@ bool DisconnectAssetActivate(const CTransaction &tx, AssetMap &mapAssets){
     return true;  
 }
 bool CheckAssetInputs(const CTransaction &tx, const CCoinsViewCache &inputs, int op, const vector<vector<unsigned char> > &vvchArgs,
-        bool fJustCheck, int nHeight, AssetMap& mapAssets, AssetAllocationMap &mapAssetAllocations, string &errorMessage, bool bSanityCheck) {
+        bool fJustCheck, int nHeight, AssetMap& mapAssets, AssetAllocationMap &mapAssetAllocations, string &errorMessage, bool bSanityCheck, bool bMiner) {
 	if (passetdb == nullptr)
 		return false;
 	const uint256& txHash = tx.GetHash();
@@ -1368,7 +1415,8 @@ bool CheckAssetInputs(const CTransaction &tx, const CCoinsViewCache &inputs, int
 					storedSenderAssetRef.nBalance -= amountTuple.second;                              
 				}
 			}
-            passetallocationdb->WriteAssetAllocationIndex(op, tx, storedSenderAssetRef, true, nHeight);  
+            if (!bSanityCheck && !bMiner)
+                passetallocationdb->WriteAssetAllocationIndex(op, tx, storedSenderAssetRef, true, nHeight);
 		}
 		else if (op != OP_ASSET_ACTIVATE)
 		{         
@@ -1426,7 +1474,7 @@ bool CheckAssetInputs(const CTransaction &tx, const CCoinsViewCache &inputs, int
         storedSenderAssetRef.nHeight = nHeight;
 		storedSenderAssetRef.txHash = txHash;
 		// write asset, if asset send, only write on pow since asset -> asset allocation is not 0-conf compatible
-		if (!bSanityCheck) {
+		if (!bSanityCheck && !bMiner) {
             passetdb->WriteAssetIndex(tx, storedSenderAssetRef, op, nHeight);
 			LogPrint(BCLog::SYS,"CONNECTED ASSET: op=%s symbol=%d hash=%s height=%d fJustCheck=%d\n",
 					assetFromOp(op).c_str(),
@@ -1807,7 +1855,7 @@ UniValue assetinfo(const JSONRPCRequest& request) {
 	UniValue oAsset(UniValue::VOBJ);
 
 	CAsset txPos;
-	if (passetdb == nullptr || !passetdb->ReadAsset(nAsset, txPos))
+	if (!GetAsset(nAsset, txPos))
 		throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 2511 - " + _("Failed to read from asset DB"));
 
 	if(!BuildAssetJson(txPos, oAsset))
@@ -1963,20 +2011,83 @@ bool AssetRange(const CAmount& amount, int precision)
 		return false;
 	return true;
 }
-bool CAssetDB::Flush(const AssetMap &mapAssets){
-    if(mapAssets.empty())
+void UpdateAssetCache(const AssetMap &mapAssets){
+    for (const auto &key : mapAssets)
+        passetcache->Write((uint32_t)key.first, key.second);
+}
+bool FlushAssetCaches(){
+    if (passetcache == nullptr || passetallocationcache == nullptr)
         return true;
-    CDBBatch batch(*this);
-    for (const auto &key : mapAssets) {
-        if(key.second.IsNull())
-            batch.Erase(key.first);
-        else
-            batch.Write(key.first, key.second);
+    return passetallocationcache->Flush() && passetcache->Flush();
+}
+/** Whether the asset caches hold changes that have not been written to the databases */
+bool AssetCachesDirty(){
+    if (passetcache == nullptr || passetallocationcache == nullptr)
+        return false;
+    return passetallocationcache->IsDirty() || passetcache->IsDirty();
+}
+/** Load the asset and allocation records the syscoin transactions of a block refer to into
+ *  the caches, so that connecting the block does not look them up one at a time. */
+void PrefetchAssetCaches(const CBlock& block){
+    if (passetcache == nullptr || passetallocationcache == nullptr)
+        return;
+    vector<uint32_t> vecAssets;
+    vector<CAssetAllocationTuple> vecAllocations;
+    for (const auto &txRef : block.vtx) {
+        const CTransaction &tx = *txRef;
+        if (tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN || tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET) {
+            CMintSyscoin mintSyscoin(tx);
+            if (mintSyscoin.IsNull())
+                continue;
+            vecAssets.push_back(mintSyscoin.assetAllocationTuple.nAsset);
+            vecAllocations.emplace_back(mintSyscoin.assetAllocationTuple.nAsset, mintSyscoin.assetAllocationTuple.witnessAddress);
+            continue;
+        }
+        if (tx.nVersion != SYSCOIN_TX_VERSION_ASSET)
+            continue;
+        vector<unsigned char> vchData;
+        int nDataOut, type;
+        if (!GetSyscoinData(tx, vchData, nDataOut, type))
+            continue;
+        if (type == OP_SYSCOIN_ASSET_ALLOCATION) {
+            CAssetAllocation theAssetAllocation;
+            if (!theAssetAllocation.UnserializeFromData(vchData))
+                continue;
+            const uint32_t nAsset = theAssetAllocation.assetAllocationTuple.nAsset;
+            vecAssets.push_back(nAsset);
+            for (const auto& amountTuple : theAssetAllocation.listSendingAllocationAmounts)
+                vecAllocations.emplace_back(nAsset, amountTuple.first);
+            vecAllocations.push_back(std::move(theAssetAllocation.assetAllocationTuple));
+        } else if (type == OP_SYSCOIN_ASSET) {
+            CAsset theAsset;
+            if (theAsset.UnserializeFromData(vchData))
+                vecAssets.push_back(theAsset.nAsset);
+        }
     }
-    LogPrint(BCLog::SYS, "Flushing %d assets\n", mapAssets.size());
-    return WriteBatch(batch);
+    if (!vecAssets.empty())
+        passetcache->Prefetch(vecAssets);
+    if (!vecAllocations.empty())
+        passetallocationcache->Prefetch(vecAllocations);
+}
+/** Take read views of both asset databases at the current chain tip, so that scans see
+ *  one consistent state without holding cs_main while blocks keep connecting. */
+bool GetAssetSnapshots(std::unique_ptr<CDBSnapshot>& assetSnapshot, std::unique_ptr<CDBSnapshot>& assetAllocationSnapshot){
+    LOCK(cs_main);
+    if (passetcache == nullptr || passetallocationcache == nullptr)
+        return false;
+    // the caches lay the changes they have not written yet over the databases, and only
+    // change under cs_main, so both views describe the tip without flushing anything
+    const uint256 hashBlock = chainActive.Tip() != nullptr ? chainActive.Tip()->GetBlockHash() : uint256();
+    assetSnapshot = passetcache->GetSnapshot(hashBlock);
+    assetAllocationSnapshot = passetallocationcache->GetSnapshot(hashBlock);
+    return true;
+}
+size_t AssetCachesDynamicMemoryUsage(){
+    if (passetcache == nullptr || passetallocationcache == nullptr)
+        return 0;
+    return passetcache->DynamicMemoryUsage() + passetallocationcache->DynamicMemoryUsage();
 }
-bool CAssetDB::ScanAssets(const int count, const int from, const UniValue& oOptions, UniValue& oRes) {
+bool CAssetDB::ScanAssets(const CDBSnapshot& snapshot, const int count, const int from, const UniValue& oOptions, RPCResultArray& oRes) {
 	string strTxid = "";
 	vector<CWitnessAddress > vecWitnessAddresses;
     uint32_t nAsset = 0;
@@ -2007,7 +2118,7 @@ bool CAssetDB::ScanAssets(const int count, const int from, const UniValue& oOpti
 			}
 		}
 	}
-	boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+	boost::scoped_ptr<CDBIterator> pcursor(snapshot.NewIterator());
 	pcursor->SeekToFirst();
 	CAsset txPos;
 	uint32_t key;
@@ -2096,10 +2207,15 @@ UniValue listassets(const JSONRPCRequest& request) {
 		options = params[2];
 	}
 
-	UniValue oRes(UniValue::VARR);
-	if (!passetdb->ScanAssets(count, from, options, oRes))
+	// SYSCOIN stream the result if the transport allows it
+	RPCResultArray oRes(request);
+	// SYSCOIN scan a snapshot of the database so block processing is not held up
+	std::unique_ptr<CDBSnapshot> assetSnapshot, assetAllocationSnapshot;
+	if (!GetAssetSnapshots(assetSnapshot, assetAllocationSnapshot))
+		throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 2512 - " + _("Failed to read from asset DB"));
+	if (!passetdb->ScanAssets(*assetSnapshot, count, from, options, oRes))
 		throw runtime_error("SYSCOIN_ASSET_RPC_ERROR: ERRCODE: 2512 - " + _("Scan failed"));
-	return oRes;
+	return oRes.get();
 }
 
 UniValue syscoinstopgeth(const JSONRPCRequest& request) {
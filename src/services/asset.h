@@ -12,7 +12,9 @@
 #include "serialize.h"
 #include "primitives/transaction.h"
 #include "services/assetallocation.h"
+#include "services/assetcache.h"
 #include <sys/types.h>
+#include <set>
 class CTransaction;
 class CReserveKey;
 class CCoinsViewCache;
@@ -22,6 +24,7 @@ class COutPoint;
 class UniValue;
 class CTxOut;
 class CWallet;
+class RPCResultArray;
 const int SYSCOIN_TX_VERSION_ASSET = 0x7401;
 const int SYSCOIN_TX_VERSION_MINT_SYSCOIN = 0x7402;
 const int SYSCOIN_TX_VERSION_MINT_ASSET = 0x7403;
@@ -47,6 +50,21 @@ void SysTxToJSON(const int &op, const CTransaction &tx, UniValue &entry, const c
 std::string GetSyscoinTransactionDescription(const CTransaction& tx, const int op, std::string& responseEnglish, const char &type, std::string& responseGUID);
 bool IsOutpointMature(const COutPoint& outpoint);
 UniValue syscointxfund_helper(const std::string &vchWitness, std::vector<CRecipient> &vecSend, const int nVersion = SYSCOIN_TX_VERSION_ASSET);
+/** Coins of an address that a series of funding calls picks from, so that the coins are looked up once and
+ *  none is picked twice. Change of a transaction funded earlier in the series may be added to vecCoins and
+ *  setUnconfirmed, and is then spent like a confirmed coin. */
+struct CFundingCoins {
+    std::vector<std::pair<COutPoint, CAmount> > vecCoins;
+    bool fLoaded = false;
+    //! Coins picked by earlier calls
+    std::set<COutPoint> setSpent;
+    //! Outputs of earlier transactions of the series, not in the chain or the mempool yet
+    std::set<COutPoint> setUnconfirmed;
+};
+/** Add inputs of strAddress to tx to pay for its outputs and fees, and a change output back to the address
+ *  unless it is dust. Returns the index of the change output or -1. The coins picked from the chain are
+ *  appended to vecReserve, for the caller to reserve once the transaction is going to be sent. */
+int FundSyscoinTransaction(CWallet* const pwallet, CMutableTransaction& tx, const std::string& strAddress, const int output_index, CFundingCoins& coins, std::vector<COutPoint>& vecReserve);
 bool FlushSyscoinDBs();
 bool FindAssetOwnerInTx(const CCoinsViewCache &inputs, const CTransaction& tx, const CWitnessAddress& witnessAddressToMatch);
 CWallet* GetDefaultWallet();
@@ -218,11 +236,20 @@ public:
         return Read(nAsset, asset);
     } 
 	void WriteAssetIndex(const CTransaction& tx, const CAsset& dbAsset, const int& op, const int& nHeight);
-	bool ScanAssets(const int count, const int from, const UniValue& oOptions, UniValue& oRes);
-    bool Flush(const AssetMap &mapAssets);
+	bool ScanAssets(const CDBSnapshot& snapshot, const int count, const int from, const UniValue& oOptions, RPCResultArray& oRes);
 };
+typedef CAssetDBCache<CAsset> CAssetCache;
+typedef CAssetDBCache<CAssetAllocation> CAssetAllocationCache;
 static CAsset emptyAsset;
 bool GetAsset(const int &nAsset,CAsset& txPos);
+void UpdateAssetCache(const AssetMap &mapAssets);
+bool FlushAssetCaches();
+bool AssetCachesDirty();
+void PrefetchAssetCaches(const CBlock& block);
+size_t AssetCachesDynamicMemoryUsage();
+bool GetAssetSnapshots(std::unique_ptr<CDBSnapshot>& assetSnapshot, std::unique_ptr<CDBSnapshot>& assetAllocationSnapshot);
+/** Publish a serialized asset/allocation event on the raw ZMQ topic: txid, tx version, op, height, confirmed, payload */
+void NotifySyscoinEventRaw(const char *topic, const CTransaction& tx, const int& op, const int& nHeight, const bool& confirmed, const std::vector<unsigned char> &vchPayload);
 bool BuildAssetJson(const CAsset& asset, UniValue& oName);
 UniValue ValueFromAssetAmount(const CAmount& amount, int precision);
 CAmount AssetAmountFromValue(UniValue& value, int precision);
@@ -233,10 +260,12 @@ bool DisconnectAssetSend(const CTransaction &tx, AssetMap &mapAssets, AssetAlloc
 bool DisconnectAssetUpdate(const CTransaction &tx, AssetMap &mapAssets);
 bool DisconnectAssetAllocation(const CTransaction &tx, AssetAllocationMap &mapAssetAllocations);
 bool DisconnectMintAsset(const CTransaction &tx, AssetMap &mapAssets, AssetAllocationMap &mapAssetAllocations);
-bool CheckAssetInputs(const CTransaction &tx, const CCoinsViewCache &inputs, int op, const std::vector<std::vector<unsigned char> > &vvchArgs, bool fJustCheck, int nHeight, AssetMap &mapAssets, AssetAllocationMap &mapAssetAllocations, std::string &errorMessage, bool bSanityCheck=false);
+bool CheckAssetInputs(const CTransaction &tx, const CCoinsViewCache &inputs, int op, const std::vector<std::vector<unsigned char> > &vvchArgs, bool fJustCheck, int nHeight, AssetMap &mapAssets, AssetAllocationMap &mapAssetAllocations, std::string &errorMessage, bool bSanityCheck=false, bool bMiner=false);
 bool DecodeAssetTx(const CTransaction& tx, int& op, std::vector<std::vector<unsigned char> >& vvch);
 extern std::unique_ptr<CAssetDB> passetdb;
 extern std::unique_ptr<CAssetAllocationDB> passetallocationdb;
+extern std::unique_ptr<CAssetCache> passetcache;
+extern std::unique_ptr<CAssetAllocationCache> passetallocationcache;
 extern std::unique_ptr<CAssetAllocationTransactionsDB> passetallocationtransactionsdb;
 extern std::unique_ptr<CAssetAllocationMempoolDB> passetallocationmempooldb;
 extern std::unique_ptr<CEthereumTxRootsDB> pethereumtxrootsdb;
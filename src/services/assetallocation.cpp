@@ -4,6 +4,7 @@
 
 #include "services/assetallocation.h"
 #include "services/asset.h"
+#include "services/addresscoins.h"
 #include "init.h"
 #include "validation.h"
 #include "txmempool.h"
@@ -19,10 +20,18 @@
 #include <key_io.h>
 #include <future>
 #include <rpc/util.h>
+#include <policy/policy.h>
+#include <script/sign.h>
+#include <wallet/rpcwallet.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
 // SYSCOIN service rpc functions
 extern UniValue sendrawtransaction(const JSONRPCRequest& request);
 
 UniValue assetallocationsend(const JSONRPCRequest& request);
+UniValue assetallocationsendbatch(const JSONRPCRequest& request);
 UniValue assetallocationmint(const JSONRPCRequest& request);
 UniValue assetallocationburn(const JSONRPCRequest& request);
 UniValue assetallocationinfo(const JSONRPCRequest& request);
@@ -117,14 +126,26 @@ void CAssetAllocationDB::WriteMintIndex(const CTransaction& tx, const CMintSysco
         AssetMintTxToJson(tx, mintSyscoin, nHeight, output);
         GetMainSignals().NotifySyscoinUpdate(output.write().c_str(), "assetallocation");
     }
+    if (fZMQAssetAllocationRaw) {
+        CDataStream dsMint(SER_NETWORK, PROTOCOL_VERSION);
+        dsMint << mintSyscoin;
+        NotifySyscoinEventRaw("assetallocationraw", tx, 0, nHeight, true, std::vector<unsigned char>(dsMint.begin(), dsMint.end()));
+    }
 }
 void CAssetAllocationDB::WriteAssetAllocationIndex(const int& op, const CTransaction &tx, const CAsset& dbAsset, const bool& confirmed, int nHeight) {
+    // SYSCOIN the raw topic carries the allocation payload of the transaction as is, without building JSON
+    if (fZMQAssetAllocationRaw) {
+        vector<unsigned char> vchData;
+        int nOut, nDataOp;
+        if (GetSyscoinData(tx, vchData, nOut, nDataOp))
+            NotifySyscoinEventRaw("assetallocationraw", tx, op, nHeight, confirmed, vchData);
+    }
 	if (fZMQAssetAllocation || fAssetAllocationIndex) {
 		UniValue oName(UniValue::VOBJ);
         string strSender;
         bool isMine = AssetAllocationTxToJSON(op, tx, dbAsset, nHeight, confirmed, oName, strSender);
         const string& strObj = oName.write();
-        GetMainSignals().NotifySyscoinUpdate(strObj.c_str(), "assetallocation");
+        GetMainSignals().NotifySyscoinUpdate(strObj.c_str(), "assetallocation", confirmed);
 		if (isMine && fAssetAllocationIndex) {
             const string& txHash = tx.GetHash().GetHex();
 			const string& strKey = txHash+"-"+boost::lexical_cast<string>(dbAsset.nAsset)+"-"+ strSender;
@@ -141,7 +162,7 @@ void CAssetAllocationDB::WriteAssetAllocationIndex(const int& op, const CTransac
 
 }
 bool GetAssetAllocation(const CAssetAllocationTuple &assetAllocationTuple, CAssetAllocation& txPos) {
-    if (passetallocationdb == nullptr || !passetallocationdb->ReadAssetAllocation(assetAllocationTuple, txPos))
+    if (passetallocationcache == nullptr || !passetallocationcache->Read(assetAllocationTuple, txPos))
         return false;
     return true;
 }
@@ -180,11 +201,14 @@ void ResyncAssetAllocationStates(){
      {
         
         vector<string> vecToRemoveMempoolBalances;
+        // senders some of whose arrival times are dropped
+        vector<string> vecSyncArrivals;
         LOCK2(cs_main, mempool.cs);
         LOCK(cs_assetallocation);
         LOCK(cs_assetallocationarrival);
+        const CTxMemPool::indexed_arrival_set::index<sender_arrival>::type& senderArrivals = mempool.mapAssetAllocationArrivals.get<sender_arrival>();
+        const int64_t nMinArrivalTime = (chainActive.Tip()->GetMedianTimePast()*1000) - 1800000;
         for (auto&indexObj : mempoolMapAssetBalances) {
-            vector<uint256> vecToRemoveArrivalTimes;
             const string& strSenderTuple = indexObj.first;
             // if no arrival time for this mempool balance, remove it
             auto arrivalTimes = arrivalTimesMap.find(strSenderTuple);
@@ -192,30 +216,35 @@ void ResyncAssetAllocationStates(){
                 vecToRemoveMempoolBalances.push_back(strSenderTuple);
                 continue;
             }
-            for(auto& arrivalTime: arrivalTimes->second){
-                const uint256& txHash = arrivalTime.first;
-                const CTransactionRef txRef = mempool.get(txHash);
-                // if mempool doesnt have txid then remove from both arrivalTime and mempool balances
-                if (!txRef){
-                    vecToRemoveArrivalTimes.push_back(txHash);
-                }
-                if(!arrivalTime.first.IsNull() && ((chainActive.Tip()->GetMedianTimePast()*1000) - arrivalTime.second) > 1800000){
-                    vecToRemoveArrivalTimes.push_back(txHash);
-                }
+            // keep only the arrival times of txids still in mempool that are less than 30 mins old
+            std::unordered_set<uint256, SaltedTxidHasher> setKeptArrivalTimes;
+            auto itEnd = senderArrivals.upper_bound(boost::make_tuple(strSenderTuple));
+            for (auto it = senderArrivals.lower_bound(boost::make_tuple(strSenderTuple, nMinArrivalTime)); it != itEnd; ++it) {
+                if(arrivalTimes->second.count(it->txHash))
+                    setKeptArrivalTimes.insert(it->txHash);
             }
             // if we are removing everything from arrivalTime map then might as well remove it from parent altogether
-            if(vecToRemoveArrivalTimes.size() >= arrivalTimes->second.size()){
-                arrivalTimesMap.erase(strSenderTuple);
+            if(setKeptArrivalTimes.empty()){
+                arrivalTimesMap.erase(arrivalTimes);
                 vecToRemoveMempoolBalances.push_back(strSenderTuple);
+                vecSyncArrivals.push_back(strSenderTuple);
             } 
             // otherwise remove the individual txids
-            else{
-                for(auto &removeTxHash: vecToRemoveArrivalTimes){
-                    arrivalTimes->second.erase(removeTxHash);
+            else if(setKeptArrivalTimes.size() < arrivalTimes->second.size()){
+                vecSyncArrivals.push_back(strSenderTuple);
+                for(auto arrivalTime = arrivalTimes->second.begin(); arrivalTime != arrivalTimes->second.end();){
+                    if(setKeptArrivalTimes.count(arrivalTime->first))
+                        ++arrivalTime;
+                    else
+                        arrivalTime = arrivalTimes->second.erase(arrivalTime);
                 }
             }         
         }
         count+=vecToRemoveMempoolBalances.size();
+        for(auto& senderTuple: vecSyncArrivals)
+            mempool.SyncAssetAllocationArrivals(senderTuple);
+        if(!vecToRemoveMempoolBalances.empty())
+            mempool.AssetAllocationsUpdated();
         for(auto& senderTuple: vecToRemoveMempoolBalances){
             mempoolMapAssetBalances.erase(senderTuple);
             // also remove from assetAllocationConflicts
@@ -229,6 +258,52 @@ void ResyncAssetAllocationStates(){
         LogPrint(BCLog::SYS,"removeExpiredMempoolBalances removed %d expired asset allocation transactions from mempool balances\n", count);
 
 }
+void CTxMemPool::addAssetAllocationArrival(const CTransaction& tx) {
+    vector<vector<unsigned char> > vvch;
+    int op;
+    if(tx.nVersion != SYSCOIN_TX_VERSION_ASSET || !DecodeAssetAllocationTx(tx, op, vvch))
+        return;
+    CAssetAllocation allocation(tx);
+    if(allocation.assetAllocationTuple.IsNull())
+        return;
+    const string& senderStr = allocation.assetAllocationTuple.ToString();
+    // the arrival time is already known if the syscoin inputs were checked before the tx was added, otherwise it is set once they are
+    int64_t nArrivalTime = NO_ASSET_ALLOCATION_ARRIVAL;
+    {
+        LOCK(cs_assetallocationarrival);
+        auto arrivalTimes = arrivalTimesMap.find(senderStr);
+        if(arrivalTimes != arrivalTimesMap.end()){
+            auto arrivalTime = arrivalTimes->second.find(tx.GetHash());
+            if(arrivalTime != arrivalTimes->second.end())
+                nArrivalTime = arrivalTime->second;
+        }
+    }
+    mapAssetAllocationArrivals.insert(AssetAllocationArrival{senderStr, nArrivalTime, tx.GetHash()});
+}
+void CTxMemPool::UpdateAssetAllocationArrival(const uint256& txHash, int64_t nArrivalTime) {
+    LOCK(cs);
+    auto it = mapAssetAllocationArrivals.find(txHash);
+    if(it != mapAssetAllocationArrivals.end() && it->nArrivalTime != nArrivalTime) {
+        mapAssetAllocationArrivals.modify(it, [nArrivalTime](AssetAllocationArrival& arrival){ arrival.nArrivalTime = nArrivalTime; });
+        AssetAllocationsUpdated();
+    }
+}
+void CTxMemPool::SyncAssetAllocationArrivals(const string& strSender) {
+    LOCK2(cs, cs_assetallocationarrival);
+    const indexed_arrival_set::index<sender_arrival>::type& senderArrivals = mapAssetAllocationArrivals.get<sender_arrival>();
+    auto arrivalTimes = arrivalTimesMap.find(strSender);
+    vector<uint256> vecDropped;
+    auto itEnd = senderArrivals.upper_bound(boost::make_tuple(strSender));
+    for (auto it = senderArrivals.lower_bound(boost::make_tuple(strSender)); it != itEnd; ++it) {
+        if(it->nArrivalTime != NO_ASSET_ALLOCATION_ARRIVAL && (arrivalTimes == arrivalTimesMap.end() || !arrivalTimes->second.count(it->txHash)))
+            vecDropped.push_back(it->txHash);
+    }
+    // changing the arrival time moves the entry within the sender index, so do it after the walk
+    for (const uint256& txHash : vecDropped)
+        mapAssetAllocationArrivals.modify(mapAssetAllocationArrivals.find(txHash), [](AssetAllocationArrival& arrival){ arrival.nArrivalTime = NO_ASSET_ALLOCATION_ARRIVAL; });
+    if (!vecDropped.empty())
+        AssetAllocationsUpdated();
+}
 bool ResetAssetAllocation(const string &senderStr, const uint256 &txHash, const bool &bMiner, const bool& bCheckExpiryOnly) {
     bool removeAllConflicts = true;
     if(!bMiner){
@@ -263,6 +338,9 @@ bool ResetAssetAllocation(const string &senderStr, const uint256 &txHash, const
                     removeAllConflicts = true;
             }
         }
+        // sends whose arrival time was dropped go back to the end of the block
+        mempool.SyncAssetAllocationArrivals(senderStr);
+        mempool.AssetAllocationsUpdated();
         if(removeAllConflicts)
         {
             LOCK(cs_assetallocation);
@@ -574,6 +652,7 @@ bool CheckAssetAllocationInputs(const CTransaction &tx, const CCoinsViewCache &i
             LOCK(cs_assetallocationarrival);
             // add conflicting sender if using ZDAG
             assetAllocationConflicts.insert(senderTupleStr);
+            mempool.AssetAllocationsUpdated();
         }
 	}
 	else if (op == OP_ASSET_ALLOCATION_SEND)
@@ -601,6 +680,7 @@ bool CheckAssetAllocationInputs(const CTransaction &tx, const CCoinsViewCache &i
                 LOCK(cs_assetallocationarrival);
 				// add conflicting sender
 				assetAllocationConflicts.insert(senderTupleStr);
+                mempool.AssetAllocationsUpdated();
             }
             if(fJustCheck)
             {
@@ -679,7 +759,9 @@ bool CheckAssetAllocationInputs(const CTransaction &tx, const CCoinsViewCache &i
 
             
         // send notification on pow, for zdag transactions this is the second notification meaning the zdag tx has been confirmed
-        passetallocationdb->WriteAssetAllocationIndex(op, tx, dbAsset, true, nHeight);    
+        // SYSCOIN not for a block that is only being checked or assembled, it has no hash yet
+        if (!bSanityCheck && !bMiner)
+            passetallocationdb->WriteAssetAllocationIndex(op, tx, dbAsset, true, nHeight);
         
         LogPrint(BCLog::SYS,"CONNECTED ASSET ALLOCATION: op=%s assetallocation=%s hash=%s height=%d fJustCheck=%d\n",
                 assetAllocationFromOp(op).c_str(),
@@ -690,9 +772,13 @@ bool CheckAssetAllocationInputs(const CTransaction &tx, const CCoinsViewCache &i
     }
 	else{
         if(!bSanityCheck){
-            LOCK(cs_assetallocationarrival);
-            ArrivalTimesMap &arrivalTimes = arrivalTimesMap[senderTupleStr];
-            arrivalTimes[txHash] = GetTimeMillis();
+            const int64_t nArrivalTime = GetTimeMillis();
+            {
+                LOCK(cs_assetallocationarrival);
+                ArrivalTimesMap &arrivalTimes = arrivalTimesMap[senderTupleStr];
+                arrivalTimes[txHash] = nArrivalTime;
+            }
+            mempool.UpdateAssetAllocationArrival(txHash, nArrivalTime);
         }
         if(!bSanityCheck)
         {
@@ -793,9 +879,31 @@ UniValue tpstestadd(const JSONRPCRequest& request) {
 					MilliSleep(0);
 				}
 				nTPSTestingSendRawStartTime = nTPSTestingStartTime;
+				// verify the scripts of the whole queue at once, acceptance then finds them cached
+				vector<CTransactionRef> vecPackage;
+				vector<size_t> vecPackageReq;
+				for (size_t i = 0; i < vecTPSRawTransactions.size(); i++) {
+					CMutableTransaction mtx;
+					if (DecodeHexTx(mtx, vecTPSRawTransactions[i].params[0].get_str())) {
+						vecPackage.push_back(MakeTransactionRef(std::move(mtx)));
+						vecPackageReq.push_back(i);
+					}
+				}
+				vector<bool> vecSkip(vecTPSRawTransactions.size(), false);
+				{
+					vector<bool> vecInvalid;
+					CheckPackageScripts(vecPackage, vecInvalid);
+					for (size_t i = 0; i < vecPackage.size(); i++) {
+						if (vecInvalid[i]) {
+							LogPrint(BCLog::SYS, "tpstestsetenabled: not sending %s, script verification failed\n", vecPackage[i]->GetHash().GetHex());
+							vecSkip[vecPackageReq[i]] = true;
+						}
+					}
+				}
 
-				for (auto &txReq : vecTPSRawTransactions) {
-					sendrawtransaction(txReq);
+				for (size_t i = 0; i < vecTPSRawTransactions.size(); i++) {
+					if (!vecSkip[i])
+						sendrawtransaction(vecTPSRawTransactions[i]);
 				}
 			});
 			bool isThreadPosted = false;
@@ -968,31 +1076,11 @@ UniValue assetallocationmint(const JSONRPCRequest& request) {
        
     return syscointxfund_helper(strWitness, vecSend, SYSCOIN_TX_VERSION_MINT_ASSET);
 }
-UniValue assetallocationsend(const JSONRPCRequest& request) {
-    std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
-    CWallet* const pwallet = wallet.get();
-	const UniValue &params = request.params;
-	if (request.fHelp || params.size() != 4)
-		throw runtime_error(
-			"assetallocationsend [asset] [addressfrom] ([{\"address\":\"string\",\"amount\":amount},...] [witness]\n"
-			"Send an asset allocation you own to another address. Maximimum recipients is 250.\n"
-			"<asset> Asset guid.\n"
-			"<addressfrom> Address that owns this asset allocation.\n"
-			"<address> Address to transfer to.\n"
-			"<amount> Quantity of asset to send.\n"
-			"<witness> Witness address that will sign for web-of-trust notarization of this transaction.\n"
-			+ HelpRequiringPassphrase(pwallet));
-
-	// gather & validate inputs
-	const int &nAsset = params[0].get_int();
-	string vchAddressFrom = params[1].get_str();
-	UniValue valueTo = params[2];
-	vector<unsigned char> vchWitness;
-    string strWitness = params[3].get_str();
+/** Outputs of an allocation send of nAsset from strAddress to the receivers in valueTo */
+static void AssetAllocationSendRecipients(const int nAsset, const string& strAddress, const UniValue& valueTo, vector<CRecipient>& vecSend) {
 	if (!valueTo.isArray())
 		throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "Array of receivers not found");
 	string strAddressFrom;
-	const string &strAddress = vchAddressFrom;
     CTxDestination addressFrom;
     string witnessProgramHex;
     unsigned char witnessVersion = 0;
@@ -1080,7 +1168,6 @@ UniValue assetallocationsend(const JSONRPCRequest& request) {
 	scriptPubKey << CScript::EncodeOP_N(OP_SYSCOIN_ASSET_ALLOCATION) << CScript::EncodeOP_N(OP_ASSET_ALLOCATION_SEND) << OP_2DROP;
 	scriptPubKey += scriptPubKeyFromOrig;
 	// send the asset pay txn
-	vector<CRecipient> vecSend;
 	CRecipient recipient;
 	CreateRecipient(scriptPubKey, recipient);
 	vecSend.push_back(recipient);	
@@ -1090,10 +1177,277 @@ UniValue assetallocationsend(const JSONRPCRequest& request) {
 	CRecipient fee;
 	CreateFeeRecipient(scriptData, fee);
 	vecSend.push_back(fee);
+}
+UniValue assetallocationsend(const JSONRPCRequest& request) {
+    std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
+    CWallet* const pwallet = wallet.get();
+	const UniValue &params = request.params;
+	if (request.fHelp || params.size() != 4)
+		throw runtime_error(
+			"assetallocationsend [asset] [addressfrom] ([{\"address\":\"string\",\"amount\":amount},...] [witness]\n"
+			"Send an asset allocation you own to another address. Maximimum recipients is 250.\n"
+			"<asset> Asset guid.\n"
+			"<addressfrom> Address that owns this asset allocation.\n"
+			"<address> Address to transfer to.\n"
+			"<amount> Quantity of asset to send.\n"
+			"<witness> Witness address that will sign for web-of-trust notarization of this transaction.\n"
+			+ HelpRequiringPassphrase(pwallet));
+
+	// gather & validate inputs
+	const int &nAsset = params[0].get_int();
+	string vchAddressFrom = params[1].get_str();
+	UniValue valueTo = params[2];
+    string strWitness = params[3].get_str();
+	vector<CRecipient> vecSend;
+	AssetAllocationSendRecipients(nAsset, vchAddressFrom, valueTo, vecSend);
 
 	return syscointxfund_helper(strWitness, vecSend);
 }
 
+/** Wallet signing of the transactions of an allocation send batch, one task per transaction */
+struct AllocationBatchSigner {
+    std::shared_ptr<CWallet> wallet;
+    std::vector<CMutableTransaction> vTxs;
+    //! Coins spent by each transaction, in input order
+    std::vector<std::vector<Coin> > vCoins;
+    std::vector<char> vComplete;
+    //! Why signing a transaction failed, empty if it did not
+    std::vector<std::string> vErrors;
+    size_t nTasks = 0;
+    std::atomic<size_t> nNext{0};
+    size_t nDone = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    void Sign(size_t nTx)
+    {
+        CMutableTransaction& mtx = vTxs[nTx];
+        const CTransaction txConst(mtx);
+        bool fComplete = !mtx.vin.empty();
+        for (unsigned int i = 0; i < mtx.vin.size(); i++) {
+            CTxIn& txin = mtx.vin[i];
+            const Coin& coin = vCoins[nTx][i];
+            if (coin.IsSpent()) {
+                fComplete = false;
+                continue;
+            }
+            const CScript& prevPubKey = coin.out.scriptPubKey;
+            const CAmount& amount = coin.out.nValue;
+            SignatureData sigdata = DataFromTransaction(mtx, i, coin.out);
+            ProduceSignature(*wallet, MutableTransactionSignatureCreator(&mtx, i, amount, SIGHASH_ALL), prevPubKey, sigdata);
+            UpdateInput(txin, sigdata);
+            if (!VerifyScript(txin.scriptSig, prevPubKey, &txin.scriptWitness, STANDARD_SCRIPT_VERIFY_FLAGS, TransactionSignatureChecker(&txConst, i, amount)))
+                fComplete = false;
+        }
+        vComplete[nTx] = fComplete;
+    }
+
+    /** Run tasks until none are left */
+    void Run()
+    {
+        size_t nRun = 0;
+        for (size_t i = nNext++; i < nTasks; i = nNext++) {
+            // a job that fails still counts as done, or the caller would wait forever
+            try {
+                Sign(i);
+            } catch (const std::exception& e) {
+                vComplete[i] = false;
+                vErrors[i] = e.what();
+            } catch (...) {
+                vComplete[i] = false;
+                vErrors[i] = "unknown error while signing";
+            }
+            nRun++;
+        }
+        if (nRun > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            nDone += nRun;
+            if (nDone == nTasks)
+                cond.notify_one();
+        }
+    }
+};
+
+UniValue assetallocationsendbatch(const JSONRPCRequest& request) {
+    std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
+    CWallet* const pwallet = wallet.get();
+	const UniValue &params = request.params;
+	if (request.fHelp || params.size() < 1 || params.size() > 3)
+		throw runtime_error(
+			"assetallocationsendbatch [{\"asset\":n,\"address\":\"string\",\"recipients\":[{\"address\":\"string\",\"amount\":amount},...]},...] ([witness] [broadcast])\n"
+			"Build, fund and sign many asset allocation sends in one call. Each job is funded from its sending address, whose coins\n"
+			"are looked up once for the whole batch. The change of a job funds the next jobs of the same address before any other\n"
+			"coin, so the transactions of an address form a chain. Transactions are signed with the wallet in parallel.\n"
+			"<asset> Asset guid.\n"
+			"<address> Address that owns this asset allocation and funds the transaction.\n"
+			"<recipients> Receivers as in assetallocationsend. Maximimum recipients per job is 250.\n"
+			"<witness> Witness address that will sign for web-of-trust notarization of every transaction. Defaults to none.\n"
+			"<broadcast> Send every completely signed transaction to the network. Defaults to false.\n"
+			"\nResult:\n"
+			"[{\"txid\":\"id\",\"hex\":\"value\",\"complete\":true|false,\"error\":\"message\"},...] One entry per job, in job order. Failed jobs only carry an error.\n"
+			+ HelpExampleCli("assetallocationsendbatch", "\"[{\\\"asset\\\":1045909988,\\\"address\\\":\\\"sysaddress1\\\",\\\"recipients\\\":[{\\\"address\\\":\\\"sysaddress2\\\",\\\"amount\\\":1.0}]}]\" \"\" true")
+			+ HelpRequiringPassphrase(pwallet));
+
+	const UniValue &jobs = params[0].get_array();
+	string strWitness;
+	if (params.size() > 1)
+		strWitness = params[1].get_str();
+	bool fBroadcast = false;
+	if (params.size() > 2)
+		fBroadcast = params[2].get_bool();
+	EnsureWalletIsUnlocked(pwallet);
+
+	// build and fund every job from the coins of its address, so the jobs never share inputs
+	auto signer = std::make_shared<AllocationBatchSigner>();
+	signer->wallet = wallet;
+	vector<string> vecErrors(jobs.size());
+	vector<size_t> vecJobTx(jobs.size());
+	map<string, CFundingCoins> mapFunding;
+	// change outputs spent by later jobs, which neither the chain nor the mempool know yet
+	map<COutPoint, Coin> mapBatchCoins;
+	vector<COutPoint> vecReserve;
+	for (unsigned int idx = 0; idx < jobs.size(); idx++) {
+		try {
+			const UniValue &job = jobs[idx];
+			if (!job.isObject())
+				throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "expected object with {\"asset\", \"address\" and \"recipients\"}");
+			const int nAsset = find_value(job.get_obj(), "asset").get_int();
+			const string &strAddress = find_value(job.get_obj(), "address").get_str();
+			vector<CRecipient> vecSend;
+			AssetAllocationSendRecipients(nAsset, strAddress, find_value(job.get_obj(), "recipients"), vecSend);
+			const UniValue &resHelper = syscointxfund_helper(strWitness, vecSend);
+			CMutableTransaction mtx;
+			if (!DecodeHexTx(mtx, resHelper[0].get_str(), true, false))
+				throw runtime_error("SYSCOIN_ASSET_ALLOCATION_RPC_ERROR: ERRCODE: 1504 - " + _("Could not decode transaction"));
+			CFundingCoins &coins = mapFunding[strAddress];
+			const int nChange = FundSyscoinTransaction(pwallet, mtx, strAddress, -1, coins, vecReserve);
+			// Inputs carry the script they spend until they are signed. Witness spends are signed
+			// with an empty scriptSig, so with only those the txid is final and later jobs can spend
+			// the change.
+			bool fFinalTxid = true;
+			for (CTxIn &txin : mtx.vin) {
+				int witnessVersion;
+				vector<unsigned char> witnessProgram;
+				if (txin.scriptSig.IsWitnessProgram(witnessVersion, witnessProgram))
+					txin.scriptSig.clear();
+				else
+					fFinalTxid = false;
+			}
+			if (nChange >= 0 && fFinalTxid) {
+				const COutPoint changeOutPoint(mtx.GetHash(), nChange);
+				coins.vecCoins.emplace(coins.vecCoins.begin(), changeOutPoint, mtx.vout[nChange].nValue);
+				coins.setUnconfirmed.insert(changeOutPoint);
+				mapBatchCoins[changeOutPoint] = Coin(mtx.vout[nChange], MEMPOOL_HEIGHT, false);
+			}
+			vecJobTx[idx] = signer->vTxs.size();
+			signer->vTxs.push_back(std::move(mtx));
+		}
+		catch (const UniValue& objError) {
+			vecErrors[idx] = find_value(objError, "message").get_str();
+		}
+		catch (const std::exception& e) {
+			vecErrors[idx] = e.what();
+		}
+	}
+	if (paddresscoincache)
+		paddresscoincache->Reserve(vecReserve, GetTime());
+
+	// look up the coins every input spends, then sign with the thread pool
+	signer->vCoins.resize(signer->vTxs.size());
+	signer->vComplete.resize(signer->vTxs.size(), 0);
+	signer->vErrors.resize(signer->vTxs.size());
+	{
+		LOCK2(cs_main, mempool.cs);
+		CCoinsViewMemPool viewMempool(pcoinsTip.get(), mempool);
+		for (size_t nTx = 0; nTx < signer->vTxs.size(); nTx++) {
+			const CMutableTransaction &mtx = signer->vTxs[nTx];
+			signer->vCoins[nTx].resize(mtx.vin.size());
+			for (unsigned int i = 0; i < mtx.vin.size(); i++) {
+				if (viewMempool.GetCoin(mtx.vin[i].prevout, signer->vCoins[nTx][i]))
+					continue;
+				auto it = mapBatchCoins.find(mtx.vin[i].prevout);
+				if (it != mapBatchCoins.end())
+					signer->vCoins[nTx][i] = it->second;
+				else
+					signer->vCoins[nTx][i].Clear();
+			}
+		}
+	}
+	signer->nTasks = signer->vTxs.size();
+	if (threadpool != nullptr) {
+		const size_t nWorkers = std::min<size_t>(GetNumCores(), signer->nTasks);
+		for (size_t i = 1; i < nWorkers; i++) {
+			if (!threadpool->tryPost([signer] { signer->Run(); }))
+				break;
+		}
+	}
+	signer->Run();
+	{
+		std::unique_lock<std::mutex> lock(signer->mutex);
+		signer->cond.wait(lock, [&signer] { return signer->nDone == signer->nTasks; });
+	}
+	for (unsigned int idx = 0; idx < jobs.size(); idx++) {
+		if (vecErrors[idx].empty() && !signer->vErrors[vecJobTx[idx]].empty())
+			vecErrors[idx] = signer->vErrors[vecJobTx[idx]];
+	}
+
+	if (fBroadcast) {
+		// verify the scripts of everything about to be sent in one go
+		vector<CTransactionRef> vecPackage;
+		vector<size_t> vecPackageTx;
+		for (size_t nTx = 0; nTx < signer->vTxs.size(); nTx++) {
+			if (signer->vComplete[nTx]) {
+				vecPackage.push_back(MakeTransactionRef(signer->vTxs[nTx]));
+				vecPackageTx.push_back(nTx);
+			}
+		}
+		vector<bool> vecInvalid;
+		CheckPackageScripts(vecPackage, vecInvalid);
+		// report the jobs whose scripts failed instead of sending them
+		for (unsigned int idx = 0; idx < jobs.size(); idx++) {
+			if (!vecErrors[idx].empty())
+				continue;
+			for (size_t i = 0; i < vecPackage.size(); i++) {
+				if (vecInvalid[i] && vecPackageTx[i] == vecJobTx[idx]) {
+					vecErrors[idx] = _("Script verification failed");
+					break;
+				}
+			}
+		}
+	}
+
+	UniValue res(UniValue::VARR);
+	for (unsigned int idx = 0; idx < jobs.size(); idx++) {
+		UniValue entry(UniValue::VOBJ);
+		if (vecErrors[idx].empty()) {
+			const CMutableTransaction &mtx = signer->vTxs[vecJobTx[idx]];
+			const bool fComplete = signer->vComplete[vecJobTx[idx]];
+			const string &strHex = EncodeHexTx(mtx);
+			entry.pushKV("txid", mtx.GetHash().GetHex());
+			entry.pushKV("hex", strHex);
+			entry.pushKV("complete", fComplete);
+			if (fBroadcast && fComplete) {
+				try {
+					JSONRPCRequest requestSend;
+					requestSend.params = UniValue(UniValue::VARR);
+					requestSend.params.push_back(strHex);
+					sendrawtransaction(requestSend);
+				}
+				catch (const UniValue& objError) {
+					entry.pushKV("error", find_value(objError, "message").get_str());
+				}
+				catch (const std::exception& e) {
+					entry.pushKV("error", string(e.what()));
+				}
+			}
+		}
+		else
+			entry.pushKV("error", vecErrors[idx]);
+		res.push_back(entry);
+	}
+	return res;
+}
+
 
 UniValue assetallocationinfo(const JSONRPCRequest& request) {
 	const UniValue &params = request.params;
@@ -1116,7 +1470,7 @@ UniValue assetallocationinfo(const JSONRPCRequest& request) {
 	UniValue oAssetAllocation(UniValue::VOBJ);
 	const CAssetAllocationTuple assetAllocationTuple(nAsset, CWitnessAddress(witnessVersion, strAddressFrom == "burn"? vchFromString("burn"): ParseHex(witnessProgramHex)));
 	CAssetAllocation txPos;
-	if (passetallocationdb == nullptr || !passetallocationdb->ReadAssetAllocation(assetAllocationTuple, txPos))
+	if (!GetAssetAllocation(assetAllocationTuple, txPos))
 		throw runtime_error("SYSCOIN_ASSET_ALLOCATION_RPC_ERROR: ERRCODE: 1507 - " + _("Failed to read from assetallocation DB"));
 
 	CAsset theAsset;
@@ -1135,7 +1489,7 @@ int DetectPotentialAssetAllocationSenderConflicts(const CAssetAllocationTuple& a
 	// The idea is that real-time spending amounts can in some cases overrun the POW balance safely whereas in some cases some of the spends are 
 	// put in another block due to not using enough fees or for other reasons that miners don't mine them.
 	// We just want to flag them as level 1 so it warrants deeper investigation on receiver side if desired (if fund amounts being transferred are not negligible)
-	if (passetallocationdb == nullptr || !passetallocationdb->ReadAssetAllocation(assetAllocationTupleSender, dbAssetAllocation))
+	if (!GetAssetAllocation(assetAllocationTupleSender, dbAssetAllocation))
 		return ZDAG_NOT_FOUND;
         
 
@@ -1434,7 +1788,7 @@ std::vector<std::string> vecIntersection(std::vector<std::string> &v1,
                           back_inserter(v3));
     return v3;
 }
-bool CAssetAllocationTransactionsDB::ScanAssetAllocationIndex(const int count, const int from, const UniValue& oOptions, UniValue& oRes) {
+bool CAssetAllocationTransactionsDB::ScanAssetAllocationIndex(const int count, const int from, const UniValue& oOptions, RPCResultArray& oRes) {
 	string strTxid = "";
 	vector<string> vecSenders;
 	vector<string> vecReceivers;
@@ -1560,22 +1914,11 @@ bool CAssetAllocationMempoolDB::ScanAssetAllocationMempoolBalances(const int cou
     }
     return true;
 }
-bool CAssetAllocationDB::Flush(const AssetAllocationMap &mapAssetAllocations){
-    if(mapAssetAllocations.empty())
-        return true;
-    CDBBatch batch(*this);
-    for (const auto &key : mapAssetAllocations) {
-        if(key.second.IsNull()){
-            batch.Erase(key.second.assetAllocationTuple);
-        }
-        else{
-            batch.Write(key.second.assetAllocationTuple, key.second);
-        }
-    }
-    LogPrint(BCLog::SYS, "Flushing %d asset allocations\n", mapAssetAllocations.size());
-    return WriteBatch(batch);
+void UpdateAssetAllocationCache(const AssetAllocationMap &mapAssetAllocations){
+    for (const auto &key : mapAssetAllocations)
+        passetallocationcache->Write(key.second.assetAllocationTuple, key.second);
 }
-bool CAssetAllocationDB::ScanAssetAllocations(const int count, const int from, const UniValue& oOptions, UniValue& oRes) {
+bool CAssetAllocationDB::ScanAssetAllocations(const CDBSnapshot& snapshot, const CDBSnapshot& assetSnapshot, const int count, const int from, const UniValue& oOptions, RPCResultArray& oRes) {
 	string strTxid = "";
 	vector<CWitnessAddress> vecWitnessAddresses;
 	uint32_t nAsset = 0;
@@ -1604,7 +1947,7 @@ bool CAssetAllocationDB::ScanAssetAllocations(const int count, const int from, c
 		}
 	}
 
-	boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+	boost::scoped_ptr<CDBIterator> pcursor(snapshot.NewIterator());
 	pcursor->SeekToFirst();
 	CAssetAllocation txPos;
     CAssetAllocationTuple key;
@@ -1620,7 +1963,7 @@ bool CAssetAllocationDB::ScanAssetAllocations(const int count, const int from, c
 					pcursor->Next();
 					continue;
 				}
-                if (!GetAsset(key.nAsset, theAsset))
+                if (!assetSnapshot.Read(key.nAsset, theAsset))
                 {
                     pcursor->Next();
                     continue;
@@ -1692,10 +2035,11 @@ UniValue listassetallocationtransactions(const JSONRPCRequest& request) {
 	if (!fAssetAllocationIndex) {
 		throw runtime_error("SYSCOIN_ASSET_ALLOCATION_RPC_ERROR: ERRCODE: 1509 - " + _("Asset allocation index not enabled, you must enable -assetallocationindex as a startup parameter or through syscoin.conf file to use this function.")); 
 	}
-	UniValue oRes(UniValue::VARR);
+	// SYSCOIN stream the result if the transport allows it
+	RPCResultArray oRes(request);
 	if (!passetallocationtransactionsdb->ScanAssetAllocationIndex(count, from, options, oRes))
 		throw runtime_error("SYSCOIN_ASSET_ALLOCATION_RPC_ERROR: ERRCODE: 1509 - " + _("Scan failed"));
-	return oRes;
+	return oRes.get();
 }
 UniValue listassetallocations(const JSONRPCRequest& request) {
 	const UniValue &params = request.params;
@@ -1741,10 +2085,15 @@ UniValue listassetallocations(const JSONRPCRequest& request) {
 	if (params.size() > 2) {
 		options = params[2];
 	}
-	UniValue oRes(UniValue::VARR);
-	if (!passetallocationdb->ScanAssetAllocations(count, from, options, oRes))
+	// SYSCOIN stream the result if the transport allows it
+	RPCResultArray oRes(request);
+	// SYSCOIN scan a snapshot of the databases so block processing is not held up
+	std::unique_ptr<CDBSnapshot> assetSnapshot, assetAllocationSnapshot;
+	if (!GetAssetSnapshots(assetSnapshot, assetAllocationSnapshot))
+		throw runtime_error("SYSCOIN_ASSET_ALLOCATION_RPC_ERROR: ERRCODE: 1510 - " + _("Failed to read from assetallocation DB"));
+	if (!passetallocationdb->ScanAssetAllocations(*assetAllocationSnapshot, *assetSnapshot, count, from, options, oRes))
 		throw runtime_error("SYSCOIN_ASSET_ALLOCATION_RPC_ERROR: ERRCODE: 1510 - " + _("Scan failed"));
-	return oRes;
+	return oRes.get();
 }
 UniValue listassetallocationmempoolbalances(const JSONRPCRequest& request) {
     const UniValue &params = request.params;
@@ -15,6 +15,7 @@ class CReserveKey;
 class CCoinsViewCache;
 class CBlock;
 class CAsset;
+class RPCResultArray;
 class CMintSyscoin;
 bool DecodeAssetAllocationTx(const CTransaction& tx, int& op, std::vector<std::vector<unsigned char> >& vvch);
 bool DecodeAndParseAssetAllocationTx(const CTransaction& tx, int& op, std::vector<std::vector<unsigned char> >& vvch, char& type);
@@ -203,10 +204,9 @@ public:
     bool ReadAssetAllocation(const CAssetAllocationTuple& assetAllocationTuple, CAssetAllocation& assetallocation) {
         return Read(assetAllocationTuple, assetallocation);
     }
-    bool Flush(const AssetAllocationMap &mapAssetAllocations);
 	void WriteAssetAllocationIndex(const int& op, const CTransaction &tx, const CAsset& dbAsset, const bool& confirmed, int nHeight);
     void WriteMintIndex(const CTransaction& tx, const CMintSyscoin& mintSyscoin, const int &nHeight);
-	bool ScanAssetAllocations(const int count, const int from, const UniValue& oOptions, UniValue& oRes);
+	bool ScanAssetAllocations(const CDBSnapshot& snapshot, const CDBSnapshot& assetSnapshot, const int count, const int from, const UniValue& oOptions, RPCResultArray& oRes);
 };
 class CAssetAllocationTransactionsDB : public CDBWrapper {
 public:
@@ -220,7 +220,7 @@ public:
 	bool ReadAssetAllocationWalletIndex(AssetAllocationIndexItemMap &valueMap) {
 		return Read(std::string("assetallocationtxi"), valueMap);
 	}
-	bool ScanAssetAllocationIndex(const int count, const int from, const UniValue& oOptions, UniValue& oRes);
+	bool ScanAssetAllocationIndex(const int count, const int from, const UniValue& oOptions, RPCResultArray& oRes);
 };
 class CAssetAllocationMempoolDB : public CDBWrapper {
 public:
@@ -244,6 +244,7 @@ public:
 static CAssetAllocation emptyAllocation;
 bool CheckAssetAllocationInputs(const CTransaction &tx, const CCoinsViewCache &inputs, int op, const std::vector<std::vector<unsigned char> > &vvchArgs, bool fJustCheck, int nHeight, AssetAllocationMap &mapAssetAllocations, std::string &errorMessage, bool& bOverflow, bool bSanityCheck = false, bool bMiner = false);
 bool GetAssetAllocation(const CAssetAllocationTuple& assetAllocationTuple,CAssetAllocation& txPos);
+void UpdateAssetAllocationCache(const AssetAllocationMap &mapAssetAllocations);
 bool BuildAssetAllocationJson(const CAssetAllocation& assetallocation, const CAsset& asset, UniValue& oName);
 bool ResetAssetAllocation(const std::string &senderStr, const uint256 &txHash, const bool &bMiner=false, const bool &bExpiryOnly=false);
 void ResyncAssetAllocationStates();
@@ -0,0 +1,268 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_SERVICES_ASSETCACHE_H
+#define SYSCOIN_SERVICES_ASSETCACHE_H
+
+#include <clientversion.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <memusage.h>
+#include <streams.h>
+#include <sync.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** A record held by CAssetDBCache, in its database serialization. */
+struct CAssetCacheEntry
+{
+    std::vector<unsigned char> vchValue; //!< Empty if the record does not exist
+    unsigned char flags;
+
+    enum Flags {
+        DIRTY = (1 << 0), //!< This entry differs from the database
+        FRESH = (1 << 1), //!< The database does not have this record
+    };
+
+    CAssetCacheEntry() : flags(0) {}
+};
+
+/**
+ * Cache in front of the asset or the asset allocation database, shared by
+ * block connection, mempool acceptance and the miner.
+ *
+ * Block (dis)connection applies its changes with Write() instead of writing a
+ * database batch per block. The changes reach the database when the
+ * chainstate is flushed, in the same FlushStateToDisk() call, so both
+ * databases describe the same block after a crash. Records that are missing
+ * from the database are cached as well, and as in CCoinsViewCache an entry
+ * is DIRTY when it must be written and FRESH when the database does not have
+ * it, so that a record created and erased between two flushes never touches
+ * the database.
+ *
+ * CAsset and CAssetAllocation are move-only, so records are kept in their
+ * serialized form and deserialized into the caller's object on each lookup.
+ */
+template <typename V>
+class CAssetDBCache
+{
+private:
+    typedef std::unordered_map<std::string, CAssetCacheEntry> EntryMap;
+
+    mutable CCriticalSection cs;
+    CDBWrapper& db;
+    const std::string strName;
+    mutable EntryMap cacheEntries;
+    //! Dynamically allocated memory of the cached keys and records
+    mutable size_t cachedRecordsUsage;
+    size_t nDirty;
+
+    template <typename K>
+    static std::string SerializeKey(const K& key)
+    {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << key;
+        return std::string(ssKey.begin(), ssKey.end());
+    }
+
+    static size_t RecordUsage(const std::string& strKey, const CAssetCacheEntry& entry)
+    {
+        return memusage::MallocUsage(strKey.capacity()) + memusage::DynamicUsage(entry.vchValue);
+    }
+
+    void SetFlags(CAssetCacheEntry& entry, unsigned char flags)
+    {
+        if ((entry.flags & CAssetCacheEntry::DIRTY) && !(flags & CAssetCacheEntry::DIRTY))
+            nDirty--;
+        else if (!(entry.flags & CAssetCacheEntry::DIRTY) && (flags & CAssetCacheEntry::DIRTY))
+            nDirty++;
+        entry.flags = flags;
+    }
+
+public:
+    CAssetDBCache(CDBWrapper& dbIn, const std::string& strNameIn) : db(dbIn), strName(strNameIn), cachedRecordsUsage(0), nDirty(0) {}
+
+    CAssetDBCache(const CAssetDBCache&) = delete;
+    CAssetDBCache& operator=(const CAssetDBCache&) = delete;
+
+    /** Look a record up, reading it from the database on a cache miss. value is left untouched if the record does not exist. */
+    template <typename K>
+    bool Read(const K& key, V& value) const
+    {
+        const std::string strKey = SerializeKey(key);
+        LOCK(cs);
+        auto it = cacheEntries.find(strKey);
+        if (it == cacheEntries.end()) {
+            CAssetCacheEntry entry;
+            const bool fFound = db.Read(key, value);
+            if (fFound) {
+                CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+                ssValue << value;
+                entry.vchValue.assign(ssValue.begin(), ssValue.end());
+            } else {
+                entry.flags = CAssetCacheEntry::FRESH;
+            }
+            it = cacheEntries.emplace(strKey, std::move(entry)).first;
+            cachedRecordsUsage += RecordUsage(it->first, it->second);
+            return fFound;
+        }
+        const std::vector<unsigned char>& vchValue = it->second.vchValue;
+        if (vchValue.empty())
+            return false;
+        CSpanReader(SER_DISK, CLIENT_VERSION, vchValue.data(), vchValue.size()) >> value;
+        return true;
+    }
+
+    /**
+     * Load the records of the given keys that are not cached yet, with one
+     * ReadMany() pass over the database instead of a lookup per key.
+     */
+    template <typename K>
+    void Prefetch(const std::vector<K>& keys) const
+    {
+        std::vector<std::string> vMissing;
+        LOCK(cs);
+        for (const K& key : keys) {
+            std::string strKey = SerializeKey(key);
+            if (!cacheEntries.count(strKey))
+                vMissing.push_back(std::move(strKey));
+        }
+        if (vMissing.empty())
+            return;
+        // The keys are serialized already; have them written as they are
+        std::vector<CFlatData> vKeys;
+        vKeys.reserve(vMissing.size());
+        for (const std::string& strKey : vMissing)
+            vKeys.emplace_back((void*)strKey.data(), (void*)(strKey.data() + strKey.size()));
+        std::vector<V> vValues;
+        std::vector<bool> vFound;
+        db.ReadMany(vKeys, vValues, vFound);
+        for (size_t i = 0; i < vMissing.size(); i++) {
+            CAssetCacheEntry entry;
+            if (vFound[i]) {
+                CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+                ssValue << vValues[i];
+                entry.vchValue.assign(ssValue.begin(), ssValue.end());
+            } else {
+                entry.flags = CAssetCacheEntry::FRESH;
+            }
+            auto ret = cacheEntries.emplace(std::move(vMissing[i]), std::move(entry));
+            if (ret.second)
+                cachedRecordsUsage += RecordUsage(ret.first->first, ret.first->second);
+        }
+    }
+
+    /** Store a record, or erase it if it is null. */
+    template <typename K>
+    void Write(const K& key, const V& value)
+    {
+        std::string strKey = SerializeKey(key);
+        LOCK(cs);
+        auto it = cacheEntries.find(strKey);
+        if (it == cacheEntries.end()) {
+            // Whether the database has the record is unknown, so an erase
+            // must reach it
+            it = cacheEntries.emplace(std::move(strKey), CAssetCacheEntry()).first;
+        } else {
+            cachedRecordsUsage -= RecordUsage(it->first, it->second);
+        }
+        CAssetCacheEntry& entry = it->second;
+        if (value.IsNull()) {
+            std::vector<unsigned char>().swap(entry.vchValue);
+            // Nothing to erase if the database never had it
+            if (entry.flags & CAssetCacheEntry::FRESH)
+                SetFlags(entry, CAssetCacheEntry::FRESH);
+            else
+                SetFlags(entry, entry.flags | CAssetCacheEntry::DIRTY);
+        } else {
+            CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+            ssValue << value;
+            entry.vchValue.assign(ssValue.begin(), ssValue.end());
+            SetFlags(entry, entry.flags | CAssetCacheEntry::DIRTY);
+        }
+        cachedRecordsUsage += RecordUsage(it->first, entry);
+    }
+
+    /**
+     * Write all dirty records to the database in one batch. With fErase the
+     * cache is emptied afterwards, otherwise the records stay cached.
+     */
+    bool Flush(bool fErase = true)
+    {
+        LOCK(cs);
+        if (nDirty > 0) {
+            CDBBatch batch(db);
+            for (auto& item : cacheEntries) {
+                if (!(item.second.flags & CAssetCacheEntry::DIRTY))
+                    continue;
+                // Keys and values are already serialized; write them as they are
+                const CFlatData key((void*)item.first.data(), (void*)(item.first.data() + item.first.size()));
+                if (item.second.vchValue.empty())
+                    batch.Erase(key);
+                else
+                    batch.Write(key, CFlatData(item.second.vchValue));
+            }
+            LogPrint(BCLog::SYS, "Flushing %d %s\n", nDirty, strName);
+            if (!db.WriteBatch(batch))
+                return false;
+            for (auto& item : cacheEntries) {
+                if (item.second.flags & CAssetCacheEntry::DIRTY)
+                    SetFlags(item.second, item.second.vchValue.empty() ? CAssetCacheEntry::FRESH : 0);
+            }
+            assert(nDirty == 0);
+        }
+        if (fErase) {
+            EntryMap().swap(cacheEntries);
+            cachedRecordsUsage = 0;
+        }
+        return true;
+    }
+
+    /**
+     * Take a view of the database with the changes that have not been
+     * written yet laid over it, so that it describes the cached state
+     * without flushing the cache.
+     */
+    std::unique_ptr<CDBSnapshot> GetSnapshot(const uint256& hashBlock) const
+    {
+        std::unique_ptr<CDBSnapshot> snapshot;
+        CDBSnapshot::Overlay overlay;
+        {
+            LOCK(cs);
+            // Flush() writes under the same lock, so the view and the dirty
+            // records describe the same state
+            snapshot = db.GetSnapshot(hashBlock);
+            for (const auto& item : cacheEntries) {
+                if (item.second.flags & CAssetCacheEntry::DIRTY)
+                    overlay.emplace(item.first, item.second.vchValue);
+            }
+        }
+        snapshot->SetOverlay(std::move(overlay));
+        return snapshot;
+    }
+
+    /** Whether there are changes that have not been written to the database. */
+    bool IsDirty() const
+    {
+        LOCK(cs);
+        return nDirty > 0;
+    }
+
+    size_t GetCacheSize() const
+    {
+        LOCK(cs);
+        return cacheEntries.size();
+    }
+
+    size_t DynamicMemoryUsage() const
+    {
+        LOCK(cs);
+        return memusage::DynamicUsage(cacheEntries) + cachedRecordsUsage;
+    }
+};
+
+#endif // SYSCOIN_SERVICES_ASSETCACHE_H
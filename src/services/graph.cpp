@@ -4,13 +4,12 @@
 #include "base58.h"
 #include "validation.h"
 using namespace std;
-extern ArrivalTimesMapImpl arrivalTimesMap;
 bool OrderBasedOnArrivalTime(std::vector<CTransactionRef>& blockVtx) {
 	std::vector<vector<unsigned char> > vvchArgs;
 	std::vector<CTransactionRef> orderedVtx;
 	int op;
 	AssertLockHeld(cs_main);
-	CCoinsViewCache view(pcoinsTip.get());
+	LOCK(mempool.cs);
 	// order the arrival times in ascending order using a map
 	std::multimap<int64_t, int> orderedIndexes;
 	for (unsigned int n = 0; n < blockVtx.size(); n++) {
@@ -20,19 +19,18 @@ bool OrderBasedOnArrivalTime(std::vector<CTransactionRef>& blockVtx) {
 		const CTransaction &tx = *txRef;
 		if (tx.nVersion == SYSCOIN_TX_VERSION_ASSET)
 		{
+			// asset allocation sends in the mempool are indexed with their arrival time, those
+			// without one (NO_ASSET_ALLOCATION_ARRIVAL) must be rejected via consensus and go to the end
+			CTxMemPool::indexed_arrival_set::const_iterator it = mempool.mapAssetAllocationArrivals.find(tx.GetHash());
+			if (it != mempool.mapAssetAllocationArrivals.end())
+			{
+				orderedIndexes.insert(make_pair(it->nArrivalTime, n));
+				continue;
+			}
+			// not in the mempool at all, also add it to the end
 			if (DecodeAssetAllocationTx(tx, op, vvchArgs))
 			{
-				LOCK(cs_assetallocationarrival);
-				
-				CAssetAllocation assetallocation(tx);
-				ArrivalTimesMap &arrivalTimes = arrivalTimesMap[assetallocation.assetAllocationTuple.ToString()];
-
-				ArrivalTimesMap::iterator it = arrivalTimes.find(tx.GetHash());
-				if (it != arrivalTimes.end())
-					orderedIndexes.insert(make_pair((*it).second, n));
-				// we don't have this in our arrival times list, means it must be rejected via consensus so add it to the end
-				else
-					orderedIndexes.insert(make_pair(INT64_MAX, n));
+				orderedIndexes.insert(make_pair(INT64_MAX, n));
 				continue;
 			}
 		}
@@ -445,6 +445,55 @@ public:
 
 
 
+/** Minimal stream for reading from a byte span owned by someone else,
+ * e.g. a memory-mapped file, without copying it first.
+ *
+ * The span must outlive the reader.
+ */
+class CSpanReader
+{
+private:
+    const int nType;
+    const int nVersion;
+    const unsigned char* const pbegin;
+    const size_t nSize;
+    size_t nPos;
+
+public:
+    CSpanReader(int nTypeIn, int nVersionIn, const unsigned char* pbeginIn, size_t nSizeIn)
+        : nType(nTypeIn), nVersion(nVersionIn), pbegin(pbeginIn), nSize(nSizeIn), nPos(0) {}
+
+    template<typename T>
+    CSpanReader& operator>>(T& obj)
+    {
+        // Unserialize from this stream
+        ::Unserialize(*this, obj);
+        return (*this);
+    }
+
+    int GetType() const { return nType; }
+    int GetVersion() const { return nVersion; }
+    size_t size() const { return nSize - nPos; }
+    bool empty() const { return nPos == nSize; }
+
+    void read(char* dst, size_t n)
+    {
+        if (n > nSize - nPos) {
+            throw std::ios_base::failure("CSpanReader::read(): end of data");
+        }
+        memcpy(dst, pbegin + nPos, n);
+        nPos += n;
+    }
+
+    void ignore(size_t n)
+    {
+        if (n > nSize - nPos) {
+            throw std::ios_base::failure("CSpanReader::ignore(): end of data");
+        }
+        nPos += n;
+    }
+};
+
 /** Non-refcounted RAII wrapper for FILE*
  *
  * Will automatically close the file when it goes out of scope if not null.
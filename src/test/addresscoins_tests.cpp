@@ -0,0 +1,143 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <services/addresscoins.h>
+#include <test/test_syscoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(addresscoins_tests, BasicTestingSetup)
+
+namespace {
+/** Makes the validation callbacks callable from the test */
+class TestAddressCoinCache : public CAddressCoinCache
+{
+public:
+    using CAddressCoinCache::TransactionAddedToMempool;
+    using CAddressCoinCache::BlockConnected;
+    using CAddressCoinCache::BlockDisconnected;
+};
+
+CScript AddressScript(unsigned char n)
+{
+    return CScript() << OP_0 << std::vector<unsigned char>(20, n);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(addresscoins_block_events)
+{
+    TestAddressCoinCache cache;
+    const CScript scriptA = AddressScript(1);
+    const CScript scriptB = AddressScript(2);
+    std::vector<CAddressCoinCache::AddressCoin> vCoins;
+    BOOST_CHECK(!cache.GetCoins(scriptA, vCoins));
+
+    const COutPoint outpoint1(InsecureRand256(), 0);
+    cache.AddAddress(scriptA, {{outpoint1, 10}});
+    BOOST_CHECK(cache.GetCoins(scriptA, vCoins));
+    BOOST_CHECK_EQUAL(vCoins.size(), 1U);
+
+    // A block spending the known coin and paying both addresses; only A is tracked
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(50, scriptA);
+    CMutableTransaction spend;
+    spend.vin.emplace_back(outpoint1);
+    spend.vout.emplace_back(3, scriptB);
+    spend.vout.emplace_back(7, scriptA);
+    auto block = std::make_shared<CBlock>();
+    block->vtx.push_back(MakeTransactionRef(coinbase));
+    block->vtx.push_back(MakeTransactionRef(spend));
+    cache.BlockConnected(block, nullptr, {});
+
+    BOOST_CHECK(cache.GetCoins(scriptA, vCoins));
+    BOOST_CHECK_EQUAL(vCoins.size(), 2U);
+    for (const auto& coin : vCoins) {
+        BOOST_CHECK(coin.first != outpoint1);
+        if (coin.first.hash == block->vtx[0]->GetHash())
+            BOOST_CHECK_EQUAL(coin.second, 50);
+        else
+            BOOST_CHECK(coin.first == COutPoint(block->vtx[1]->GetHash(), 1) && coin.second == 7);
+    }
+    BOOST_CHECK(!cache.GetCoins(scriptB, vCoins));
+
+    cache.Spend(COutPoint(block->vtx[1]->GetHash(), 1));
+    BOOST_CHECK(cache.GetCoins(scriptA, vCoins));
+    BOOST_CHECK_EQUAL(vCoins.size(), 1U);
+
+    // A reorg forgets everything
+    cache.BlockDisconnected(block);
+    BOOST_CHECK(!cache.GetCoins(scriptA, vCoins));
+    BOOST_CHECK_EQUAL(cache.AddressCount(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(addresscoins_pending_scan)
+{
+    TestAddressCoinCache cache;
+    const CScript scriptA = AddressScript(1);
+    std::vector<CAddressCoinCache::AddressCoin> vCoins;
+    const COutPoint outpoint1(InsecureRand256(), 0);
+    const COutPoint outpoint2(InsecureRand256(), 0);
+
+    // A block paying the address and spending one of its coins connects during the scan
+    cache.BeginAddress(scriptA);
+    CMutableTransaction spend;
+    spend.vin.emplace_back(outpoint1);
+    spend.vout.emplace_back(5, scriptA);
+    auto block = std::make_shared<CBlock>();
+    block->vtx.push_back(MakeTransactionRef(spend));
+    cache.BlockConnected(block, nullptr, {});
+    BOOST_CHECK(!cache.GetCoins(scriptA, vCoins));
+
+    // The scan saw the chain before the block
+    cache.AddAddress(scriptA, {{outpoint1, 10}, {outpoint2, 20}});
+    BOOST_CHECK(cache.GetCoins(scriptA, vCoins));
+    BOOST_CHECK_EQUAL(vCoins.size(), 2U);
+    for (const auto& coin : vCoins)
+        BOOST_CHECK(coin.first == outpoint2 || (coin.first == COutPoint(block->vtx[0]->GetHash(), 0) && coin.second == 5));
+
+    // A reorg during the scan leaves the address to be scanned again
+    const CScript scriptB = AddressScript(2);
+    cache.BeginAddress(scriptB);
+    cache.BlockDisconnected(block);
+    cache.AddAddress(scriptB, {{outpoint2, 20}});
+    BOOST_CHECK(!cache.GetCoins(scriptB, vCoins));
+}
+
+BOOST_AUTO_TEST_CASE(addresscoins_reservations)
+{
+    TestAddressCoinCache cache;
+    const COutPoint outpoint1(InsecureRand256(), 0);
+    const COutPoint outpoint2(InsecureRand256(), 1);
+    const int64_t nNow = 1000000;
+    cache.Reserve({outpoint1, outpoint2}, nNow);
+    BOOST_CHECK(cache.IsReserved(outpoint1, nNow));
+    BOOST_CHECK(cache.IsReserved(outpoint2, nNow + FUNDING_RESERVATION_SECONDS - 1));
+    BOOST_CHECK(!cache.IsReserved(outpoint2, nNow + FUNDING_RESERVATION_SECONDS));
+
+    // The mempool takes over once the spend shows up
+    CMutableTransaction spend;
+    spend.vin.emplace_back(outpoint1);
+    cache.TransactionAddedToMempool(MakeTransactionRef(spend));
+    BOOST_CHECK(!cache.IsReserved(outpoint1, nNow));
+    BOOST_CHECK(cache.IsReserved(outpoint2, nNow));
+}
+
+BOOST_AUTO_TEST_CASE(addresscoins_eviction)
+{
+    TestAddressCoinCache cache;
+    std::vector<CAddressCoinCache::AddressCoin> vCoins;
+    for (unsigned int n = 0; n <= MAX_FUNDING_ADDRESSES; n++) {
+        cache.AddAddress(AddressScript(n), {{COutPoint(InsecureRand256(), n), n + 1}});
+        // Keep the first address in use
+        BOOST_CHECK(cache.GetCoins(AddressScript(0), vCoins));
+    }
+    BOOST_CHECK_EQUAL(cache.AddressCount(), MAX_FUNDING_ADDRESSES);
+    BOOST_CHECK(cache.GetCoins(AddressScript(0), vCoins));
+    BOOST_CHECK(!cache.GetCoins(AddressScript(1), vCoins));
+    BOOST_CHECK(cache.GetCoins(AddressScript(MAX_FUNDING_ADDRESSES), vCoins));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <map>
+#include <arenamap.h>
+#include <memusage.h>
+#include <random.h>
+
+#include <test/test_syscoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(arenamap_tests, BasicTestingSetup)
+
+namespace {
+//! Poor hash to force long probe sequences and hash collisions
+struct CollidingHasher {
+    size_t operator()(uint32_t n) const { return n % 61; }
+};
+
+template <typename Hash>
+void CheckEqual(const arenamap<uint32_t, std::string, Hash>& map, const std::map<uint32_t, std::string>& real)
+{
+    BOOST_CHECK_EQUAL(map.size(), real.size());
+    size_t nIterated = 0;
+    for (const auto& entry : map) {
+        auto it = real.find(entry.first);
+        BOOST_CHECK(it != real.end());
+        BOOST_CHECK_EQUAL(it->second, entry.second);
+        nIterated++;
+    }
+    BOOST_CHECK_EQUAL(nIterated, real.size());
+    for (const auto& entry : real) {
+        auto it = map.find(entry.first);
+        BOOST_CHECK(it != map.end());
+        BOOST_CHECK_EQUAL(it->second, entry.second);
+    }
+}
+
+template <typename Hash>
+void RandomOperations()
+{
+    FastRandomContext rng(true);
+    arenamap<uint32_t, std::string, Hash> map;
+    std::map<uint32_t, std::string> real;
+    for (int i = 0; i < 20000; i++) {
+        const uint32_t key = rng.randrange(2000);
+        switch (rng.randrange(4)) {
+        case 0:
+        case 1: {
+            const std::string value = std::to_string(rng.rand32());
+            const bool fInserted = map.emplace(key, value).second;
+            BOOST_CHECK_EQUAL(fInserted, real.emplace(key, value).second);
+            break;
+        }
+        case 2:
+            BOOST_CHECK_EQUAL(map.erase(key), real.erase(key));
+            break;
+        case 3:
+            map[key] += "x";
+            real[key] += "x";
+            break;
+        }
+        BOOST_CHECK_EQUAL(map.count(key), real.count(key));
+    }
+    CheckEqual(map, real);
+
+    // Erase while iterating, as CCoinsViewDB::BatchWrite does
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->first % 3 == 0) {
+            real.erase(it->first);
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    CheckEqual(map, real);
+
+    arenamap<uint32_t, std::string, Hash> moved(std::move(map));
+    BOOST_CHECK(map.empty());
+    CheckEqual(moved, real);
+
+    moved.clear();
+    BOOST_CHECK(moved.empty());
+    BOOST_CHECK(moved.begin() == moved.end());
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(moved), 0U);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(arenamap_random)
+{
+    RandomOperations<std::hash<uint32_t>>();
+    RandomOperations<CollidingHasher>();
+}
+
+BOOST_AUTO_TEST_CASE(arenamap_references_stable)
+{
+    arenamap<uint32_t, std::string> map;
+    std::string& first = map[1];
+    first = "one";
+    // Grow the table and the arena many times over
+    for (uint32_t i = 2; i < 10000; i++)
+        map[i] = "many";
+    BOOST_CHECK_EQUAL(&first, &map.find(1)->second);
+    BOOST_CHECK_EQUAL(first, "one");
+    BOOST_CHECK(memusage::DynamicUsage(map) >= map.size() * sizeof(std::pair<const uint32_t, std::string>));
+}
+
+BOOST_AUTO_TEST_CASE(arenamap_at)
+{
+    arenamap<uint32_t, std::string> map;
+    map[1] = "one";
+    BOOST_CHECK_EQUAL(map.at(1), "one");
+    map.at(1) = "uno";
+    const arenamap<uint32_t, std::string>& constMap = map;
+    BOOST_CHECK_EQUAL(constMap.at(1), "uno");
+    BOOST_CHECK_THROW(map.at(2), std::out_of_range);
+    BOOST_CHECK_THROW(constMap.at(2), std::out_of_range);
+    BOOST_CHECK_EQUAL(map.size(), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
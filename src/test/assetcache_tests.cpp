@@ -0,0 +1,161 @@
+// Copyright (c) 2018 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dbwrapper.h>
+#include <services/asset.h>
+#include <services/assetcache.h>
+#include <test/test_syscoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(assetcache_tests, BasicTestingSetup)
+
+static CAssetAllocationTuple MakeTuple(uint32_t nAsset, unsigned char nProgram)
+{
+    return CAssetAllocationTuple(nAsset, CWitnessAddress(0, std::vector<unsigned char>(20, nProgram)));
+}
+
+static void MakeAllocation(CAssetAllocation& allocation, uint32_t nAsset, unsigned char nProgram, CAmount nBalance)
+{
+    allocation.assetAllocationTuple = MakeTuple(nAsset, nProgram);
+    allocation.nBalance = nBalance;
+}
+
+BOOST_AUTO_TEST_CASE(assetcache_write_back)
+{
+    CDBWrapper db(SetDataDir("assetcache"), 1 << 20, true, false);
+    CAssetAllocationCache cache(db, "asset allocations");
+
+    CAssetAllocation allocation;
+    MakeAllocation(allocation, 1, 1, 100);
+    BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+
+    // Read through the cache, then change the record in the cache only
+    CAssetAllocation read;
+    BOOST_CHECK(cache.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 100);
+    BOOST_CHECK(!cache.IsDirty());
+    MakeAllocation(allocation, 1, 1, 150);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+    BOOST_CHECK(cache.IsDirty());
+    BOOST_CHECK(cache.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 150);
+    BOOST_CHECK(db.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 100);
+
+    // Missing records are cached as missing; creating and erasing one never reaches the database
+    BOOST_CHECK(!cache.Read(MakeTuple(2, 2), read));
+    MakeAllocation(allocation, 2, 2, 5);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+    MakeAllocation(allocation, 2, 2, 0);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+    BOOST_CHECK(!cache.Read(MakeTuple(2, 2), read));
+
+    // Erasing a record the database has must reach it
+    MakeAllocation(allocation, 3, 3, 7);
+    BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+    MakeAllocation(allocation, 3, 3, 0);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+    BOOST_CHECK(cache.GetCacheSize() == 3);
+    BOOST_CHECK(cache.DynamicMemoryUsage() > 0);
+
+    // Flushing without erasing keeps the records cached and clean
+    BOOST_CHECK(cache.Flush(false));
+    BOOST_CHECK(!cache.IsDirty());
+    BOOST_CHECK(cache.GetCacheSize() == 3);
+    BOOST_CHECK(db.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 150);
+    BOOST_CHECK(!db.Exists(MakeTuple(2, 2)));
+    BOOST_CHECK(!db.Exists(MakeTuple(3, 3)));
+
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(cache.GetCacheSize() == 0);
+    BOOST_CHECK(cache.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 150);
+}
+
+BOOST_AUTO_TEST_CASE(assetcache_snapshot)
+{
+    CDBWrapper db(SetDataDir("assetcache_snapshot"), 1 << 20, true, false);
+    CAssetAllocationCache cache(db, "asset allocations");
+
+    CAssetAllocation allocation;
+    MakeAllocation(allocation, 1, 1, 100);
+    BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+    MakeAllocation(allocation, 1, 2, 200);
+    BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+
+    // Change one record, erase another and add a third in the cache only
+    MakeAllocation(allocation, 1, 1, 150);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+    MakeAllocation(allocation, 1, 2, 0);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+    MakeAllocation(allocation, 1, 3, 300);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+
+    // The view shows the cached state, and taking it writes nothing
+    std::unique_ptr<CDBSnapshot> snapshot = cache.GetSnapshot(uint256());
+    BOOST_CHECK(cache.IsDirty());
+    CAssetAllocation read;
+    BOOST_CHECK(db.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 100);
+    BOOST_CHECK(snapshot->Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 150);
+    BOOST_CHECK(!snapshot->Exists(MakeTuple(1, 2)));
+
+    std::unique_ptr<CDBIterator> it(snapshot->NewIterator());
+    CAmount nTotal = 0;
+    int nRecords = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        BOOST_CHECK(it->GetValue(read));
+        nTotal += read.nBalance;
+        nRecords++;
+    }
+    BOOST_CHECK_EQUAL(nRecords, 2);
+    BOOST_CHECK_EQUAL(nTotal, 450);
+
+    // Later flushes do not show through
+    BOOST_CHECK(cache.Flush());
+    MakeAllocation(allocation, 1, 1, 1);
+    BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+    BOOST_CHECK(snapshot->Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 150);
+}
+
+BOOST_AUTO_TEST_CASE(assetcache_prefetch)
+{
+    CDBWrapper db(SetDataDir("assetcache_prefetch"), 1 << 20, true, false);
+    CAssetAllocationCache cache(db, "asset allocations");
+
+    CAssetAllocation allocation;
+    for (unsigned char n = 1; n <= 3; n++) {
+        MakeAllocation(allocation, n, n, n * 10);
+        BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+    }
+    // A cached change is kept over what the database has
+    MakeAllocation(allocation, 2, 2, 25);
+    cache.Write(allocation.assetAllocationTuple, allocation);
+
+    std::vector<CAssetAllocationTuple> keys;
+    for (unsigned char n = 4; n > 0; n--)
+        keys.push_back(MakeTuple(n, n));
+    cache.Prefetch(keys);
+    BOOST_CHECK(cache.GetCacheSize() == 4);
+
+    // Lookups are served from the cache now, including the missing record
+    BOOST_CHECK(db.Erase(MakeTuple(1, 1)));
+    MakeAllocation(allocation, 4, 4, 40);
+    BOOST_CHECK(db.Write(allocation.assetAllocationTuple, allocation));
+    CAssetAllocation read;
+    BOOST_CHECK(cache.Read(MakeTuple(1, 1), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 10);
+    BOOST_CHECK(cache.Read(MakeTuple(2, 2), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 25);
+    BOOST_CHECK(cache.Read(MakeTuple(3, 3), read));
+    BOOST_CHECK_EQUAL(read.nBalance, 30);
+    BOOST_CHECK(!cache.Read(MakeTuple(4, 4), read));
+    BOOST_CHECK(cache.IsDirty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
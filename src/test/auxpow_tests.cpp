@@ -585,4 +585,48 @@ BOOST_FIXTURE_TEST_CASE (auxpow_miner_createAndLookupBlock, TestChain100Setup)
 
 /* ************************************************************************** */
 
+BOOST_FIXTURE_TEST_CASE (auxpow_skip, BasicTestingSetup)
+{
+  CBlock block;
+  block.SetBaseVersion (2, Params ().GetConsensus ().nAuxpowChainId);
+  block.nTime = 1234;
+
+  CMutableTransaction mtx;
+  mtx.vin.resize (1);
+  mtx.vin[0].scriptSig = CScript () << OP_TRUE;
+  mtx.vin[0].scriptWitness.stack.push_back (valtype (32, 0x42));
+  mtx.vout.resize (2);
+  mtx.vout[1].scriptPubKey = CScript () << OP_RETURN << valtype (40, 0x01);
+  block.vtx.push_back (MakeTransactionRef (std::move (mtx)));
+  block.hashMerkleRoot = BlockMerkleRoot (block);
+
+  CAuxPow::initAuxPow (block);
+  BOOST_CHECK (block.IsAuxpow () && block.auxpow);
+
+  CDataStream ss(SER_DISK, CLIENT_VERSION);
+  ss << block;
+
+  /* Skipping the auxpow leaves the rest of the block intact.  */
+  CDataStream ssStripped(ss.begin (), ss.end (), SER_DISK, CLIENT_VERSION | SERIALIZE_BLOCK_NO_AUXPOW);
+  CBlock stripped;
+  ssStripped >> stripped;
+  BOOST_CHECK (ssStripped.empty ());
+  BOOST_CHECK (!stripped.auxpow);
+  BOOST_CHECK_EQUAL (stripped.GetHash (), block.GetHash ());
+  BOOST_CHECK_EQUAL (stripped.vtx.size (), 1);
+  BOOST_CHECK_EQUAL (stripped.vtx[0]->GetWitnessHash (), block.vtx[0]->GetWitnessHash ());
+
+  /* Headers without auxpow are not affected.  */
+  CBlockHeader header = block.GetBlockHeader ();
+  header.SetAuxpow (nullptr);
+  CDataStream ssHeader(SER_DISK, CLIENT_VERSION | SERIALIZE_BLOCK_NO_AUXPOW);
+  ssHeader << header;
+  CBlockHeader header2;
+  ssHeader >> header2;
+  BOOST_CHECK (ssHeader.empty ());
+  BOOST_CHECK_EQUAL (header2.GetHash (), header.GetHash ());
+}
+
+/* ************************************************************************** */
+
 BOOST_AUTO_TEST_SUITE_END ()
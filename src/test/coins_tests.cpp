@@ -4,6 +4,9 @@
 
 #include <coins.h>
 #include <script/standard.h>
+#include <services/asset.h>
+#include <services/assetallocation.h>
+#include <txdb.h>
 #include <uint256.h>
 #include <undo.h>
 #include <utilstrencodings.h>
@@ -855,4 +858,150 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(coins_write_behind)
+{
+    CCoinsViewDB db(1 << 20, true, true);
+    CCoinsViewWriteBehind writebehind(&db);
+    CCoinsViewCache cache(&writebehind);
+
+    COutPoint outpoint(InsecureRand256(), 0);
+    Coin coin;
+    coin.out.nValue = 5;
+    coin.out.scriptPubKey = CScript() << OP_TRUE;
+    coin.nHeight = 1;
+    cache.AddCoin(outpoint, Coin(coin), false);
+    const uint256 hashFirst = InsecureRand256();
+    cache.SetBestBlock(hashFirst);
+    BOOST_CHECK(cache.Flush());
+
+    // The flushed state is visible whether or not the background write has completed
+    Coin result;
+    BOOST_CHECK(writebehind.GetCoin(outpoint, result));
+    BOOST_CHECK(result.out == coin.out);
+    BOOST_CHECK_EQUAL(result.nHeight, coin.nHeight);
+    BOOST_CHECK(writebehind.GetBestBlock() == hashFirst);
+    BOOST_CHECK(writebehind.Sync());
+    BOOST_CHECK(!writebehind.Writing());
+    BOOST_CHECK(db.HaveCoin(outpoint));
+    BOOST_CHECK(db.GetBestBlock() == hashFirst);
+
+    // Spending it hides the coin before the erase reaches the database
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    const uint256 hashSecond = InsecureRand256();
+    cache.SetBestBlock(hashSecond);
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(!writebehind.HaveCoin(outpoint));
+    BOOST_CHECK(!writebehind.GetCoin(outpoint, result));
+    BOOST_CHECK(!cache.HaveCoin(outpoint));
+    BOOST_CHECK(writebehind.Sync());
+    BOOST_CHECK(!db.HaveCoin(outpoint));
+    BOOST_CHECK(db.GetBestBlock() == hashSecond);
+}
+
+BOOST_AUTO_TEST_CASE(coins_write_behind_assets)
+{
+    CCoinsViewDB db(1 << 20, true, true);
+    CCoinsViewWriteBehind writebehind(&db);
+    CCoinsViewCache cache(&writebehind);
+    passetdb.reset(new CAssetDB(1 << 20, true, true));
+    passetallocationdb.reset(new CAssetAllocationDB(1 << 20, true, true));
+    passetcache.reset(new CAssetCache(*passetdb, "assets"));
+    passetallocationcache.reset(new CAssetAllocationCache(*passetallocationdb, "asset allocations"));
+
+    COutPoint outpoint(InsecureRand256(), 0);
+    Coin coin;
+    coin.out.nValue = 5;
+    coin.out.scriptPubKey = CScript() << OP_TRUE;
+    coin.nHeight = 1;
+    cache.AddCoin(outpoint, Coin(coin), false);
+    const uint256 hashFirst = InsecureRand256();
+    cache.SetBestBlock(hashFirst);
+    CAssetAllocation allocation;
+    allocation.assetAllocationTuple = CAssetAllocationTuple(1, CWitnessAddress(0, std::vector<unsigned char>(20, 1)));
+    allocation.nBalance = 100;
+    passetallocationcache->Write(allocation.assetAllocationTuple, allocation);
+
+    // Asset changes only reach their database once the coins of the same block are on disk
+    std::string strError;
+    BOOST_CHECK(FlushCoinsAndAssetCaches(cache, &writebehind, false, strError));
+    BOOST_CHECK(!writebehind.Writing());
+    BOOST_CHECK(db.HaveCoin(outpoint));
+    BOOST_CHECK(db.GetBestBlock() == hashFirst);
+    BOOST_CHECK(!AssetCachesDirty());
+    BOOST_CHECK(passetallocationdb->Exists(allocation.assetAllocationTuple));
+
+    // Without asset changes the coins may still be written in the background
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    const uint256 hashSecond = InsecureRand256();
+    cache.SetBestBlock(hashSecond);
+    BOOST_CHECK(FlushCoinsAndAssetCaches(cache, &writebehind, false, strError));
+    BOOST_CHECK(writebehind.GetBestBlock() == hashSecond);
+    BOOST_CHECK(writebehind.Sync());
+    BOOST_CHECK(!db.HaveCoin(outpoint));
+
+    // and are on disk on return when the caller asks for it
+    cache.AddCoin(outpoint, Coin(coin), false);
+    const uint256 hashThird = InsecureRand256();
+    cache.SetBestBlock(hashThird);
+    BOOST_CHECK(FlushCoinsAndAssetCaches(cache, &writebehind, true, strError));
+    BOOST_CHECK(!writebehind.Writing());
+    BOOST_CHECK(db.GetBestBlock() == hashThird);
+
+    passetallocationcache.reset();
+    passetcache.reset();
+    passetallocationdb.reset();
+    passetdb.reset();
+}
+
+BOOST_AUTO_TEST_CASE(coins_getcoins_warm)
+{
+    CCoinsViewDB db(1 << 20, true, true);
+    std::vector<COutPoint> outpoints;
+    {
+        CCoinsViewCache cache(&db);
+        for (uint32_t n = 0; n < 20; n++) {
+            outpoints.emplace_back(InsecureRand256(), n);
+            // Every other outpoint is never created
+            if (n % 2 != 0)
+                continue;
+            Coin coin;
+            coin.out.nValue = n + 1;
+            coin.out.scriptPubKey = CScript() << OP_TRUE;
+            coin.nHeight = n;
+            cache.AddCoin(outpoints.back(), std::move(coin), false);
+        }
+        cache.SetBestBlock(InsecureRand256());
+        BOOST_CHECK(cache.Flush());
+    }
+
+    // The batched lookup agrees with GetCoin
+    std::vector<Coin> coins;
+    BOOST_CHECK_EQUAL(db.GetCoins(outpoints, coins), 10U);
+    BOOST_CHECK_EQUAL(coins.size(), outpoints.size());
+    for (size_t i = 0; i < outpoints.size(); i++) {
+        Coin coin;
+        const bool fFound = db.GetCoin(outpoints[i], coin);
+        BOOST_CHECK_EQUAL(fFound, !coins[i].IsSpent());
+        if (fFound)
+            BOOST_CHECK(coins[i].out == coin.out && coins[i].nHeight == coin.nHeight);
+    }
+
+    // Warming adds clean entries for the unspent coins only, and keeps what is cached already
+    CCoinsViewCacheTest cache(&db);
+    cache.SpendCoin(outpoints[0]);
+    cache.Warm(outpoints, coins);
+    cache.SelfTest();
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 10U);
+    BOOST_CHECK(!cache.HaveCoin(outpoints[0]));
+    for (size_t i = 1; i < outpoints.size(); i++) {
+        BOOST_CHECK_EQUAL(cache.HaveCoinInCache(outpoints[i]), i % 2 == 0);
+        if (i % 2 == 0) {
+            auto it = cache.map().find(outpoints[i]);
+            BOOST_CHECK(it != cache.map().end());
+            if (it != cache.map().end())
+                BOOST_CHECK_EQUAL(it->second.flags, 0);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
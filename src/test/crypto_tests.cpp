@@ -562,4 +562,26 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d_multi)
+{
+    // Random lengths up to a few blocks, so that the different padding cases meet in the lanes
+    for (int count = 0; count <= 40; count += 5) {
+        std::vector<std::vector<unsigned char>> msgs(count);
+        std::vector<const unsigned char*> inputs(count);
+        std::vector<size_t> lengths(count);
+        for (int j = 0; j < count; ++j) {
+            msgs[j].resize(InsecureRandRange(300));
+            for (unsigned char& c : msgs[j]) c = InsecureRandBits(8);
+            inputs[j] = msgs[j].data();
+            lengths[j] = msgs[j].size();
+        }
+        std::vector<unsigned char> out1(32 * count), out2(32 * count);
+        for (int j = 0; j < count; ++j) {
+            CHash256().Write(inputs[j], lengths[j]).Finalize(out1.data() + 32 * j);
+        }
+        SHA256DMulti(out2.data(), inputs.data(), lengths.data(), count);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
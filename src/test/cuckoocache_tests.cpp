@@ -377,4 +377,52 @@ BOOST_AUTO_TEST_CASE(cuckoocache_generations)
     test_cache_generations<CuckooCache::cache<uint256, SignatureCacheHasher>>();
 }
 
+/** The sharded cache must behave like the plain one from a single thread */
+BOOST_AUTO_TEST_CASE(cuckoocache_sharded_ok)
+{
+    typedef CuckooCache::sharded_cache<uint256, SignatureCacheHasher> Cache;
+    double HitRateThresh = 0.98;
+    size_t megabytes = 4;
+    for (double load = 0.1; load < 2; load *= 2) {
+        double hits = test_cache<Cache>(megabytes, load);
+        BOOST_CHECK(normalize_hit_rate(hits, load) > HitRateThresh);
+    }
+    test_cache_erase<Cache>(megabytes);
+    test_cache_erase_parallel<Cache>(megabytes);
+    test_cache_generations<Cache>();
+}
+
+/** Check that the sharded cache needs no external lock: each thread inserts
+ * its own elements while looking up those of the other threads.
+ */
+BOOST_AUTO_TEST_CASE(cuckoocache_sharded_parallel_ok)
+{
+    local_rand_ctx = FastRandomContext(true);
+    CuckooCache::sharded_cache<uint256, SignatureCacheHasher> set{};
+    size_t bytes = 4 << 20;
+    set.setup_bytes(bytes);
+    const uint32_t n_threads = 4;
+    // Half load, so that almost nothing is evicted
+    const uint32_t n_insert = (bytes / sizeof(uint256)) / 2;
+    std::vector<uint256> hashes(n_insert);
+    for (uint256& h : hashes)
+        insecure_GetRandHash(h);
+
+    std::vector<std::thread> threads;
+    for (uint32_t x = 0; x < n_threads; ++x)
+        threads.emplace_back([&, x] {
+            for (uint32_t i = x; i < n_insert; i += n_threads) {
+                set.insert(hashes[i]);
+                set.contains(hashes[n_insert - 1 - i], false);
+            }
+        });
+    for (std::thread& t : threads)
+        t.join();
+
+    uint32_t count = 0;
+    for (const uint256& h : hashes)
+        count += set.contains(h, false);
+    BOOST_CHECK(double(count) / double(n_insert) > 0.98);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
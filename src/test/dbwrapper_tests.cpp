@@ -119,6 +119,174 @@ BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_snapshot)
+{
+    // Perform tests both obfuscated and non-obfuscated.
+    for (bool obfuscate : {false, true}) {
+        fs::path ph = SetDataDir(std::string("dbwrapper_snapshot").append(obfuscate ? "_true" : "_false"));
+        CDBWrapper dbw(ph, (1 << 20), true, false, obfuscate);
+
+        char key = 'j';
+        uint256 in = InsecureRand256();
+        BOOST_CHECK(dbw.Write(key, in));
+        char key2 = 'k';
+        uint256 in2 = InsecureRand256();
+        BOOST_CHECK(dbw.Write(key2, in2));
+
+        const uint256 hashBlock = InsecureRand256();
+        std::unique_ptr<CDBSnapshot> snapshot = dbw.GetSnapshot(hashBlock);
+        BOOST_CHECK(snapshot->GetBestBlock() == hashBlock);
+
+        // Change the database after the snapshot was taken
+        uint256 in3 = InsecureRand256();
+        BOOST_CHECK(dbw.Write(key, in3));
+        BOOST_CHECK(dbw.Erase(key2));
+        char key3 = 'l';
+        BOOST_CHECK(dbw.Write(key3, in3));
+
+        uint256 res;
+        BOOST_CHECK(dbw.Read(key, res));
+        BOOST_CHECK_EQUAL(res.ToString(), in3.ToString());
+        BOOST_CHECK(snapshot->Read(key, res));
+        BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+        BOOST_CHECK(snapshot->Exists(key2));
+        BOOST_CHECK(!snapshot->Exists(key3));
+
+        // Iterating the snapshot sees the old contents only
+        std::unique_ptr<CDBIterator> it(snapshot->NewIterator());
+        it->Seek(key);
+        char key_res;
+        BOOST_CHECK(it->GetKey(key_res) && key_res == key);
+        BOOST_CHECK(it->GetValue(res));
+        BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+        it->Next();
+        BOOST_CHECK(it->GetKey(key_res) && key_res == key2);
+        BOOST_CHECK(it->GetValue(res));
+        BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+        it->Next();
+        BOOST_CHECK_EQUAL(it->Valid(), false);
+    }
+}
+
+template <typename K, typename V>
+static void AddOverlay(CDBSnapshot::Overlay& overlay, const K& key, const V& value)
+{
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION), ssValue(SER_DISK, CLIENT_VERSION);
+    ssKey << key;
+    ssValue << value;
+    overlay.emplace(std::string(ssKey.begin(), ssKey.end()), std::vector<unsigned char>(ssValue.begin(), ssValue.end()));
+}
+
+template <typename K>
+static void EraseOverlay(CDBSnapshot::Overlay& overlay, const K& key)
+{
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey << key;
+    overlay.emplace(std::string(ssKey.begin(), ssKey.end()), std::vector<unsigned char>());
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_snapshot_overlay)
+{
+    // Perform tests both obfuscated and non-obfuscated.
+    for (bool obfuscate : {false, true}) {
+        fs::path ph = SetDataDir(std::string("dbwrapper_snapshot_overlay").append(obfuscate ? "_true" : "_false"));
+        CDBWrapper dbw(ph, (1 << 20), true, false, obfuscate);
+
+        uint256 in = InsecureRand256(), in2 = InsecureRand256(), in3 = InsecureRand256(), in4 = InsecureRand256();
+        BOOST_CHECK(dbw.Write('j', in));
+        BOOST_CHECK(dbw.Write('k', in));
+        BOOST_CHECK(dbw.Write('m', in));
+
+        // Replace 'j', erase 'k', add 'l' and erase 'n' that never existed
+        CDBSnapshot::Overlay overlay;
+        AddOverlay(overlay, 'j', in2);
+        EraseOverlay(overlay, 'k');
+        AddOverlay(overlay, 'l', in3);
+        EraseOverlay(overlay, 'n');
+        std::unique_ptr<CDBSnapshot> snapshot = dbw.GetSnapshot();
+        snapshot->SetOverlay(std::move(overlay));
+        // Nor does the view see later writes with an overlay
+        BOOST_CHECK(dbw.Write('o', in4));
+
+        uint256 res;
+        BOOST_CHECK(snapshot->Read('j', res));
+        BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+        BOOST_CHECK(!snapshot->Read('k', res));
+        BOOST_CHECK(!snapshot->Exists('k'));
+        BOOST_CHECK(snapshot->Read('l', res));
+        BOOST_CHECK_EQUAL(res.ToString(), in3.ToString());
+        BOOST_CHECK(snapshot->Read('m', res));
+        BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+        BOOST_CHECK(!snapshot->Exists('n'));
+        BOOST_CHECK(!snapshot->Exists('o'));
+        // The database itself is untouched
+        BOOST_CHECK(dbw.Read('j', res));
+        BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+        BOOST_CHECK(dbw.Exists('k'));
+
+        // Iteration merges both in key order
+        std::unique_ptr<CDBIterator> it(snapshot->NewIterator());
+        it->Seek('j');
+        char key_res;
+        BOOST_CHECK(it->GetKey(key_res) && key_res == 'j');
+        BOOST_CHECK(it->GetValue(res));
+        BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+        it->Next();
+        BOOST_CHECK(it->GetKey(key_res) && key_res == 'l');
+        BOOST_CHECK(it->GetValue(res));
+        BOOST_CHECK_EQUAL(res.ToString(), in3.ToString());
+        it->Next();
+        BOOST_CHECK(it->GetKey(key_res) && key_res == 'm');
+        BOOST_CHECK(it->GetValue(res));
+        BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+        it->Next();
+        BOOST_CHECK_EQUAL(it->Valid(), false);
+
+        it->Seek('k');
+        BOOST_CHECK(it->GetKey(key_res) && key_res == 'l');
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_readmany)
+{
+    // Perform tests both obfuscated and non-obfuscated.
+    for (bool obfuscate : {false, true}) {
+        fs::path ph = SetDataDir(std::string("dbwrapper_readmany").append(obfuscate ? "_true" : "_false"));
+        CDBWrapper dbw(ph, (1 << 20), true, false, obfuscate);
+
+        // Every third key is missing; the keys are looked up out of order
+        std::vector<uint256> in(30);
+        for (uint32_t x = 0; x < in.size(); x++) {
+            in[x] = InsecureRand256();
+            if (x % 3 != 0)
+                BOOST_CHECK(dbw.Write(std::make_pair('k', x), in[x]));
+        }
+        std::vector<std::pair<char, uint32_t>> keys;
+        for (uint32_t x = in.size(); x-- > 0;)
+            keys.emplace_back('k', x);
+        // Keys that sort before and after everything in the database, and a duplicate
+        keys.emplace_back('a', 1);
+        keys.emplace_back('z', 1);
+        keys.emplace_back('k', 4);
+
+        std::vector<uint256> values;
+        std::vector<bool> found;
+        BOOST_CHECK_EQUAL(dbw.ReadMany(keys, values, found), 21U);
+        BOOST_CHECK_EQUAL(values.size(), keys.size());
+        BOOST_CHECK_EQUAL(found.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            const bool fExpected = keys[i].first == 'k' && keys[i].second % 3 != 0;
+            BOOST_CHECK_EQUAL(found[i], fExpected);
+            if (fExpected)
+                BOOST_CHECK_EQUAL(values[i].ToString(), in[keys[i].second].ToString());
+        }
+
+        // Nothing to look up
+        BOOST_CHECK_EQUAL(dbw.ReadMany(std::vector<char>(), values, found), 0U);
+        BOOST_CHECK(values.empty() && found.empty());
+    }
+}
+
 // Test that we do not obfuscation if there is existing data.
 BOOST_AUTO_TEST_CASE(existing_data_no_obfuscate)
 {
@@ -319,4 +487,26 @@ BOOST_AUTO_TEST_CASE(iterator_string_ordering)
 
 
 
+BOOST_AUTO_TEST_CASE(dbwrapper_profile_args)
+{
+    std::string error;
+    gArgs.ForceSetArg("-dbprofile", "txindex:scan");
+    BOOST_CHECK(CheckDBProfileArgs(error));
+    BOOST_CHECK_EQUAL(GetDBProfile("txindex").name, std::string("scan"));
+
+    gArgs.ForceSetArg("-dbprofile", "txindexx:scan");
+    BOOST_CHECK(!CheckDBProfileArgs(error));
+    BOOST_CHECK(error.find("txindexx") != std::string::npos);
+
+    gArgs.ForceSetArg("-dbprofile", "txindex:fast");
+    BOOST_CHECK(!CheckDBProfileArgs(error));
+
+    gArgs.ForceSetArg("-dbprofile", "txindex");
+    BOOST_CHECK(!CheckDBProfileArgs(error));
+
+    // Leave the default in place for the other tests
+    gArgs.ForceSetArg("-dbprofile", "chainstate:default");
+    BOOST_CHECK(CheckDBProfileArgs(error));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
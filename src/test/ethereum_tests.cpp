@@ -8,6 +8,8 @@
 #include "ethereum/ethereum.h"
 #include "ethereum/Common.h"
 #include "ethereum/RLP.h"
+#include "ethereum/SHA3.h"
+#include "test/test_syscoin.h"
 #include "script/interpreter.h"
 #include "script/standard.h"
 #include "policy/policy.h"
@@ -16,6 +18,122 @@
 
 extern UniValue read_json(const std::string& jsondata);
 
+namespace {
+/** VerifyProof as it was written on top of dev::RLP, to check the RLPView version against */
+int ReferenceNibblesToTraverse(const std::string &encodedPartialPath, const std::string &path, int pathPtr) {
+    std::string partialPath;
+    char pathPtrInt[2] = {encodedPartialPath[0], '\0'};
+    int partialPathInt = strtol(pathPtrInt, NULL, 10);
+    if(partialPathInt == 0 || partialPathInt == 2){
+        partialPath = encodedPartialPath.substr(2);
+    }else{
+        partialPath = encodedPartialPath.substr(1);
+    }
+    if(partialPath == path.substr(pathPtr, partialPath.size())){
+        return partialPath.size();
+    }else{
+        return -1;
+    }
+}
+
+bool ReferenceVerifyProof(const std::vector<unsigned char>& vchPath, const std::vector<unsigned char>& vchValue, const std::vector<unsigned char>& vchParentNodes, const std::vector<unsigned char>& vchRoot) {
+    try{
+        const dev::RLP value(&vchValue);
+        const dev::RLP parentNodes(&vchParentNodes);
+        const dev::RLP root(&vchRoot);
+        dev::RLP currentNode;
+        const int len = parentNodes.itemCount();
+        dev::RLP nodeKey = root;
+        int pathPtr = 0;
+        const std::string pathString = dev::toHex(vchPath);
+        int nibbles;
+        char pathPtrInt[2];
+        for (int i = 0 ; i < len ; i++) {
+            currentNode = parentNodes[i];
+            if(!nodeKey.payload().contentsEqual(dev::sha3(currentNode.data()).ref().toVector()))
+                return false;
+            if(pathPtr > (int)pathString.size())
+                return false;
+            switch(currentNode.itemCount()){
+                case 17:
+                    if(pathPtr == (int)pathString.size())
+                        return currentNode[16].payload().contentsEqual(value.data().toVector());
+                    pathPtrInt[0] = pathString[pathPtr];
+                    pathPtrInt[1] = '\0';
+                    nodeKey = currentNode[strtol(pathPtrInt, NULL, 16)];
+                    pathPtr += 1;
+                    break;
+                case 2:
+                    nibbles = ReferenceNibblesToTraverse(dev::toHex(currentNode[0].payload()), pathString, pathPtr);
+                    if(nibbles <= -1)
+                        return false;
+                    pathPtr += nibbles;
+                    if(pathPtr == (int)pathString.size())
+                        return currentNode[1].payload().contentsEqual(value.data().toVector());
+                    nodeKey = currentNode[1];
+                    break;
+                default:
+                    return false;
+            }
+        }
+    }
+    catch(...){
+        return false;
+    }
+    return false;
+}
+
+/** Check that RLPView reads data the way dev::RLP does, down to the nested items */
+void CheckRLPView(Span<const unsigned char> data, int nDepth = 0)
+{
+    bool fValid = data.size() > 0;
+    bool fList = false;
+    bool fItemsValid = true;
+    size_t nItems = 0;
+    dev::bytesConstRef payload;
+    try {
+        const dev::RLP rlp(dev::bytesConstRef(data.data(), data.size()));
+        payload = rlp.payload();
+        fList = rlp.isList();
+        try {
+            nItems = rlp.itemCount();
+        } catch (...) {
+            fItemsValid = false;
+        }
+    } catch (...) {
+        fValid = false;
+    }
+    const RLPView view(data);
+    BOOST_CHECK_EQUAL(view.IsValid(), fValid);
+    if (!fValid)
+        return;
+    BOOST_CHECK_EQUAL(view.IsList(), fList);
+    BOOST_CHECK(view.Payload() == Span<const unsigned char>(payload.data(), payload.size()));
+    std::vector<RLPView> vItems;
+    BOOST_CHECK_EQUAL(view.GetItems(vItems), fList && fItemsValid);
+    if (!fList || !fItemsValid)
+        return;
+    BOOST_CHECK_EQUAL(vItems.size(), nItems);
+    if (nDepth < 4) {
+        for (const RLPView& item : vItems)
+            CheckRLPView(item.Data(), nDepth + 1);
+    }
+}
+
+/** Copy of data with one random byte changed, or cut short at a random position */
+std::vector<unsigned char> Mutate(const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> ret(data);
+    if (ret.empty())
+        return ret;
+    if (InsecureRandBool())
+        ret[InsecureRandRange(ret.size())] = InsecureRandBits(8);
+    else
+        ret.resize(InsecureRandRange(ret.size()));
+    return ret;
+}
+} // namespace
+
 
 BOOST_AUTO_TEST_SUITE(ethereum_tests)
 BOOST_AUTO_TEST_CASE(ethereum_parseabidata)
@@ -25,9 +143,35 @@ BOOST_AUTO_TEST_CASE(ethereum_parseabidata)
     const std::vector<unsigned char> &expectedMethodHash = ParseHex("a82e762b");
     const std::vector<unsigned char> &rlpBytes = ParseHex("a82e762b00000000000000000000000000000000000000000000000000000000773594009591c8dc");
     CWitnessAddress address;
-    BOOST_CHECK(parseEthMethodInputData(expectedMethodHash, rlpBytes, outputAmount, nAsset, address));
+    BOOST_CHECK(parseEthMethodInputData(expectedMethodHash, MakeSpan(rlpBytes), outputAmount, nAsset, address));
+    BOOST_CHECK_EQUAL(outputAmount, 20*COIN);
+    BOOST_CHECK_EQUAL(nAsset, 2509359324);
+}
+
+BOOST_AUTO_TEST_CASE(ethereum_parseabidata_witness)
+{
+    CAmount outputAmount = 0;
+    uint32_t nAsset = 0;
+    const std::vector<unsigned char> &expectedMethodHash = ParseHex("a82e762b");
+    // amount, asset, then the witness address as version and program behind its length at position 131
+    std::vector<unsigned char> vchInputData = ParseHex("a82e762b00000000000000000000000000000000000000000000000000000000773594009591c8dc");
+    vchInputData.resize(131);
+    vchInputData.push_back(21);
+    vchInputData.push_back(0);
+    vchInputData.insert(vchInputData.end(), 20, 0x42);
+    CWitnessAddress address;
+    BOOST_CHECK(parseEthMethodInputData(expectedMethodHash, MakeSpan(vchInputData), outputAmount, nAsset, address));
     BOOST_CHECK_EQUAL(outputAmount, 20*COIN);
     BOOST_CHECK_EQUAL(nAsset, 2509359324);
+    BOOST_CHECK(address == CWitnessAddress(0, std::vector<unsigned char>(20, 0x42)));
+
+    // A witness program running past the end of the data is rejected
+    vchInputData.resize(vchInputData.size() - 2);
+    BOOST_CHECK(!parseEthMethodInputData(expectedMethodHash, MakeSpan(vchInputData), outputAmount, nAsset, address));
+    // So is another method
+    vchInputData.resize(vchInputData.size() + 2, 0x42);
+    vchInputData[0] = 0;
+    BOOST_CHECK(!parseEthMethodInputData(expectedMethodHash, MakeSpan(vchInputData), outputAmount, nAsset, address));
 }
 
 BOOST_AUTO_TEST_CASE(ethspv_valid)
@@ -57,13 +201,10 @@ BOOST_AUTO_TEST_CASE(ethspv_valid)
 			  std::string spv_path = test[3].get_str();
 
         const std::vector<unsigned char> &vchTxRoot = ParseHex(spv_tx_root);
-        dev::RLP rlpTxRoot(&vchTxRoot);
         const std::vector<unsigned char> &vchParentNodes = ParseHex(spv_parent_nodes);
-        dev::RLP rlpParentNodes(&vchParentNodes);
         const std::vector<unsigned char> &vchValue = ParseHex(spv_value);
-        dev::RLP rlpValue(&vchValue);
         const std::vector<unsigned char> &vchPath = ParseHex(spv_path);
-        BOOST_CHECK(VerifyProof(&vchPath, rlpValue, rlpParentNodes, rlpTxRoot));
+        BOOST_CHECK(VerifyProof(MakeSpan(vchPath), MakeSpan(vchValue), MakeSpan(vchParentNodes), MakeSpan(vchTxRoot)));
         }
     }
 }
@@ -94,14 +235,101 @@ BOOST_AUTO_TEST_CASE(ethspv_invalid)
 			      std::string spv_path = test[3].get_str();
 
             const std::vector<unsigned char> &vchTxRoot = ParseHex(spv_tx_root);
-            dev::RLP rlpTxRoot(&vchTxRoot);
             const std::vector<unsigned char> &vchParentNodes = ParseHex(spv_parent_nodes);
-            dev::RLP rlpParentNodes(&vchParentNodes);
             const std::vector<unsigned char> &vchValue = ParseHex(spv_value);
-            dev::RLP rlpValue(&vchValue);
             const std::vector<unsigned char> &vchPath = ParseHex(spv_path);
-            BOOST_CHECK(!VerifyProof(&vchPath, rlpValue, rlpParentNodes, rlpTxRoot));
+            BOOST_CHECK(!VerifyProof(MakeSpan(vchPath), MakeSpan(vchValue), MakeSpan(vchParentNodes), MakeSpan(vchTxRoot)));
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(rlpview_encodings)
+{
+    const std::vector<std::pair<std::string, bool>> encodings = {
+        {"00", true}, {"7f", true}, {"80", true}, {"8180", true}, {"817f", false}, {"81", false},
+        {"83646f67", true}, {"83646f", false}, {"83646f6767", false},
+        {"c0", true}, {"c3010203", true}, {"c4010203", false}, {"c3c0c2c0", false}, {"c7c0c1c0c3c0c1c0", true},
+        // long forms must carry at least 56 bytes and no leading zero in the length
+        {"b837" + std::string(110, '1'), false}, {"b838" + std::string(112, '1'), true}, {"b90038" + std::string(112, '1'), false},
+        {"f837" + std::string(110, '0'), false}, {"f838" + std::string(112, '0'), true}, {"ff", false},
+    };
+    for (const auto& encoding : encodings) {
+        const std::vector<unsigned char> data = ParseHex(encoding.first);
+        const RLPView view(MakeSpan(data));
+        std::vector<RLPView> vItems;
+        BOOST_CHECK_MESSAGE((view.IsValid() && (!view.IsList() || view.GetItems(vItems))) == encoding.second, encoding.first);
+        CheckRLPView(MakeSpan(data));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rlpview_matches_rlp)
+{
+    UniValue tests = read_json(std::string(json_tests::ethspv_valid, json_tests::ethspv_valid + sizeof(json_tests::ethspv_valid)));
+    for (unsigned int idx = 0; idx < tests.size(); idx++) {
+        const UniValue& test = tests[idx];
+        if (test.size() != 4)
+            continue;
+        const std::vector<unsigned char> vchTxRoot = ParseHex(test[0].get_str());
+        const std::vector<unsigned char> vchParentNodes = ParseHex(test[1].get_str());
+        const std::vector<unsigned char> vchValue = ParseHex(test[2].get_str());
+        const std::vector<unsigned char> vchPath = ParseHex(test[3].get_str());
+        CheckRLPView(MakeSpan(vchParentNodes));
+        CheckRLPView(MakeSpan(vchValue));
+        for (int i = 0; i < 100; i++) {
+            const std::vector<unsigned char> vchMutatedNodes = Mutate(vchParentNodes);
+            const std::vector<unsigned char> vchMutatedValue = Mutate(vchValue);
+            const std::vector<unsigned char> vchMutatedPath = Mutate(vchPath);
+            const std::vector<unsigned char> vchMutatedRoot = Mutate(vchTxRoot);
+            CheckRLPView(MakeSpan(vchMutatedNodes));
+            CheckRLPView(MakeSpan(vchMutatedValue));
+            BOOST_CHECK_EQUAL(VerifyProof(MakeSpan(vchPath), MakeSpan(vchValue), MakeSpan(vchMutatedNodes), MakeSpan(vchTxRoot)),
+                ReferenceVerifyProof(vchPath, vchValue, vchMutatedNodes, vchTxRoot));
+            BOOST_CHECK_EQUAL(VerifyProof(MakeSpan(vchPath), MakeSpan(vchMutatedValue), MakeSpan(vchParentNodes), MakeSpan(vchTxRoot)),
+                ReferenceVerifyProof(vchPath, vchMutatedValue, vchParentNodes, vchTxRoot));
+            BOOST_CHECK_EQUAL(VerifyProof(MakeSpan(vchMutatedPath), MakeSpan(vchValue), MakeSpan(vchParentNodes), MakeSpan(vchTxRoot)),
+                ReferenceVerifyProof(vchMutatedPath, vchValue, vchParentNodes, vchTxRoot));
+            BOOST_CHECK_EQUAL(VerifyProof(MakeSpan(vchPath), MakeSpan(vchValue), MakeSpan(vchParentNodes), MakeSpan(vchMutatedRoot)),
+                ReferenceVerifyProof(vchPath, vchValue, vchParentNodes, vchMutatedRoot));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ethereum_sha3multi)
+{
+    dev::SHA3AutoDetect();
+    const std::string abc = "abc";
+    BOOST_CHECK_EQUAL(dev::toHex(dev::sha3(abc).ref()), "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45");
+
+    // Inputs around the 136 byte rate, hashed together must match hashing them one by one
+    std::vector<unsigned char> data(1000);
+    for (unsigned char& c : data)
+        c = InsecureRandBits(8);
+    std::vector<dev::bytesConstRef> inputs;
+    for (size_t length : {0, 1, 135, 136, 137, 271, 272, 273, 532, 1000})
+        inputs.emplace_back(data.data(), length);
+    for (size_t count = 0; count <= inputs.size(); count++) {
+        std::vector<dev::h256> hashes(count);
+        dev::sha3Multi(inputs.data(), hashes.data(), count);
+        for (size_t i = 0; i < count; i++)
+            BOOST_CHECK(hashes[i] == dev::sha3(inputs[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ethereum_sha3multi_idle_lanes)
+{
+    dev::SHA3AutoDetect();
+    // Fewer inputs than lanes, long enough for several permutations with idle lanes
+    std::vector<unsigned char> data(1000);
+    for (unsigned char& c : data)
+        c = InsecureRandBits(8);
+    for (size_t count : {2, 3}) {
+        std::vector<dev::bytesConstRef> inputs;
+        for (size_t i = 0; i < count; i++)
+            inputs.emplace_back(data.data() + i, data.size() - 300 * i);
+        std::vector<dev::h256> hashes(count);
+        dev::sha3Multi(inputs.data(), hashes.data(), count);
+        for (size_t i = 0; i < count; i++)
+            BOOST_CHECK(hashes[i] == dev::sha3(inputs[i]));
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <policy/policy.h>
+#include <services/asset.h>
+#include <services/assetallocation.h>
 #include <txmempool.h>
 #include <util.h>
 
@@ -749,4 +751,83 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTests)
     BOOST_CHECK_EQUAL(descendants, 6ULL);
 }
 
+static CTransactionRef MakeAssetAllocationSend(uint32_t nAsset, unsigned char nSender, unsigned char nInput)
+{
+    CAssetAllocation allocation;
+    allocation.assetAllocationTuple = CAssetAllocationTuple(nAsset, CWitnessAddress(0, std::vector<unsigned char>(20, nSender)));
+    std::vector<unsigned char> vchData;
+    allocation.Serialize(vchData);
+
+    CMutableTransaction tx;
+    tx.nVersion = SYSCOIN_TX_VERSION_ASSET;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(uint256S("01"), nInput);
+    tx.vout.resize(2);
+    tx.vout[0].scriptPubKey = CScript() << CScript::EncodeOP_N(OP_SYSCOIN_ASSET_ALLOCATION) << CScript::EncodeOP_N(OP_ASSET_ALLOCATION_SEND) << OP_DROP << OP_11 << OP_EQUAL;
+    tx.vout[0].nValue = 1000;
+    tx.vout[1].scriptPubKey = CScript() << OP_RETURN << CScript::EncodeOP_N(OP_SYSCOIN_ASSET_ALLOCATION) << vchData;
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolAssetAllocationArrivalTest)
+{
+    CTxMemPool pool;
+    LOCK(pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // Three sends from one sender, one from another and a plain transaction
+    const CTransactionRef txA1 = MakeAssetAllocationSend(1, 1, 0);
+    const CTransactionRef txA2 = MakeAssetAllocationSend(1, 1, 1);
+    const CTransactionRef txA3 = MakeAssetAllocationSend(1, 1, 2);
+    const CTransactionRef txB1 = MakeAssetAllocationSend(2, 1, 3);
+    CMutableTransaction txPlain;
+    txPlain.vin.resize(1);
+    txPlain.vin[0].prevout = COutPoint(uint256S("02"), 0);
+    txPlain.vout.resize(1);
+    txPlain.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    txPlain.vout[0].nValue = 1000;
+    for (const CTransactionRef& tx : {txA1, txA2, txA3, txB1})
+        pool.addUnchecked(tx->GetHash(), entry.FromTx(tx));
+    pool.addUnchecked(txPlain.GetHash(), entry.FromTx(txPlain));
+    BOOST_CHECK_EQUAL(pool.mapAssetAllocationArrivals.size(), 4U);
+    BOOST_CHECK(!pool.mapAssetAllocationArrivals.count(txPlain.GetHash()));
+    // None of them has a recorded arrival time yet
+    for (const AssetAllocationArrival& arrival : pool.mapAssetAllocationArrivals)
+        BOOST_CHECK_EQUAL(arrival.nArrivalTime, NO_ASSET_ALLOCATION_ARRIVAL);
+
+    // Arrival times recorded after the transactions entered the pool reorder them
+    pool.UpdateAssetAllocationArrival(txA1->GetHash(), 3000);
+    pool.UpdateAssetAllocationArrival(txA2->GetHash(), 1000);
+    pool.UpdateAssetAllocationArrival(txA3->GetHash(), 2000);
+    pool.UpdateAssetAllocationArrival(txB1->GetHash(), 500);
+    pool.UpdateAssetAllocationArrival(txPlain.GetHash(), 500);
+    BOOST_CHECK_EQUAL(pool.mapAssetAllocationArrivals.size(), 4U);
+
+    const std::string strSenderA = CAssetAllocation(*txA1).assetAllocationTuple.ToString();
+    const auto& senderArrivals = pool.mapAssetAllocationArrivals.get<sender_arrival>();
+    auto range = senderArrivals.equal_range(boost::make_tuple(strSenderA));
+    std::vector<uint256> vOrdered;
+    for (auto it = range.first; it != range.second; ++it)
+        vOrdered.push_back(it->txHash);
+    BOOST_CHECK(vOrdered == std::vector<uint256>({txA2->GetHash(), txA3->GetHash(), txA1->GetHash()}));
+
+    // Only entries at or after an arrival time
+    auto itFrom = senderArrivals.lower_bound(boost::make_tuple(strSenderA, 2000));
+    BOOST_CHECK(itFrom != range.second && itFrom->txHash == txA3->GetHash());
+
+    // Removal keeps the index in step with mapTx
+    pool.removeRecursive(*txA3);
+    BOOST_CHECK_EQUAL(pool.mapAssetAllocationArrivals.size(), 3U);
+    BOOST_CHECK(!pool.mapAssetAllocationArrivals.count(txA3->GetHash()));
+    BOOST_CHECK_EQUAL(std::distance(senderArrivals.lower_bound(boost::make_tuple(strSenderA)), senderArrivals.upper_bound(boost::make_tuple(strSenderA))), 2);
+
+    // Sends whose arrival times were dropped go back to having none, other senders keep theirs
+    pool.SyncAssetAllocationArrivals(strSenderA);
+    BOOST_CHECK_EQUAL(pool.mapAssetAllocationArrivals.find(txA1->GetHash())->nArrivalTime, NO_ASSET_ALLOCATION_ARRIVAL);
+    BOOST_CHECK_EQUAL(pool.mapAssetAllocationArrivals.find(txA2->GetHash())->nArrivalTime, NO_ASSET_ALLOCATION_ARRIVAL);
+    BOOST_CHECK_EQUAL(pool.mapAssetAllocationArrivals.find(txB1->GetHash())->nArrivalTime, 500);
+    pool.clear();
+    BOOST_CHECK(pool.mapAssetAllocationArrivals.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -13,10 +13,13 @@
 #include <policy/policy.h>
 #include <pubkey.h>
 #include <script/standard.h>
+#include <services/asset.h>
+#include <services/assetallocation.h>
 #include <txmempool.h>
 #include <uint256.h>
 #include <util.h>
 #include <utilstrencodings.h>
+#include <validationinterface.h>
 
 #include <test/test_syscoin.h>
 
@@ -199,6 +202,24 @@ static void TestPackageSelection(const CChainParams& chainparams, const CScript&
     mempool.addUnchecked(tx.GetHash(), entry.Fee(10000).FromTx(tx));
     pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
     BOOST_CHECK(pblocktemplate->block.vtx[8]->GetHash() == hashLowFeeTx2);
+
+    // An unchanged mempool gives back the last template, and extending the
+    // last template selects what a template built from scratch does
+    std::unique_ptr<CBlockTemplate> pcachedtemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(pcachedtemplate->block.vtx.size(), pblocktemplate->block.vtx.size());
+    for (size_t i = 1; i < pcachedtemplate->block.vtx.size() && i < pblocktemplate->block.vtx.size(); ++i)
+        BOOST_CHECK(pcachedtemplate->block.vtx[i]->GetHash() == pblocktemplate->block.vtx[i]->GetHash());
+    BlockAssembler::Options options;
+    options.nBlockMaxWeight = MAX_BLOCK_WEIGHT;
+    options.blockMinFeeRate = blockMinFeeRate;
+    options.fIncrementalTemplate = false;
+    std::unique_ptr<CBlockTemplate> pfulltemplate = BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey);
+    std::set<uint256> setIncremental, setFull;
+    for (size_t i = 1; i < pblocktemplate->block.vtx.size(); ++i)
+        setIncremental.insert(pblocktemplate->block.vtx[i]->GetHash());
+    for (size_t i = 1; i < pfulltemplate->block.vtx.size(); ++i)
+        setFull.insert(pfulltemplate->block.vtx[i]->GetHash());
+    BOOST_CHECK(setIncremental == setFull);
 }
 
 // NOTE: These tests rely on CreateNewBlock doing its own self-validation!
@@ -521,4 +542,143 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+// SYSCOIN
+class SyscoinEventCounter : public CValidationInterface
+{
+public:
+    std::atomic<int> nConfirmed{0};
+
+protected:
+    void NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed) override
+    {
+        if (fConfirmed)
+            nConfirmed++;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(CreateNewBlock_syscoin_notifications)
+{
+    // Checking the syscoin inputs of a template must not announce its transactions as confirmed
+    const bool fZMQAssetAllocationRawOld = fZMQAssetAllocationRaw;
+    fZMQAssetAllocationRaw = true;
+    SyscoinEventCounter counter;
+    RegisterValidationInterface(&counter);
+    passetdb.reset(new CAssetDB(1 << 20, true, true));
+    passetallocationdb.reset(new CAssetAllocationDB(1 << 20, true, true));
+    passetcache.reset(new CAssetCache(*passetdb, "assets"));
+    passetallocationcache.reset(new CAssetAllocationCache(*passetallocationdb, "asset allocations"));
+
+    const CWitnessAddress sender(0, std::vector<unsigned char>(20, 1));
+    CAsset asset;
+    asset.nAsset = 1;
+    asset.nBalance = 1000;
+    asset.nTotalSupply = 1000;
+    asset.nMaxSupply = 1000;
+    passetcache->Write(asset.nAsset, asset);
+    CAssetAllocation allocation;
+    allocation.assetAllocationTuple = CAssetAllocationTuple(1, sender);
+    allocation.nBalance = 100;
+    passetallocationcache->Write(allocation.assetAllocationTuple, allocation);
+
+    // The sender signs off by spending an output to its witness program
+    CCoinsViewCache view(pcoinsTip.get());
+    const COutPoint prevout(uint256S("01"), 0);
+    Coin coin;
+    coin.out.nValue = 1000;
+    coin.out.scriptPubKey = CScript() << OP_0 << sender.vchWitnessProgram;
+    coin.nHeight = 1;
+    view.AddCoin(prevout, std::move(coin), false);
+
+    CAssetAllocation send;
+    send.assetAllocationTuple = CAssetAllocationTuple(1, sender);
+    send.listSendingAllocationAmounts.emplace_back(CWitnessAddress(0, std::vector<unsigned char>(20, 2)), 10);
+    std::vector<unsigned char> vchData;
+    send.Serialize(vchData);
+    CMutableTransaction tx;
+    tx.nVersion = SYSCOIN_TX_VERSION_ASSET;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = prevout;
+    tx.vout.resize(2);
+    tx.vout[0].scriptPubKey = CScript() << CScript::EncodeOP_N(OP_SYSCOIN_ASSET_ALLOCATION) << CScript::EncodeOP_N(OP_ASSET_ALLOCATION_SEND) << OP_DROP << OP_11 << OP_EQUAL;
+    tx.vout[0].nValue = 900;
+    tx.vout[1].scriptPubKey = CScript() << OP_RETURN << CScript::EncodeOP_N(OP_SYSCOIN_ASSET_ALLOCATION) << vchData;
+    CMutableTransaction coinbaseTx;
+    coinbaseTx.vin.resize(1);
+    coinbaseTx.vin[0].prevout.SetNull();
+    coinbaseTx.vout.resize(1);
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbaseTx));
+    block.vtx.push_back(MakeTransactionRef(tx));
+
+    CValidationState state;
+    bool bOverflow = false;
+    std::vector<uint256> txsToRemove;
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(CheckSyscoinInputs(false, *block.vtx[0], state, view, false, bOverflow, 1, block, false, true, txsToRemove));
+    }
+    BOOST_CHECK(txsToRemove.empty());
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(counter.nConfirmed, 0);
+    // nor change the asset state
+    CAssetAllocation read;
+    BOOST_CHECK(GetAssetAllocation(allocation.assetAllocationTuple, read));
+    BOOST_CHECK_EQUAL(read.nBalance, 100);
+
+    // Connecting the block does announce it
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(CheckSyscoinInputs(false, *block.vtx[0], state, view, false, bOverflow, 1, block));
+    }
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(counter.nConfirmed, 1);
+    BOOST_CHECK(GetAssetAllocation(allocation.assetAllocationTuple, read));
+    BOOST_CHECK_EQUAL(read.nBalance, 90);
+
+    UnregisterValidationInterface(&counter);
+    passetallocationcache.reset();
+    passetcache.reset();
+    passetallocationdb.reset();
+    passetdb.reset();
+    fZMQAssetAllocationRaw = fZMQAssetAllocationRawOld;
+}
+
+BOOST_FIXTURE_TEST_CASE(TestBlockValidity_template_scripts, TestChain100Setup)
+{
+    // A template only skips the scripts found in the script execution cache,
+    // so a spend that was never checked on mempool entry is still verified
+    const CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    auto TemplateWithSpend = [&](bool fBadSig) {
+        CMutableTransaction spend;
+        spend.nVersion = 1;
+        spend.vin.resize(1);
+        spend.vin[0].prevout = COutPoint(m_coinbase_txns[0]->GetHash(), 0);
+        spend.vout.resize(1);
+        spend.vout[0].nValue = m_coinbase_txns[0]->vout[0].nValue - 10000;
+        spend.vout[0].scriptPubKey = scriptPubKey;
+        std::vector<unsigned char> vchSig;
+        const uint256 hash = SignatureHash(scriptPubKey, spend, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+        if (fBadSig)
+            vchSig[30] ^= 1;
+        vchSig.push_back((unsigned char)SIGHASH_ALL);
+        spend.vin[0].scriptSig << vchSig;
+
+        std::unique_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(Params()).CreateNewBlock(scriptPubKey, false);
+        CBlock block = pblocktemplate->block;
+        block.vtx.resize(1);
+        block.vtx.push_back(MakeTransactionRef(std::move(spend)));
+        LOCK(cs_main);
+        unsigned int extraNonce = 0;
+        IncrementExtraNonce(&block, chainActive.Tip(), extraNonce);
+        return block;
+    };
+
+    LOCK(cs_main);
+    CValidationState state;
+    BOOST_CHECK(TestBlockValidity(state, Params(), TemplateWithSpend(false), chainActive.Tip(), false, false, true));
+    BOOST_CHECK(!TestBlockValidity(state, Params(), TemplateWithSpend(true), chainActive.Tip(), false, false, true));
+    BOOST_CHECK(state.IsInvalid());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,9 @@
 #include <netbase.h>
 #include <chainparams.h>
 #include <util.h>
+#include <masternode.h>
+#include <net_processing.h>
+#include <netmessagemaker.h>
 
 #include <memory>
 
@@ -73,6 +76,23 @@ static CDataStream AddrmanToStream(CAddrManSerializationMock& _addrman)
     return CDataStream(vchData, SER_DISK, CLIENT_VERSION);
 }
 
+// SYSCOIN parse a serialized message the way the socket handler does
+static CNetMessage MakeNetMessage(CSerializedNetMsg&& msg)
+{
+    std::vector<unsigned char> serializedHeader;
+    uint256 hash = Hash(msg.data.data(), msg.data.data() + msg.data.size());
+    CMessageHeader hdr(Params().MessageStart(), msg.command.c_str(), msg.data.size());
+    memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
+    CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, serializedHeader, 0, hdr};
+
+    CNetMessage netMsg(Params().MessageStart(), SER_NETWORK, INIT_PROTO_VERSION);
+    BOOST_CHECK_EQUAL(netMsg.readHeader((const char*)serializedHeader.data(), serializedHeader.size()), (int)serializedHeader.size());
+    if (!msg.data.empty())
+        BOOST_CHECK_EQUAL(netMsg.readData((const char*)msg.data.data(), msg.data.size()), (int)msg.data.size());
+    BOOST_CHECK(netMsg.complete());
+    return netMsg;
+}
+
 BOOST_FIXTURE_TEST_SUITE(net_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(cnode_listen_port)
@@ -227,4 +247,105 @@ BOOST_AUTO_TEST_CASE(ipv4_peer_with_ipv6_addrMe_test)
     BOOST_CHECK(1);
 }
 
+BOOST_AUTO_TEST_CASE(syscoin_lane_message_types)
+{
+    // masternode, governance and spork messages may leave the main message handler
+    BOOST_CHECK(IsSyscoinLaneMessageType(NetMsgType::MNANNOUNCE));
+    BOOST_CHECK(IsSyscoinLaneMessageType(NetMsgType::MNPING));
+    BOOST_CHECK(IsSyscoinLaneMessageType(NetMsgType::MASTERNODEPAYMENTVOTE));
+    BOOST_CHECK(IsSyscoinLaneMessageType(NetMsgType::MNGOVERNANCEOBJECTVOTE));
+    BOOST_CHECK(IsSyscoinLaneMessageType(NetMsgType::SPORK));
+    // handshake, block and transaction relay must stay ordered on the main handler
+    BOOST_CHECK(!IsSyscoinLaneMessageType(NetMsgType::VERSION));
+    BOOST_CHECK(!IsSyscoinLaneMessageType(NetMsgType::VERACK));
+    BOOST_CHECK(!IsSyscoinLaneMessageType(NetMsgType::INV));
+    BOOST_CHECK(!IsSyscoinLaneMessageType(NetMsgType::HEADERS));
+    BOOST_CHECK(!IsSyscoinLaneMessageType(NetMsgType::BLOCK));
+    BOOST_CHECK(!IsSyscoinLaneMessageType(NetMsgType::TX));
+    BOOST_CHECK(!IsSyscoinLaneMessageType("unknown"));
+}
+
+BOOST_AUTO_TEST_CASE(syscoin_lane_split)
+{
+    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
+    std::list<CNetMessage> vRecvMsg;
+    vRecvMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::INV, std::vector<CInv>())));
+    vRecvMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::MNPING, CMasternodePing())));
+    vRecvMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::GETDATA, std::vector<CInv>())));
+    vRecvMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::GETSPORKS)));
+    // not yet handed to the handlers, must stay where it is
+    vRecvMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::SPORK)));
+    auto itEnd = std::prev(vRecvMsg.end());
+
+    std::list<CNetMessage> vSyscoinMsg;
+    SplitSyscoinLaneMessages(vRecvMsg, itEnd, vSyscoinMsg);
+
+    // each lane keeps the order the peer sent its messages in
+    BOOST_CHECK_EQUAL(vSyscoinMsg.size(), 2U);
+    BOOST_CHECK_EQUAL(vSyscoinMsg.front().hdr.GetCommand(), NetMsgType::MNPING);
+    BOOST_CHECK_EQUAL(vSyscoinMsg.back().hdr.GetCommand(), NetMsgType::GETSPORKS);
+    BOOST_CHECK_EQUAL(vRecvMsg.size(), 3U);
+    auto it = vRecvMsg.begin();
+    BOOST_CHECK_EQUAL((it++)->hdr.GetCommand(), NetMsgType::INV);
+    BOOST_CHECK_EQUAL((it++)->hdr.GetCommand(), NetMsgType::GETDATA);
+    BOOST_CHECK(it == itEnd);
+    BOOST_CHECK_EQUAL(it->hdr.GetCommand(), NetMsgType::SPORK);
+}
+
+BOOST_FIXTURE_TEST_CASE(syscoin_lane_dispatch, TestingSetup)
+{
+    const bool fGethSyncedOld = fGethSynced;
+    fGethSynced = true;
+
+    CAddress addr(CService(CNetAddr(), Params().GetDefaultPort()), NODE_NONE);
+    CNode dummyNode(0, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+    dummyNode.SetSendVersion(PROTOCOL_VERSION);
+    dummyNode.SetRecvVersion(PROTOCOL_VERSION);
+    peerLogic->InitializeNode(&dummyNode);
+    dummyNode.nVersion = PROTOCOL_VERSION;
+    dummyNode.fSuccessfullyConnected = true;
+
+    CMasternodePing mnp1, mnp2;
+    mnp1.sigTime = 1;
+    mnp2.sigTime = 2;
+    {
+        LOCK(cs_main);
+        dummyNode.setAskFor.insert(mnp1.GetHash());
+        dummyNode.setAskFor.insert(mnp2.GetHash());
+    }
+    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
+    {
+        LOCK(dummyNode.cs_vProcessMsg);
+        dummyNode.vProcessSyscoinMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::MNPING, mnp1)));
+        dummyNode.vProcessSyscoinMsg.push_back(MakeNetMessage(msgMaker.Make(NetMsgType::MNPING, mnp2)));
+        for (const CNetMessage& msg : dummyNode.vProcessSyscoinMsg)
+            dummyNode.nProcessQueueSize += msg.vRecv.size() + CMessageHeader::HEADER_SIZE;
+    }
+
+    // one message per call, oldest first, and the handler does its bookkeeping under cs_main
+    std::atomic<bool> interrupt(false);
+    BOOST_CHECK(peerLogic->ProcessSyscoinMessages(&dummyNode, interrupt));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(!dummyNode.setAskFor.count(mnp1.GetHash()));
+        BOOST_CHECK(dummyNode.setAskFor.count(mnp2.GetHash()));
+    }
+    BOOST_CHECK(!peerLogic->ProcessSyscoinMessages(&dummyNode, interrupt));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(dummyNode.setAskFor.empty());
+    }
+    {
+        LOCK(dummyNode.cs_vProcessMsg);
+        BOOST_CHECK(dummyNode.vProcessSyscoinMsg.empty());
+        BOOST_CHECK_EQUAL(dummyNode.nProcessQueueSize, 0U);
+    }
+    BOOST_CHECK(!dummyNode.fDisconnect);
+    BOOST_CHECK(!peerLogic->ProcessSyscoinMessages(&dummyNode, interrupt));
+
+    bool dummy;
+    peerLogic->FinalizeNode(dummyNode.GetId(), dummy);
+    fGethSynced = fGethSyncedOld;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,8 +4,10 @@
 
 #include <rpc/server.h>
 #include <rpc/client.h>
+#include <rpc/util.h>
 
 #include <core_io.h>
+#include <httprpc.h>
 #include <key_io.h>
 #include <netbase.h>
 
@@ -416,4 +418,80 @@ BOOST_AUTO_TEST_CASE(rpc_getblockstats_calculate_percentiles_by_weight)
     }
 }
 
+BOOST_AUTO_TEST_CASE(rpc_json_stream_writer)
+{
+    std::vector<std::string> chunks;
+    JSONStreamWriter stream([&chunks](const std::string& chunk) { chunks.push_back(chunk); }, 16);
+    BOOST_CHECK(!stream.Started());
+    stream.BeginObject();
+    stream.KeyValue("a\"b", 1);
+    stream.Key("list");
+    stream.BeginArray();
+    stream.Value("x");
+    stream.BeginObject();
+    stream.EndObject();
+    stream.Value(UniValue(UniValue::VARR));
+    stream.EndArray();
+    stream.KeyValue("n", NullUniValue);
+    stream.EndObject();
+    stream.Flush();
+    BOOST_CHECK(stream.Flushed());
+    BOOST_CHECK(chunks.size() > 1);
+    std::string strJSON = boost::algorithm::join(chunks, "");
+    BOOST_CHECK_EQUAL(strJSON, "{\"a\\\"b\":1,\"list\":[\"x\",{},[]],\"n\":null}");
+    UniValue parsed;
+    BOOST_CHECK(parsed.read(strJSON));
+    BOOST_CHECK_EQUAL(parsed["list"].size(), 3U);
+
+    // Unflushed output can be dropped
+    JSONStreamWriter discarded([](const std::string&) { BOOST_ERROR("unexpected flush"); });
+    discarded.BeginArray();
+    discarded.Value(1);
+    discarded.Discard();
+    BOOST_CHECK(!discarded.Started());
+
+    // Without a stream the array is collected as a UniValue
+    JSONRPCRequest request;
+    RPCResultArray collected(request);
+    collected.push_back(1);
+    collected.push_back("2");
+    BOOST_CHECK_EQUAL(collected.get().write(), "[1,\"2\"]");
+
+    chunks.clear();
+    JSONStreamWriter streamed([&chunks](const std::string& chunk) { chunks.push_back(chunk); });
+    request.stream = &streamed;
+    RPCResultArray streamedArray(request);
+    streamedArray.push_back(1);
+    streamedArray.push_back("2");
+    BOOST_CHECK(streamedArray.get().isNull());
+    streamed.Flush();
+    BOOST_CHECK_EQUAL(boost::algorithm::join(chunks, ""), "[1,\"2\"]");
+}
+
+static std::string PeekMethod(const std::string& strBody)
+{
+    return JSONRPCPeekMethod(strBody.data(), strBody.data() + strBody.size());
+}
+
+BOOST_AUTO_TEST_CASE(rpc_peek_method)
+{
+    BOOST_CHECK_EQUAL(PeekMethod("{\"method\":\"getblockcount\",\"params\":[]}"), "getblockcount");
+    BOOST_CHECK_EQUAL(PeekMethod(" \r\n{ \"id\" : 1 , \"method\" : \"getinfo\" }"), "getinfo");
+    // Only the top-level key counts, whatever comes before it
+    BOOST_CHECK_EQUAL(PeekMethod("{\"params\":[{\"method\":\"scantxoutset\"}],\"method\":\"getblockcount\"}"), "getblockcount");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"params\":{\"method\":\"scantxoutset\"},\"method\":\"echo\"}"), "echo");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"id\":\"\\\"method\\\": \\\"x\",\"method\":\"echo\"}"), "echo");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"params\":[\"]\",\"}\"],\"method\":\"echo\"}"), "echo");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"id\":null,\"jsonrpc\":1.0,\"method\":\"echo\"}"), "echo");
+    // Fall back to the default class
+    BOOST_CHECK_EQUAL(PeekMethod("{\"params\":{\"method\":\"scantxoutset\"}}"), "");
+    BOOST_CHECK_EQUAL(PeekMethod("[{\"method\":\"getblockcount\"}]"), "");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"method\":\"get\\u0062lockcount\"}"), "");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"method\":1}"), "");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"params\":[\"method\",\"echo\"]"), "");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"method\":\"getblock"), "");
+    BOOST_CHECK_EQUAL(PeekMethod("{\"id\" 1,\"method\":\"echo\"}"), "");
+    BOOST_CHECK_EQUAL(PeekMethod(""), "");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
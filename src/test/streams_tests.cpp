@@ -68,6 +68,33 @@ BOOST_AUTO_TEST_CASE(streams_vector_writer)
     vch.clear();
 }
 
+BOOST_AUTO_TEST_CASE(streams_span_reader)
+{
+    const unsigned char bytes[] = {1, 255, 3, 4, 5, 6};
+    CSpanReader reader(SER_NETWORK, INIT_PROTO_VERSION, bytes, sizeof(bytes));
+    BOOST_CHECK_EQUAL(reader.size(), 6);
+    BOOST_CHECK(!reader.empty());
+
+    unsigned char a(0), b(0);
+    reader >> a >> b;
+    BOOST_CHECK_EQUAL(a, 1);
+    BOOST_CHECK_EQUAL(b, 255);
+    BOOST_CHECK_EQUAL(reader.size(), 4);
+
+    uint16_t c;
+    reader.ignore(1);
+    reader >> c;
+    BOOST_CHECK_EQUAL(c, 0x0504);
+    BOOST_CHECK_EQUAL(reader.size(), 1);
+
+    // Reading past the end of the span throws
+    uint16_t d;
+    BOOST_CHECK_THROW(reader >> d, std::ios_base::failure);
+    BOOST_CHECK_THROW(reader.ignore(2), std::ios_base::failure);
+    reader.ignore(1);
+    BOOST_CHECK(reader.empty());
+}
+
 BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
 {
     std::vector<char> in;
@@ -9,6 +9,7 @@
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <crypto/sha256.h>
+#include <ethereum/SHA3.h>
 #include <miner.h>
 #include <net_processing.h>
 #include <noui.h>
@@ -49,6 +50,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
     : m_path_root(fs::temp_directory_path() / "test_syscoin" / strprintf("%lu_%i", (unsigned long)GetTime(), (int)(InsecureRandRange(1 << 30))))
 {
     SHA256AutoDetect();
+    dev::SHA3AutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
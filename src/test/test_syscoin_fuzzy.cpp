@@ -20,7 +20,10 @@
 #include <version.h>
 #include <pubkey.h>
 #include <blockencodings.h>
+#include <ethereum/RLP.h>
+#include <ethereum/RLPView.h>
 
+#include <assert.h>
 #include <stdint.h>
 #include <unistd.h>
 
@@ -49,6 +52,7 @@ enum TEST_ID {
     CTXOUTCOMPRESSOR_DESERIALIZE,
     BLOCKTRANSACTIONS_DESERIALIZE,
     BLOCKTRANSACTIONSREQUEST_DESERIALIZE,
+    RLPVIEW_DECODE,
     TEST_ID_END
 };
 
@@ -63,6 +67,39 @@ static bool read_stdin(std::vector<uint8_t> &data) {
     return length==0;
 }
 
+/** Check that RLPView reads data the way dev::RLP does, down to the nested items */
+static void check_rlpview(Span<const unsigned char> data) {
+    bool valid = data.size() > 0;
+    bool list = false;
+    bool items_valid = true;
+    size_t items = 0;
+    dev::bytesConstRef payload;
+    try {
+        const dev::RLP rlp(dev::bytesConstRef(data.data(), data.size()));
+        payload = rlp.payload();
+        list = rlp.isList();
+        try {
+            items = rlp.itemCount();
+        } catch (...) {
+            items_valid = false;
+        }
+    } catch (...) {
+        valid = false;
+    }
+    const RLPView view(data);
+    assert(view.IsValid() == valid);
+    if (!valid) return;
+    assert(view.IsList() == list);
+    assert(view.Payload() == Span<const unsigned char>(payload.data(), payload.size()));
+    std::vector<RLPView> item_views;
+    assert(view.GetItems(item_views) == (list && items_valid));
+    if (!list || !items_valid) return;
+    assert(item_views.size() == items);
+    for (const RLPView& item : item_views) {
+        check_rlpview(item.Data());
+    }
+}
+
 static int test_one_input(std::vector<uint8_t> buffer) {
     if (buffer.size() < sizeof(uint32_t)) return 0;
 
@@ -269,6 +306,12 @@ static int test_one_input(std::vector<uint8_t> buffer) {
 
             break;
         }
+        case RLPVIEW_DECODE:
+        {
+            const std::vector<unsigned char> data(ds.begin(), ds.end());
+            check_rlpview(MakeSpan(data));
+            break;
+        }
         default:
             return 0;
     }
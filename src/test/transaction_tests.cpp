@@ -768,4 +768,32 @@ BOOST_AUTO_TEST_CASE(test_IsStandard)
     BOOST_CHECK(!IsStandardTx(t, reason));
 }
 
+BOOST_AUTO_TEST_CASE(test_MakeTransactionRefs)
+{
+    // A mix of transactions with and without witness, converted together and one by one
+    std::vector<CMutableTransaction> txs(20);
+    for (size_t i = 0; i < txs.size(); i++) {
+        txs[i].vin.resize(1 + i % 3);
+        for (CTxIn& txin : txs[i].vin) {
+            txin.prevout = COutPoint(InsecureRand256(), i);
+            txin.scriptSig = CScript() << std::vector<unsigned char>(i * 7, 1);
+            if (i % 2)
+                txin.scriptWitness.stack.push_back(std::vector<unsigned char>(i * 5, 2));
+        }
+        txs[i].vout.resize(1);
+        txs[i].vout[0].nValue = i;
+    }
+    std::vector<CTransactionRef> expected;
+    for (const CMutableTransaction& tx : txs)
+        expected.push_back(MakeTransactionRef(tx));
+    std::vector<CTransactionRef> vtx;
+    MakeTransactionRefs(std::move(txs), vtx);
+    BOOST_CHECK_EQUAL(vtx.size(), expected.size());
+    for (size_t i = 0; i < vtx.size(); i++) {
+        BOOST_CHECK(vtx[i]->GetHash() == expected[i]->GetHash());
+        BOOST_CHECK(vtx[i]->GetWitnessHash() == expected[i]->GetWitnessHash());
+        BOOST_CHECK(*vtx[i] == *expected[i]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
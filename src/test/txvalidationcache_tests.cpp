@@ -369,4 +369,58 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, TestChain100Setup)
     }
 }
 
+
+BOOST_FIXTURE_TEST_CASE(package_script_checks, TestChain100Setup)
+{
+    // A chain of two spends, a spend with a bad signature and one with
+    // unknown inputs, verified as one package
+    CScript scriptPubKey = CScript() <<  ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    auto SpendAndSign = [&](const COutPoint& prevout, bool fBadSig) {
+        CMutableTransaction spend;
+        spend.nVersion = 1;
+        spend.vin.resize(1);
+        spend.vin[0].prevout = prevout;
+        spend.vout.resize(1);
+        spend.vout[0].nValue = 11*CENT;
+        spend.vout[0].scriptPubKey = scriptPubKey;
+        std::vector<unsigned char> vchSig;
+        uint256 hash = SignatureHash(scriptPubKey, spend, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+        if (fBadSig)
+            vchSig[30] ^= 1;
+        vchSig.push_back((unsigned char)SIGHASH_ALL);
+        spend.vin[0].scriptSig << vchSig;
+        return MakeTransactionRef(std::move(spend));
+    };
+    std::vector<CTransactionRef> package;
+    package.push_back(SpendAndSign(COutPoint(m_coinbase_txns[1]->GetHash(), 0), false));
+    package.push_back(SpendAndSign(COutPoint(package[0]->GetHash(), 0), false));
+    package.push_back(SpendAndSign(COutPoint(m_coinbase_txns[2]->GetHash(), 0), true));
+    package.push_back(SpendAndSign(COutPoint(InsecureRand256(), 0), false));
+
+    std::vector<bool> vInvalid;
+    CheckPackageScripts(package, vInvalid);
+    BOOST_CHECK_EQUAL(vInvalid.size(), 4U);
+    BOOST_CHECK(!vInvalid[0] && !vInvalid[1]);
+    // Only the bad signature is reported, unknown inputs are left to acceptance
+    BOOST_CHECK(vInvalid[2] && !vInvalid[3]);
+
+    LOCK(cs_main);
+
+    // The parent is cached now, the bad spend is not
+    CValidationState state;
+    std::vector<CScriptCheck> scriptchecks;
+    PrecomputedTransactionData txdata(*package[0]);
+    BOOST_CHECK(CheckInputs(*package[0], state, pcoinsTip.get(), true, STANDARD_SCRIPT_VERIFY_FLAGS, true, true, txdata, &scriptchecks));
+    BOOST_CHECK(scriptchecks.empty());
+    PrecomputedTransactionData txdataBad(*package[2]);
+    BOOST_CHECK(CheckInputs(*package[2], state, pcoinsTip.get(), true, STANDARD_SCRIPT_VERIFY_FLAGS, true, true, txdataBad, &scriptchecks));
+    BOOST_CHECK_EQUAL(scriptchecks.size(), 1U);
+
+    // Both spends of the chain are accepted without running their scripts again
+    BOOST_CHECK(ToMemPool(CMutableTransaction(*package[0])));
+    BOOST_CHECK(ToMemPool(CMutableTransaction(*package[1])));
+    mempool.clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
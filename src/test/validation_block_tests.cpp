@@ -5,6 +5,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <auxpow.h>
+#include <blockfilemap.h>
 #include <chainparams.h>
 #include <consensus/merkle.h>
 #include <consensus/validation.h>
@@ -15,6 +16,8 @@
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <future>
+
 struct RegtestingSetup : public TestingSetup {
     RegtestingSetup() : TestingSetup(CBaseChainParams::REGTEST) {}
 };
@@ -183,4 +186,89 @@ BOOST_AUTO_TEST_CASE(processnewblock_signals_ordering)
     BOOST_CHECK_EQUAL(sub.m_expected_tip, chainActive.Tip()->GetBlockHash());
 }
 
+// SYSCOIN
+struct SyscoinSubscriber : public CValidationInterface {
+    std::vector<std::string> m_events;
+
+    void NotifySyscoinUpdate(const char* value, const char* topic) override
+    {
+        m_events.push_back(std::string(topic) + ":" + value);
+    }
+
+    void SyscoinBlockChecked(const uint256& blockHash, bool fValid) override
+    {
+        m_events.push_back(std::string("checked:") + (fValid ? "valid" : "invalid"));
+    }
+};
+
+BOOST_AUTO_TEST_CASE(syscoin_notifications_queued)
+{
+    SyscoinSubscriber sub;
+    RegisterValidationInterface(&sub);
+    GetMainSignals().SetSyscoinQueueLimit(2);
+    const uint64_t nDroppedBefore = GetMainSignals().SyscoinNotificationsDropped();
+
+    // Hold up the background thread so that the notifications below pile up
+    std::promise<void> release;
+    std::shared_future<void> released(release.get_future());
+    CallFunctionInValidationInterfaceQueue([released] { released.wait(); });
+
+    GetMainSignals().NotifySyscoinUpdate("1", "assetallocation", false);
+    GetMainSignals().NotifySyscoinUpdate("2", "assetallocation", false);
+    // queue is full: unconfirmed notifications are dropped, confirmed ones are not
+    GetMainSignals().NotifySyscoinUpdate("3", "assetallocation", false);
+    GetMainSignals().NotifySyscoinUpdate("4", "assetrecord", true);
+    CBlock block;
+    GetMainSignals().BlockChecked(block, CValidationState());
+    BOOST_CHECK(sub.m_events.empty());
+
+    release.set_value();
+    SyncWithValidationInterfaceQueue();
+    UnregisterValidationInterface(&sub);
+    GetMainSignals().SetSyscoinQueueLimit(DEFAULT_MAX_SYSCOIN_NOTIFY_QUEUE);
+
+    const std::vector<std::string> expected{"assetallocation:1", "assetallocation:2", "assetrecord:4", "checked:valid"};
+    BOOST_CHECK(sub.m_events == expected);
+    BOOST_CHECK_EQUAL(GetMainSignals().SyscoinNotificationsDropped(), nDroppedBefore + 1);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_block_read)
+{
+    const CBlockIndex* pindex;
+    CDiskBlockPos pos;
+    {
+        LOCK(cs_main);
+        pindex = chainActive.Genesis();
+        pos = pindex->GetBlockPos();
+    }
+    const Consensus::Params& params = Params().GetConsensus();
+
+    CBlock blockStdio;
+    g_blockfilemap.SetEnabled(false);
+    BOOST_CHECK(ReadBlockFromDisk(blockStdio, pindex, params));
+
+    g_blockfilemap.SetEnabled(true);
+    CBlock blockMapped;
+    BOOST_CHECK(ReadBlockFromDisk(blockMapped, pindex, params));
+    BOOST_CHECK_EQUAL(blockMapped.GetHash(), blockStdio.GetHash());
+    BOOST_CHECK_EQUAL(blockMapped.vtx.size(), blockStdio.vtx.size());
+    CBlock blockNoAuxpow;
+    BOOST_CHECK(ReadBlockFromDisk(blockNoAuxpow, pindex, params, false));
+    BOOST_CHECK_EQUAL(blockNoAuxpow.GetHash(), blockStdio.GetHash());
+
+    const unsigned char* pblock;
+    unsigned int nBlockSize;
+    if (CBlockFileMap::Supported()) {
+        BOOST_CHECK(g_blockfilemap.GetBlock(pos, pblock, nBlockSize) != nullptr);
+        BOOST_CHECK_EQUAL(nBlockSize, ::GetSerializeSize(blockStdio, SER_DISK, CLIENT_VERSION));
+    }
+    // Positions outside the file are never served from a mapping
+    BOOST_CHECK(g_blockfilemap.GetBlock(CDiskBlockPos(pos.nFile, 1 << 30), pblock, nBlockSize) == nullptr);
+    BOOST_CHECK(g_blockfilemap.GetBlock(CDiskBlockPos(pos.nFile + 1, pos.nPos), pblock, nBlockSize) == nullptr);
+
+    g_blockfilemap.Prefetch({pos});
+    g_blockfilemap.SetEnabled(DEFAULT_MMAP_BLOCKS);
+    g_blockfilemap.Clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
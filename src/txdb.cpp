@@ -61,6 +61,20 @@ bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return db.Read(CoinEntry(&outpoint), coin);
 }
 
+size_t CCoinsViewDB::GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const {
+    std::vector<CoinEntry> keys;
+    keys.reserve(outpoints.size());
+    for (const COutPoint& outpoint : outpoints)
+        keys.emplace_back(&outpoint);
+    std::vector<bool> found;
+    const size_t nFound = db.ReadMany(keys, coins, found);
+    for (size_t i = 0; i < coins.size(); i++) {
+        if (!found[i])
+            coins[i].Clear();
+    }
+    return nFound;
+}
+
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
     return db.Exists(CoinEntry(&outpoint));
 }
@@ -81,6 +95,10 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    return WriteCoins(mapCoins, hashBlock, true);
+}
+
+bool CCoinsViewDB::WriteCoins(CCoinsMap &mapCoins, const uint256 &hashBlock, bool fErase) {
     CDBBatch batch(db);
     size_t count = 0;
     size_t changed = 0;
@@ -115,8 +133,12 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
             changed++;
         }
         count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
+        if (fErase) {
+            CCoinsMap::iterator itOld = it++;
+            mapCoins.erase(itOld);
+        } else {
+            ++it;
+        }
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
             db.WriteBatch(batch);
@@ -146,6 +168,167 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
+CCoinsViewWriteBehind::CCoinsViewWriteBehind(CCoinsViewDB* dbIn) : CCoinsViewBacked(dbIn), db(dbIn), fWriting(false), fFailed(false), fStop(false)
+{
+    threadWrite = std::thread(&TraceThread<std::function<void()>>, "coinswrite", std::function<void()>(std::bind(&CCoinsViewWriteBehind::ThreadWrite, this)));
+}
+
+CCoinsViewWriteBehind::~CCoinsViewWriteBehind()
+{
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        cond.wait(lock, [this] { return !fWriting; });
+        fStop = true;
+    }
+    cond.notify_all();
+    threadWrite.join();
+}
+
+void CCoinsViewWriteBehind::ThreadWrite()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            cond.wait(lock, [this] { return fWriting || fStop; });
+            if (!fWriting)
+                return;
+        }
+        // mapWriting is not modified while fWriting is set, so lookups can
+        // keep reading it while it is being written
+        bool ret = false;
+        try {
+            ret = db->WriteCoins(*mapWriting, hashWriting, false);
+        } catch (const std::exception& e) {
+            LogPrintf("%s: failed to write to coin database: %s\n", __func__, e.what());
+        }
+        std::unique_ptr<CCoinsMap> mapWritten;
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            mapWritten = std::move(mapWriting);
+            fFailed |= !ret;
+            fWriting = false;
+        }
+        cond.notify_all();
+        // mapWritten is freed here, outside the lock
+    }
+}
+
+bool CCoinsViewWriteBehind::GetCoin(const COutPoint &outpoint, Coin &coin) const
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (mapWriting) {
+            CCoinsMap::const_iterator it = mapWriting->find(outpoint);
+            if (it != mapWriting->end()) {
+                if (it->second.coin.IsSpent())
+                    return false;
+                coin = it->second.coin;
+                return true;
+            }
+        }
+    }
+    // Not part of the write in flight, so the database is up to date for it
+    return base->GetCoin(outpoint, coin);
+}
+
+size_t CCoinsViewWriteBehind::GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const
+{
+    size_t nFound = 0;
+    std::vector<size_t> vMissing;
+    coins.resize(outpoints.size());
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        for (size_t i = 0; i < outpoints.size(); i++) {
+            if (!mapWriting) {
+                vMissing.push_back(i);
+                continue;
+            }
+            CCoinsMap::const_iterator it = mapWriting->find(outpoints[i]);
+            if (it == mapWriting->end()) {
+                vMissing.push_back(i);
+            } else if (it->second.coin.IsSpent()) {
+                coins[i].Clear();
+            } else {
+                coins[i] = it->second.coin;
+                nFound++;
+            }
+        }
+    }
+    if (vMissing.empty())
+        return nFound;
+    // Everything else is read from the database in one go
+    std::vector<COutPoint> vOutpoints;
+    vOutpoints.reserve(vMissing.size());
+    for (size_t i : vMissing)
+        vOutpoints.push_back(outpoints[i]);
+    std::vector<Coin> vCoins;
+    nFound += base->GetCoins(vOutpoints, vCoins);
+    for (size_t j = 0; j < vMissing.size(); j++)
+        coins[vMissing[j]] = std::move(vCoins[j]);
+    return nFound;
+}
+
+bool CCoinsViewWriteBehind::HaveCoin(const COutPoint &outpoint) const
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (mapWriting) {
+            CCoinsMap::const_iterator it = mapWriting->find(outpoint);
+            if (it != mapWriting->end())
+                return !it->second.coin.IsSpent();
+        }
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CCoinsViewWriteBehind::GetBestBlock() const
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (fWriting)
+            return hashWriting;
+    }
+    return base->GetBestBlock();
+}
+
+bool CCoinsViewWriteBehind::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock)
+{
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        cond.wait(lock, [this] { return !fWriting; });
+        if (fFailed)
+            return false;
+        // Take the entries over as they are; ones that are not dirty are
+        // skipped by the write and meanwhile still answer lookups.
+        mapWriting.reset(new CCoinsMap(std::move(mapCoins)));
+        hashWriting = hashBlock;
+        fWriting = true;
+    }
+    cond.notify_all();
+    mapCoins.clear();
+    return true;
+}
+
+CCoinsViewCursor *CCoinsViewWriteBehind::Cursor() const
+{
+    // A cursor iterates the database itself, let it see all written coins
+    Sync();
+    return base->Cursor();
+}
+
+bool CCoinsViewWriteBehind::Sync() const
+{
+    std::unique_lock<std::mutex> lock(cs);
+    cond.wait(lock, [this] { return !fWriting; });
+    return !fFailed;
+}
+
+bool CCoinsViewWriteBehind::Writing() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return fWriting;
+}
+
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(gArgs.IsArgSet("-blocksdir") ? GetDataDir() / "blocks" / "index" : GetBlocksDir() / "index", nCacheSize, fMemory, fWipe) {
 }
 
@@ -11,9 +11,12 @@
 #include <chain.h>
 #include <primitives/block.h>
 
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -39,6 +42,8 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! -coinswritebehind default
+static const bool DEFAULT_COINS_WRITE_BEHIND = false;
 
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
@@ -49,6 +54,7 @@ public:
     explicit CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    size_t GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
@@ -58,6 +64,53 @@ public:
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
+
+    //! Write the dirty entries of mapCoins, erasing entries as they are written if fErase is set.
+    bool WriteCoins(CCoinsMap &mapCoins, const uint256 &hashBlock, bool fErase);
+};
+
+/**
+ * Write-behind layer between the coins cache and the coin database (-coinswritebehind).
+ *
+ * BatchWrite() takes over the entries of a cache flush and returns at once; a
+ * background thread commits them to the database. Until that completes,
+ * lookups are answered from the snapshot first, so blocks keep connecting
+ * against an up to date view. At most one write is in flight: the next
+ * BatchWrite() or Sync() waits for it. The head-blocks marker written by
+ * CCoinsViewDB covers a crash during a background write just as it does a
+ * synchronous one, and the blocks are replayed on the next start.
+ */
+class CCoinsViewWriteBehind final : public CCoinsViewBacked
+{
+private:
+    CCoinsViewDB* db;
+    mutable std::mutex cs;
+    mutable std::condition_variable cond;
+    //! Entries being written, only replaced while no write is in flight
+    std::unique_ptr<CCoinsMap> mapWriting;
+    uint256 hashWriting;
+    bool fWriting;
+    bool fFailed;
+    bool fStop;
+    std::thread threadWrite;
+
+    void ThreadWrite();
+
+public:
+    explicit CCoinsViewWriteBehind(CCoinsViewDB* dbIn);
+    ~CCoinsViewWriteBehind();
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    size_t GetCoins(const std::vector<COutPoint> &outpoints, std::vector<Coin> &coins) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    uint256 GetBestBlock() const override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    CCoinsViewCursor *Cursor() const override;
+
+    //! Wait for the write in flight, if any. Returns false if a background write failed.
+    bool Sync() const;
+    //! Whether a write is in flight
+    bool Writing() const;
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
@@ -6,6 +6,7 @@
 #ifndef SYSCOIN_TXMEMPOOL_H
 #define SYSCOIN_TXMEMPOOL_H
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <map>
@@ -22,7 +23,9 @@
 #include <random.h>
 
 #include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/signals2/signal.hpp>
@@ -317,6 +320,23 @@ public:
 struct descendant_score {};
 struct entry_time {};
 struct ancestor_score {};
+// SYSCOIN
+struct sender_arrival {};
+
+/**
+ * An asset allocation transaction in the mempool, indexed by its sender tuple
+ * and ZDAG arrival time (in milliseconds) so all pending sends of one sender
+ * can be visited in arrival order. Sends without a recorded arrival time (not
+ * checked yet, checked in sanity mode only, or whose time was dropped when the
+ * sender's conflicts were reset) have NO_ASSET_ALLOCATION_ARRIVAL and sort last.
+ */
+static const int64_t NO_ASSET_ALLOCATION_ARRIVAL = INT64_MAX;
+struct AssetAllocationArrival
+{
+    std::string strSender;
+    int64_t nArrivalTime;
+    uint256 txHash;
+};
 
 class CBlockPolicyEstimator;
 
@@ -443,6 +463,8 @@ class CTxMemPool
 private:
     uint32_t nCheckFrequency GUARDED_BY(cs); //!< Value n means that n times in 2^32 we check.
     unsigned int nTransactionsUpdated; //!< Used by getblocktemplate to trigger CreateNewBlock() invocation
+    // SYSCOIN
+    std::atomic<unsigned int> nAssetAllocationsUpdated{0}; //!< Bumped when ZDAG arrival times or conflicts change, which nTransactionsUpdated misses
     CBlockPolicyEstimator* minerPolicyEstimator;
 
     uint64_t totalTxSize;      //!< sum of all mempool tx's virtual sizes. Differs from serialized tx size since witness data is discounted. Defined in BIP 141.
@@ -484,6 +506,28 @@ public:
         >
     > indexed_transaction_set;
 
+    // SYSCOIN
+    typedef boost::multi_index_container<
+        AssetAllocationArrival,
+        boost::multi_index::indexed_by<
+            // sorted by txid
+            boost::multi_index::hashed_unique<
+                boost::multi_index::member<AssetAllocationArrival, uint256, &AssetAllocationArrival::txHash>,
+                SaltedTxidHasher
+            >,
+            // sorted by sender tuple, then arrival time
+            boost::multi_index::ordered_unique<
+                boost::multi_index::tag<sender_arrival>,
+                boost::multi_index::composite_key<
+                    AssetAllocationArrival,
+                    boost::multi_index::member<AssetAllocationArrival, std::string, &AssetAllocationArrival::strSender>,
+                    boost::multi_index::member<AssetAllocationArrival, int64_t, &AssetAllocationArrival::nArrivalTime>,
+                    boost::multi_index::member<AssetAllocationArrival, uint256, &AssetAllocationArrival::txHash>
+                >
+            >
+        >
+    > indexed_arrival_set;
+
     mutable CCriticalSection cs;
     indexed_transaction_set mapTx GUARDED_BY(cs);
 
@@ -518,6 +562,8 @@ private:
 
 public:
     indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
+    // SYSCOIN
+    indexed_arrival_set mapAssetAllocationArrivals GUARDED_BY(cs); //!< Asset allocation sends in mapTx by sender and arrival time
     std::map<uint256, CAmount> mapDeltas;
 
     /** Create a new CTxMemPool.
@@ -549,6 +595,10 @@ public:
     void removeForBlock(const std::vector<CTransactionRef>& vtx, unsigned int nBlockHeight);
     // SYSCOIN
     void removeExpiredMempoolBalances(setEntries& stage);
+    /** Record the ZDAG arrival time of an asset allocation send already in the pool. */
+    void UpdateAssetAllocationArrival(const uint256& txHash, int64_t nArrivalTime);
+    /** Mark the sends of a sender whose arrival times were dropped as having none. */
+    void SyncAssetAllocationArrivals(const std::string& strSender);
     
     void clear();
     void _clear() EXCLUSIVE_LOCKS_REQUIRED(cs); //lock free
@@ -557,6 +607,10 @@ public:
     bool isSpent(const COutPoint& outpoint) const;
     unsigned int GetTransactionsUpdated() const;
     void AddTransactionsUpdated(unsigned int n);
+    // SYSCOIN
+    unsigned int GetAssetAllocationsUpdated() const { return nAssetAllocationsUpdated; }
+    /** Note a change of ZDAG state; takes no lock, so it can be called under any of them. */
+    void AssetAllocationsUpdated() { nAssetAllocationsUpdated++; }
     /**
      * Check that none of this transactions inputs are in the mempool, and thus
      * the tx is not dependent on other mempool transactions to be included in a block.
@@ -693,6 +747,9 @@ private:
      *  removal.
      */
     void removeUnchecked(txiter entry, MemPoolRemovalReason reason = MemPoolRemovalReason::UNKNOWN) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    // SYSCOIN
+    /** Add tx to mapAssetAllocationArrivals if it is an asset allocation send. */
+    void addAssetAllocationArrival(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs);
 };
 
 /**
@@ -90,6 +90,8 @@ bool fConcurrentProcessing = true;
 bool fLiteMode = false;
 bool fZMQAssetAllocation = false;
 bool fZMQAsset = false;
+bool fZMQAssetAllocationRaw = false;
+bool fZMQAssetRaw = false;
 uint32_t fGethSyncHeight = 0;
 uint32_t fGethCurrentHeight = 0;
 pid_t gethPID = 0;
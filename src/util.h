@@ -50,6 +50,8 @@ extern bool fTPSTestEnabled;
 extern bool fAssetAllocationIndex;
 extern bool fZMQAssetAllocation;
 extern bool fZMQAsset;
+extern bool fZMQAssetAllocationRaw;
+extern bool fZMQAssetRaw;
 extern bool fConcurrentProcessing;
 extern bool fLiteMode;
 extern uint32_t fGethSyncHeight;
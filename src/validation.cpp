@@ -7,6 +7,7 @@
 
 #include <arith_uint256.h>
 #include <auxpow.h>
+#include <blockfilemap.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -42,8 +43,12 @@
 #include <validationinterface.h>
 #include <warnings.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <future>
+#include <mutex>
 #include <sstream>
+#include <unordered_set>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/thread.hpp>
@@ -204,13 +209,13 @@ public:
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to mapBlockIndex.
      */
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Block (dis)connection on a given view:
     DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view);
     bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
-                    CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false);
+                    CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false, bool fTemplate = false);
 
     // Block disconnection on our pcoinsTip:
     bool DisconnectTip(CValidationState& state, const CChainParams& chainparams, DisconnectedBlockTransactions *disconnectpool);
@@ -272,6 +277,7 @@ bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
+int nBlockPrefetch = DEFAULT_BLOCK_PREFETCH;
 bool fEnableReplacement = DEFAULT_ENABLE_REPLACEMENT;
 
 uint256 hashAssumeValid;
@@ -336,6 +342,7 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 }
 
 std::unique_ptr<CCoinsViewDB> pcoinsdbview;
+std::unique_ptr<CCoinsViewWriteBehind> pcoinswritebehind;
 std::unique_ptr<CCoinsViewCache> pcoinsTip;
 std::unique_ptr<CBlockTreeDB> pblocktree;
 
@@ -603,45 +610,44 @@ bool CheckSyscoinMint(const bool ibd, const CTransaction& tx, CValidationState&
         }
     }
     const std::vector<unsigned char> &vchTxRoot = mintSyscoin.vchTxRoot;
-    dev::RLP rlpTxRoot(&vchTxRoot);
     const std::vector<unsigned char> &vchParentNodes = mintSyscoin.vchParentNodes;
-    dev::RLP rlpParentNodes(&vchParentNodes);
     const std::vector<unsigned char> &vchValue = mintSyscoin.vchValue;
-    dev::RLP rlpValue(&vchValue);
     const std::vector<unsigned char> &vchPath = mintSyscoin.vchPath;
-    if(!VerifyProof(&vchPath, rlpValue, rlpParentNodes, rlpTxRoot)){
+    if(!VerifyProof(MakeSpan(vchPath), MakeSpan(vchValue), MakeSpan(vchParentNodes), MakeSpan(vchTxRoot))){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Could not verify ethereum transaction using SPV proof");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     } 
-    if (!rlpValue.isList()){
+    const RLPView rlpValue(MakeSpan(vchValue));
+    std::vector<RLPView> vValueItems;
+    if (!rlpValue.IsList()){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Transaction RLP must be a list");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     }
-    if (rlpValue.itemCount() < 6){
+    if (!rlpValue.GetItems(vValueItems) || vValueItems.size() < 6){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Transaction RLP invalid item count");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     }        
-    if (!rlpValue[5].isData()){
+    if (!vValueItems[5].IsData()){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Transaction data RLP must be an array");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     }        
-    if (rlpValue[3].isEmpty()){
+    if (!vValueItems[3].IsData() || vValueItems[3].Payload().size() != 20){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Invalid transaction receiver");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     }                       
-    const dev::Address &address160 = rlpValue[3].toHash<dev::Address>(dev::RLP::VeryStrict);
-    if(tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN && Params().GetConsensus().vchSYSXContract != address160.asBytes()){
+    const Span<const unsigned char> address160 = vValueItems[3].Payload();
+    if(tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN && MakeSpan(Params().GetConsensus().vchSYSXContract) != address160){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Receiver not the expected SYSX contract address");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     }
-    else if(tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET && dbAsset.vchContract != address160.asBytes()){
+    else if(tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET && MakeSpan(dbAsset.vchContract) != address160){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Receiver not the expected SYSX contract address");
         return state.DoS(100, false, REJECT_INVALID, errorMessage);
     }
     
     CAmount outputAmount;
     uint32_t nAsset = 0;
-    const std::vector<unsigned char> &rlpBytes = rlpValue[5].data().toBytes();
+    const Span<const unsigned char> rlpBytes = vValueItems[5].Data();
     CWitnessAddress witnessAddress;
     if(tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN && !parseEthMethodInputData(Params().GetConsensus().vchSYSXBurnMethodSignature, rlpBytes, outputAmount, nAsset, witnessAddress)){
         errorMessage = "SYSCOIN_ASSET_ALLOCATION_CONSENSUS_ERROR ERRCODE: 1001 - " + _("Could not parse and validate transaction data");
@@ -774,7 +780,8 @@ bool CheckSyscoinInputs(const bool ibd, const CTransaction& tx, CValidationState
             const CTransaction &tx = *(block.vtx[i]);
             if(tx.IsCoinBase())
                 continue;
-            if((tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN || tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET) && !CheckSyscoinMint(ibd, tx, state, false, nHeight, mapAssets, mapAssetAllocations))
+            // SYSCOIN the mint index and its notification wait for the block to be connected
+            if((tx.nVersion == SYSCOIN_TX_VERSION_MINT_SYSCOIN || tx.nVersion == SYSCOIN_TX_VERSION_MINT_ASSET) && !CheckSyscoinMint(ibd, tx, state, fJustCheck || bMiner, nHeight, mapAssets, mapAssetAllocations))
                 return state.DoS(100, error("%s: check syscoin mint", __func__), REJECT_INVALID, FormatStateMessage(state));
             else if (tx.nVersion != SYSCOIN_TX_VERSION_ASSET)
                 continue;
@@ -789,7 +796,7 @@ bool CheckSyscoinInputs(const bool ibd, const CTransaction& tx, CValidationState
             else if (DecodeAssetTx(tx, op, vvchArgs))
             {
                 errorMessage.clear();
-                good = CheckAssetInputs(tx, inputs, op, vvchArgs, false, nHeight, mapAssets, mapAssetAllocations, errorMessage, fJustCheck);
+                good = CheckAssetInputs(tx, inputs, op, vvchArgs, false, nHeight, mapAssets, mapAssetAllocations, errorMessage, fJustCheck, bMiner);
             }                         
             if (!good)
             {
@@ -807,9 +814,9 @@ bool CheckSyscoinInputs(const bool ibd, const CTransaction& tx, CValidationState
         }
 
         if(!bSanity && !fJustCheck){
-            if(!bMiner && (!passetallocationdb->Flush(mapAssetAllocations) || !passetdb->Flush(mapAssets))){
-                good = false;
-                errorMessage = "Error flushing to asset dbs";
+            if(!bMiner){
+                UpdateAssetAllocationCache(mapAssetAllocations);
+                UpdateAssetCache(mapAssets);
             }
             mapAssetAllocations.clear();
             mapAssets.clear();
@@ -927,11 +934,22 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, CValidationSt
     // SYSCOIN
     return CheckInputs(tx, state, view, true, flags, cacheSigStore, true, txdata, pvChecks, pvChecksConcurrent,hashCacheEntry);
 }
-// SYSCOIN
-static CuckooCache::cache<uint256, SignatureCacheHasher> scriptExecutionCache;
+// SYSCOIN the ZDAG workers use the cache without cs_main, so it locks per shard
+static CuckooCache::sharded_cache<uint256, SignatureCacheHasher> scriptExecutionCache;
 static uint256 scriptExecutionCacheNonce(GetRandHash());
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
 
+/** Key of the execution of tx's scripts with the given flags in scriptExecutionCache */
+static uint256 GetScriptExecutionCacheEntry(const CTransaction& tx, unsigned int flags)
+{
+    uint256 hashCacheEntry;
+    // We only use the first 19 bytes of nonce to avoid a second SHA
+    // round - giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
+    static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
+    CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetWitnessHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
+    return hashCacheEntry;
+}
+
 void ThreadScriptCheck() {
     RenameThread("syscoin-scriptch");
     scriptcheckqueue.Thread();
@@ -1511,6 +1529,81 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
     return AcceptToMemoryPoolWithTime(chainparams, pool, state, tx, pfMissingInputs, GetTime(), plTxnReplaced, bypass_limits, nAbsurdFee, test_accept,bMultiThreaded);
 }
 
+void CheckPackageScripts(const std::vector<CTransactionRef>& package, std::vector<bool>& vInvalid)
+{
+    vInvalid.assign(package.size(), false);
+    // the flags AcceptToMemoryPool checks with, so that it finds the cache entries
+    const unsigned int flags = STANDARD_SCRIPT_VERIFY_FLAGS;
+
+    // Pre-pass: transactions whose scripts were executed before are done, the
+    // checks of all others are gathered for one run of the check queue. The
+    // checks carry copies of the outputs they spend, so only this pass needs
+    // the locks.
+    std::vector<size_t> vPending;
+    std::vector<uint256> vCacheEntries;
+    std::vector<std::vector<CTxOut>> vSpent;
+    std::vector<PrecomputedTransactionData> txdata;
+    txdata.reserve(package.size());
+    std::vector<CScriptCheck> vChecks;
+    {
+        LOCK2(cs_main, mempool.cs);
+        CCoinsViewMemPool viewMempool(pcoinsTip.get(), mempool);
+        CCoinsViewCache view(&viewMempool);
+        for (size_t i = 0; i < package.size(); i++) {
+            const CTransaction& tx = *package[i];
+            if (tx.IsCoinBase())
+                continue;
+            const uint256 hashCacheEntry = GetScriptExecutionCacheEntry(tx, flags);
+            if (!scriptExecutionCache.contains(hashCacheEntry, false)) {
+                std::vector<CTxOut> vOut;
+                vOut.reserve(tx.vin.size());
+                for (const CTxIn& txin : tx.vin) {
+                    const Coin& coin = view.AccessCoin(txin.prevout);
+                    if (coin.IsSpent())
+                        break;
+                    vOut.push_back(coin.out);
+                }
+                if (vOut.size() == tx.vin.size()) {
+                    txdata.emplace_back(tx);
+                    for (unsigned int n = 0; n < tx.vin.size(); n++)
+                        vChecks.emplace_back(vOut[n], tx, n, flags, true, &txdata.back());
+                    vPending.push_back(i);
+                    vCacheEntries.push_back(hashCacheEntry);
+                    vSpent.push_back(std::move(vOut));
+                }
+            }
+            // later transactions of the package may spend this one
+            AddCoins(view, tx, MEMPOOL_HEIGHT, true);
+        }
+    }
+    if (vPending.empty())
+        return;
+
+    bool fAllValid;
+    {
+        CCheckQueueControl<CScriptCheck> control(&scriptcheckqueue);
+        control.Add(vChecks);
+        fAllValid = control.Wait();
+    }
+    for (size_t k = 0; k < vPending.size(); k++) {
+        const CTransaction& tx = *package[vPending[k]];
+        bool fValid = fAllValid;
+        if (!fValid) {
+            // Find the transactions that failed; the signatures that verified
+            // are in the signature cache by now, so this is cheap for the rest
+            fValid = true;
+            for (unsigned int n = 0; n < tx.vin.size() && fValid; n++) {
+                CScriptCheck check(vSpent[k][n], tx, n, flags, true, &txdata[k]);
+                fValid = check();
+            }
+        }
+        if (fValid)
+            scriptExecutionCache.insert(vCacheEntries[k]);
+        vInvalid[vPending[k]] = !fValid;
+    }
+    LogPrint(BCLog::MEMPOOL, "%s: verified %u of %u package transactions in one run\n", __func__, vPending.size(), package.size());
+}
+
 /**
  * Return transaction in txOut, and if it was found inside a block, its hash is placed in hashBlock.
  * If blockIndex is provided, the transaction is fetched from the corresponding block.
@@ -1618,12 +1711,31 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
    both a block and its header.  */
 
 template<typename T>
-static bool ReadBlockOrHeader(T& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams)
+static bool ReadBlockOrHeader(T& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fReadAuxpow = true)
 {
     block.SetNull();
 
+    const int nVersion = CLIENT_VERSION | (fReadAuxpow ? 0 : SERIALIZE_BLOCK_NO_AUXPOW);
+
+    // SYSCOIN read straight from the mapped block file when possible
+    const unsigned char* pblock = nullptr;
+    unsigned int nBlockSize = 0;
+    std::shared_ptr<const CMappedBlockFile> mapped = g_blockfilemap.GetBlock(pos, pblock, nBlockSize);
+    if (mapped) {
+        try {
+            CSpanReader spanin(SER_DISK, nVersion, pblock, nBlockSize);
+            spanin >> block;
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize error - %s at %s", __func__, e.what(), pos.ToString());
+        }
+        if (fReadAuxpow && !CheckProofOfWork(block, consensusParams))
+            return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
+        return true;
+    }
+
     // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, nVersion);
     if (filein.IsNull())
         return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
 
@@ -1635,15 +1747,16 @@ static bool ReadBlockOrHeader(T& block, const CDiskBlockPos& pos, const Consensu
         return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
     }
 
-    // Check the header
-    if (!CheckProofOfWork(block, consensusParams))
+    // Check the header. Without the auxpow there is nothing to check; the
+    // caller matches the hash against the block index instead.
+    if (fReadAuxpow && !CheckProofOfWork(block, consensusParams))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
 
     return true;
 }
 
 template<typename T>
-static bool ReadBlockOrHeader(T& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+static bool ReadBlockOrHeader(T& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fReadAuxpow = true)
 {
     CDiskBlockPos blockPos;
     {
@@ -1651,7 +1764,7 @@ static bool ReadBlockOrHeader(T& block, const CBlockIndex* pindex, const Consens
         blockPos = pindex->GetBlockPos();
     }
 
-    if (!ReadBlockOrHeader(block, blockPos, consensusParams))
+    if (!ReadBlockOrHeader(block, blockPos, consensusParams, fReadAuxpow))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
@@ -1664,9 +1777,9 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     return ReadBlockOrHeader(block, pos, consensusParams);
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fReadAuxpow)
 {
-    return ReadBlockOrHeader(block, pindex, consensusParams);
+    return ReadBlockOrHeader(block, pindex, consensusParams, fReadAuxpow);
 }
 
 bool ReadBlockHeaderFromDisk(CBlockHeader& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
@@ -1674,6 +1787,26 @@ bool ReadBlockHeaderFromDisk(CBlockHeader& block, const CBlockIndex* pindex, con
     return ReadBlockOrHeader(block, pindex, consensusParams);
 }
 
+void CBlockPrefetcher::Advance(const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    if (nBlockPrefetch <= 0 || pindex == nullptr)
+        return;
+    const int nTargetHeight = pindex->nHeight + nBlockPrefetch;
+    const bool fContinue = m_last_prefetched != nullptr && chainActive.Contains(m_last_prefetched) && m_last_prefetched->nHeight > pindex->nHeight;
+    // Refill the window once the walk is halfway through it
+    if (fContinue && m_last_prefetched->nHeight >= pindex->nHeight + nBlockPrefetch / 2)
+        return;
+    std::vector<CDiskBlockPos> vPos;
+    for (const CBlockIndex* pindexNext = chainActive.Next(fContinue ? m_last_prefetched : pindex);
+         pindexNext != nullptr && pindexNext->nHeight <= nTargetHeight; pindexNext = chainActive.Next(pindexNext)) {
+        if (pindexNext->nStatus & BLOCK_HAVE_DATA)
+            vPos.push_back(pindexNext->GetBlockPos());
+        m_last_prefetched = pindexNext;
+    }
+    g_blockfilemap.Prefetch(vPos);
+}
+
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& message_start)
 {
     CDiskBlockPos hpos = pos;
@@ -2006,12 +2139,7 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
             // correct (ie that the transaction hash which is in tx's prevouts
             // properly commits to the scriptPubKey in the inputs view of that
             // transaction).
-            uint256 hashCacheEntry;
-            // We only use the first 19 bytes of nonce to avoid a second SHA
-            // round - giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
-            static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
-            CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetWitnessHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
-            AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
+            const uint256 hashCacheEntry = GetScriptExecutionCacheEntry(tx, flags);
             // SYSCOIN
             if (hashCacheEntryOut)
                 *hashCacheEntryOut = hashCacheEntry;
@@ -2195,7 +2323,7 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
 {
     // SYSCOIN
-    if(!passetdb || !passetallocationdb){
+    if(!passetcache || !passetallocationcache){
         error("DisconnectBlock(): Syscoin dbs do not exist");
         return DISCONNECT_FAILED;
     }
@@ -2252,10 +2380,8 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
             fClean = false;
     } 
     // SYSCOIN 
-    if(!passetallocationdb->Flush(mapAssetAllocations) || !passetdb->Flush(mapAssets)){
-       error("DisconnectBlock(): Error flushing to asset dbs on disconnect");
-       return DISCONNECT_FAILED;
-    }  
+    UpdateAssetAllocationCache(mapAssetAllocations);
+    UpdateAssetCache(mapAssets);
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
@@ -2400,6 +2526,185 @@ static unsigned int GetBlockScriptFlags(const CBlockIndex* pindex, const Consens
 
 
 
+// SYSCOIN
+/** Work shared by the threads reading the coins and asset records a block needs */
+struct BlockPrefetch {
+    const CCoinsView* base;
+    const CBlock* block;
+    std::vector<COutPoint> vOutpoints;
+    std::vector<Coin> vCoins;
+    //! Task 0 loads the asset records, the others each read a batch of coins
+    size_t nTasks = 0;
+    std::atomic<size_t> nNext{0};
+    size_t nDone = 0;
+    //! First database error a task ran into, raised again on the calling thread
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    void ReadCoins(size_t nBatch)
+    {
+        const size_t nBegin = nBatch * COINS_PREFETCH_BATCH;
+        const size_t nEnd = std::min<size_t>(nBegin + COINS_PREFETCH_BATCH, vOutpoints.size());
+        const std::vector<COutPoint> vBatch(vOutpoints.begin() + nBegin, vOutpoints.begin() + nEnd);
+        std::vector<Coin> vBatchCoins;
+        base->GetCoins(vBatch, vBatchCoins);
+        for (size_t i = nBegin; i < nEnd; i++)
+            vCoins[i] = std::move(vBatchCoins[i - nBegin]);
+    }
+
+    /** Run tasks until none are left */
+    void Run()
+    {
+        size_t nRun = 0;
+        std::exception_ptr taskError;
+        for (size_t i = nNext++; i < nTasks; i = nNext++) {
+            // a task that fails still counts as done, or the caller would wait forever
+            try {
+                if (i == 0)
+                    PrefetchAssetCaches(*block);
+                else
+                    ReadCoins(i - 1);
+            } catch (...) {
+                taskError = std::current_exception();
+            }
+            nRun++;
+        }
+        if (nRun > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (taskError && !error)
+                error = taskError;
+            nDone += nRun;
+            if (nDone == nTasks)
+                cond.notify_one();
+        }
+    }
+};
+
+/**
+ * Warm the caches for a block about to be connected on top of pcoinsTip: the
+ * coins it spends that are not cached yet, and its asset and allocation
+ * records, are read in batches on the thread pool. The calling thread takes
+ * part and waits for all reads, so nothing is left in flight once
+ * ConnectBlock() moves on. A database error on a pool thread is raised again
+ * here, as the same read on the calling thread would have.
+ */
+static void PrefetchBlockInputs(const CBlock& block, const CCoinsViewCache& view)
+{
+    AssertLockHeld(cs_main);
+    // Only worth it (and only safe to fill pcoinsTip) when the block is connected on top of it
+    if (view.GetBackend() != pcoinsTip.get())
+        return;
+    auto prefetch = std::make_shared<BlockPrefetch>();
+    prefetch->base = pcoinsTip->GetBackend();
+    prefetch->block = &block;
+    std::unordered_set<uint256, SaltedTxidHasher> setCreated;
+    for (const auto& tx : block.vtx)
+        setCreated.insert(tx->GetHash());
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase())
+            continue;
+        for (const CTxIn& txin : tx->vin) {
+            if (!setCreated.count(txin.prevout.hash) && !view.HaveCoinInCache(txin.prevout) && !pcoinsTip->HaveCoinInCache(txin.prevout))
+                prefetch->vOutpoints.push_back(txin.prevout);
+        }
+    }
+    prefetch->vCoins.resize(prefetch->vOutpoints.size());
+    prefetch->nTasks = 1 + (prefetch->vOutpoints.size() + COINS_PREFETCH_BATCH - 1) / COINS_PREFETCH_BATCH;
+    if (threadpool != nullptr) {
+        const size_t nWorkers = std::min<size_t>(GetNumCores(), prefetch->nTasks);
+        // tasks that only get to run after everything is read find nothing left to do
+        for (size_t i = 1; i < nWorkers; i++) {
+            if (!threadpool->tryPost([prefetch] { prefetch->Run(); }))
+                break;
+        }
+    }
+    prefetch->Run();
+    {
+        std::unique_lock<std::mutex> lock(prefetch->mutex);
+        prefetch->cond.wait(lock, [&prefetch] { return prefetch->nDone == prefetch->nTasks; });
+    }
+    if (prefetch->error)
+        std::rethrow_exception(prefetch->error);
+    pcoinsTip->Warm(prefetch->vOutpoints, prefetch->vCoins);
+}
+
+// SYSCOIN
+/** Work shared by the threads preparing the transactions of a block template for their script checks */
+struct TemplateTxData {
+    const CBlock* block;
+    std::vector<PrecomputedTransactionData>* txdata;
+    //! Transactions whose script executions are not cached
+    std::vector<unsigned int> vIndexes;
+    size_t nTasks = 0;
+    std::atomic<size_t> nNext{0};
+    size_t nDone = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    /** Run tasks until none are left */
+    void Run()
+    {
+        size_t nRun = 0;
+        for (size_t i = nNext++; i < nTasks; i = nNext++) {
+            const size_t nEnd = std::min<size_t>((i + 1) * TEMPLATE_TXDATA_BATCH, vIndexes.size());
+            for (size_t j = i * TEMPLATE_TXDATA_BATCH; j < nEnd; j++)
+                (*txdata)[vIndexes[j]] = PrecomputedTransactionData(*block->vtx[vIndexes[j]]);
+            nRun++;
+        }
+        if (nRun > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            nDone += nRun;
+            if (nDone == nTasks)
+                cond.notify_one();
+        }
+    }
+};
+
+/**
+ * Look up which transactions of a block template had their scripts verified
+ * with the given flags already, normally on mempool entry, and precompute the
+ * signature hash data of the others on the thread pool. The calling thread
+ * takes part and waits for all of it. Returns the number of cached ones.
+ */
+static unsigned int PrepareTemplateScriptChecks(const CBlock& block, unsigned int flags, std::vector<PrecomputedTransactionData>& txdata, std::vector<bool>& vScriptsCached)
+{
+    AssertLockHeld(cs_main);
+    auto prep = std::make_shared<TemplateTxData>();
+    prep->block = &block;
+    prep->txdata = &txdata;
+    txdata.resize(block.vtx.size());
+    vScriptsCached.assign(block.vtx.size(), false);
+    unsigned int nCached = 0;
+    for (unsigned int i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        if (tx.IsCoinBase())
+            continue;
+        if (scriptExecutionCache.contains(GetScriptExecutionCacheEntry(tx, flags), false)) {
+            vScriptsCached[i] = true;
+            nCached++;
+        } else {
+            prep->vIndexes.push_back(i);
+        }
+    }
+    prep->nTasks = (prep->vIndexes.size() + TEMPLATE_TXDATA_BATCH - 1) / TEMPLATE_TXDATA_BATCH;
+    if (prep->nTasks == 0)
+        return nCached;
+    if (threadpool != nullptr) {
+        const size_t nWorkers = std::min<size_t>(GetNumCores(), prep->nTasks);
+        for (size_t i = 1; i < nWorkers; i++) {
+            if (!threadpool->tryPost([prep] { prep->Run(); }))
+                break;
+        }
+    }
+    prep->Run();
+    {
+        std::unique_lock<std::mutex> lock(prep->mutex);
+        prep->cond.wait(lock, [&prep] { return prep->nDone == prep->nTasks; });
+    }
+    return nCached;
+}
+
 static int64_t nTimeCheck = 0;
 static int64_t nTimeForks = 0;
 static int64_t nTimeVerify = 0;
@@ -2413,7 +2718,7 @@ static int64_t nBlocksTotal = 0;
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
 bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
-                  CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck)
+                  CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck, bool fTemplate)
 {
     AssertLockHeld(cs_main);
     assert(pindex);
@@ -2463,6 +2768,9 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     nBlocksTotal++;
 
+    // SYSCOIN read what the block touches up front, in parallel, instead of one lookup at a time
+    PrefetchBlockInputs(block, view);
+
     bool fScriptChecks = true;
     if (!hashAssumeValid.IsNull()) {
         // We've been configured with the hash of a block which has been externally verified to have a valid history.
@@ -2502,8 +2810,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         }
     }
     bool bOverflow = false;
-    // SYSCOIN
-    if (!CheckSyscoinInputs(IsInitialBlockDownload(), *block.vtx[0], state, view, fJustCheck, bOverflow, pindex->nHeight, block))
+    // SYSCOIN a template was checked by the miner against the same coins just before
+    if (!fTemplate && !CheckSyscoinInputs(IsInitialBlockDownload(), *block.vtx[0], state, view, fJustCheck, bOverflow, pindex->nHeight, block))
         return error("ConnectBlock(): CheckSyscoinInputs on block %s failed\n",
             block.GetHash().ToString());
             
@@ -2521,6 +2829,13 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
     std::vector<PrecomputedTransactionData> txdata;
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
+    // SYSCOIN the scripts of template transactions were mostly verified on mempool entry
+    std::vector<bool> vScriptsCached;
+    const bool fTemplateScripts = fTemplate && fJustCheck && fScriptChecks;
+    if (fTemplateScripts) {
+        const unsigned int nCached = PrepareTemplateScriptChecks(block, STANDARD_SCRIPT_VERIFY_FLAGS, txdata, vScriptsCached);
+        LogPrint(BCLog::BENCH, "      - Template scripts: %u of %u transactions cached, prepared the rest in %.2fms\n", nCached, (unsigned)block.vtx.size() - 1, MILLI * (GetTimeMicros() - nTime2));
+    }
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
         const CTransaction &tx = *(block.vtx[i]);
@@ -2562,8 +2877,9 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
             return state.DoS(100, error("ConnectBlock(): too many sigops"),
                              REJECT_INVALID, "bad-blk-sigops");
 
-        txdata.emplace_back(tx);
-        if (!tx.IsCoinBase())
+        if (!fTemplateScripts)
+            txdata.emplace_back(tx);
+        if (!tx.IsCoinBase() && !(fTemplateScripts && vScriptsCached[i]))
         {
             std::vector<CScriptCheck> vChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
@@ -2648,6 +2964,27 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
  * If FlushStateMode::NONE is used, then FlushStateToDisk(...) won't do anything
  * besides checking if we need to prune.
  */
+// SYSCOIN
+bool FlushCoinsAndAssetCaches(CCoinsViewCache& coins, CCoinsViewWriteBehind* pwritebehind, bool fSync, std::string& strError)
+{
+    if (!coins.Flush()) {
+        strError = "Failed to write to coin database";
+        return false;
+    }
+    // With -coinswritebehind the coins are written in the background. The
+    // asset databases must never be ahead of the coins after a crash, so asset
+    // changes wait for that write, as does a caller that needs the coins on disk
+    if (pwritebehind && (fSync || AssetCachesDirty()) && !pwritebehind->Sync()) {
+        strError = "Failed to write to coin database";
+        return false;
+    }
+    if (!FlushAssetCaches()) {
+        strError = "Failed to write to asset databases";
+        return false;
+    }
+    return true;
+}
+
 bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &state, FlushStateMode mode, int nManualPruneHeight) {
     int64_t nMempoolUsage = mempool.DynamicMemoryUsage();
     LOCK(cs_main);
@@ -2684,7 +3021,8 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             nLastFlush = nNow;
         }
         int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
-        int64_t cacheSize = pcoinsTip->DynamicMemoryUsage();
+        // SYSCOIN the asset caches share the coins cache budget
+        int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() + AssetCachesDynamicMemoryUsage();
         int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
         // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
         bool fCacheLarge = mode == FlushStateMode::PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
@@ -2722,8 +3060,12 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
                 }
             }
             // Finally remove any pruned files
-            if (fFlushForPrune)
+            if (fFlushForPrune) {
+                // SYSCOIN a coins write still in flight may need these blocks to be replayed after a crash
+                if (pcoinswritebehind && !pcoinswritebehind->Sync())
+                    return AbortNode(state, "Failed to write to coin database");
                 UnlinkPrunedFiles(setFilesToPrune);
+            }
             nLastWrite = nNow;
         }
         // Flush best chain related state. This can only be done if the blocks / block index write was also done.
@@ -2736,8 +3078,10 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
             // Flush the chainstate (which may refer to block index entries).
-            if (!pcoinsTip->Flush())
-                return AbortNode(state, "Failed to write to coin database");
+            // SYSCOIN asset state is written along with the chainstate it belongs to
+            std::string strError;
+            if (!FlushCoinsAndAssetCaches(*pcoinsTip, pcoinswritebehind.get(), mode == FlushStateMode::ALWAYS, strError))
+                return AbortNode(state, strError);
             nLastFlush = nNow;
             full_flush_completed = true;
         }
@@ -3191,6 +3535,17 @@ bool CChainState::ActivateBestChainStep(CValidationState& state, const CChainPar
         }
         nHeight = nTargetHeight;
 
+        // SYSCOIN start reading the blocks we are about to connect (e.g. during
+        // -reindex-chainstate) while the first ones are being validated
+        if (nBlockPrefetch > 0 && vpindexToConnect.size() > 1) {
+            std::vector<CDiskBlockPos> vPos;
+            for (const CBlockIndex* pindexPrefetch : reverse_iterate(vpindexToConnect)) {
+                if (pindexPrefetch != pindexMostWork && (pindexPrefetch->nStatus & BLOCK_HAVE_DATA))
+                    vPos.push_back(pindexPrefetch->GetBlockPos());
+            }
+            g_blockfilemap.Prefetch(vPos);
+        }
+
         // Connect new blocks.
         for (CBlockIndex *pindexConnect : reverse_iterate(vpindexToConnect)) {
             if (!ConnectTip(state, chainparams, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, disconnectpool)) {
@@ -3948,7 +4303,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3966,7 +4321,7 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPOW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -4011,14 +4366,77 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
 }
 
 // Exposed wrapper for AcceptBlockHeader
+// SYSCOIN
+/** Work shared by the threads verifying the proof of work of a batch of headers */
+struct HeadersPowCheck {
+    const std::vector<CBlockHeader>* headers;
+    const Consensus::Params* params;
+    std::vector<char> vValid;
+    //! Number of headers; tasks that run late must not touch headers, which may be gone
+    size_t nCount = 0;
+    std::atomic<size_t> nNext{0};
+    size_t nDone = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    /** Verify headers until none are left */
+    void Run()
+    {
+        size_t nChecked = 0;
+        for (size_t i = nNext++; i < nCount; i = nNext++) {
+            vValid[i] = CheckProofOfWork((*headers)[i], *params);
+            nChecked++;
+        }
+        if (nChecked > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            nDone += nChecked;
+            if (nDone == nCount)
+                cond.notify_one();
+        }
+    }
+};
+
+/**
+ * Verify the (aux)pow of a batch of headers on the thread pool, without holding
+ * cs_main. The calling thread takes part, so this completes even if the pool is busy.
+ * Headers reported invalid here are checked again by AcceptBlockHeader, which
+ * produces the rejection.
+ */
+static std::vector<char> CheckHeadersProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& params)
+{
+    auto check = std::make_shared<HeadersPowCheck>();
+    check->headers = &headers;
+    check->params = &params;
+    check->vValid.assign(headers.size(), false);
+    check->nCount = headers.size();
+    if (threadpool != nullptr) {
+        const size_t nTasks = std::min<size_t>(GetNumCores(), headers.size() / MIN_HEADERS_PER_POW_TASK);
+        // tasks that only get to run after all headers are done find nothing left to do
+        for (size_t i = 1; i < nTasks; i++) {
+            if (!threadpool->tryPost([check] { check->Run(); }))
+                break;
+        }
+    }
+    check->Run();
+    std::unique_lock<std::mutex> lock(check->mutex);
+    check->cond.wait(lock, [&check] { return check->nDone == check->nCount; });
+    return check->vValid;
+}
+
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+    // SYSCOIN verifying auxpow dominates the cost of a header, do it up front and in parallel
+    std::vector<char> vPowValid;
+    if (headers.size() >= 2 * MIN_HEADERS_PER_POW_TASK)
+        vPowValid = CheckHeadersProofOfWork(headers, chainparams.GetConsensus());
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            const bool fCheckPOW = vPowValid.empty() || !vPowValid[i];
+            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, fCheckPOW)) {
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -4061,7 +4479,8 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
     CBlockIndex *pindexDummy = nullptr;
     CBlockIndex *&pindex = ppindex ? *ppindex : pindexDummy;
 
-    if (!AcceptBlockHeader(block, state, chainparams, &pindex))
+    // SYSCOIN a block that passed CheckBlock already had its proof of work verified
+    if (!AcceptBlockHeader(block, state, chainparams, &pindex, !block.fChecked))
         return false;
 
     // Try to process all requested blocks that we don't have, but only
@@ -4159,9 +4578,10 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
     return true;
 }
 
-bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW, bool fCheckMerkleRoot)
+bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW, bool fCheckMerkleRoot, bool fTemplate)
 {
     AssertLockHeld(cs_main);
+    int64_t nTimeStart = GetTimeMicros();
     assert(pindexPrev && pindexPrev == chainActive.Tip());
     CCoinsViewCache viewNew(pcoinsTip.get());
     uint256 block_hash(block.GetHash());
@@ -4173,13 +4593,19 @@ bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams,
     // NOTE: CheckBlockHeader is called by CheckBlock
     if (!ContextualCheckBlockHeader(block, state, chainparams, pindexPrev, GetAdjustedTime()))
         return error("%s: Consensus::ContextualCheckBlockHeader: %s", __func__, FormatStateMessage(state));
+    int64_t nTime1 = GetTimeMicros();
     if (!CheckBlock(block, state, chainparams.GetConsensus(), fCheckPOW, fCheckMerkleRoot))
         return error("%s: Consensus::CheckBlock: %s", __func__, FormatStateMessage(state));
+    int64_t nTime2 = GetTimeMicros();
     if (!ContextualCheckBlock(block, state, chainparams.GetConsensus(), pindexPrev))
         return error("%s: Consensus::ContextualCheckBlock: %s", __func__, FormatStateMessage(state));
-    if (!g_chainstate.ConnectBlock(block, state, &indexDummy, viewNew, chainparams, true))
+    int64_t nTime3 = GetTimeMicros();
+    if (!g_chainstate.ConnectBlock(block, state, &indexDummy, viewNew, chainparams, true, fTemplate))
         return false;
     assert(state.IsValid());
+    int64_t nTime4 = GetTimeMicros();
+    LogPrint(BCLog::BENCH, "TestBlockValidity()%s: header %.2fms, block %.2fms, contextual %.2fms, connect %.2fms (total %.2fms)\n", fTemplate ? " template" : "",
+        MILLI * (nTime1 - nTimeStart), MILLI * (nTime2 - nTime1), MILLI * (nTime3 - nTime2), MILLI * (nTime4 - nTime3), MILLI * (nTime4 - nTimeStart));
 
     return true;
 }
@@ -4239,6 +4665,7 @@ void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
 {
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         CDiskBlockPos pos(*it, 0);
+        g_blockfilemap.Evict(*it);
         fs::remove(GetBlockPosFilename(pos, "blk"));
         fs::remove(GetBlockPosFilename(pos, "rev"));
         LogPrintf("Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
@@ -4947,6 +5374,81 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     return g_chainstate.LoadGenesisBlock(chainparams);
 }
 
+/** A block found in a block file by LoadExternalBlockFile */
+struct ImportedBlock {
+    //! Position of the message start, scanning resumes just after it if the block is unreadable
+    uint64_t nHeaderPos;
+    CDiskBlockPos pos;
+    //! The serialized block, released once deserialized
+    std::vector<char> vData;
+    //! Set by the check stage if the block could be deserialized
+    std::shared_ptr<CBlock> pblock;
+    uint256 hash;
+};
+
+/**
+ * A batch of imported blocks that is deserialized and run through the
+ * context-free CheckBlock on the thread pool, while the importing thread reads
+ * the next batch and accepts the previous one. A block that passes is marked
+ * fChecked, so AcceptBlock does not check it again; one that fails is checked
+ * again by AcceptBlock, which produces the rejection.
+ */
+struct ImportBatch {
+    std::vector<ImportedBlock> vBlocks;
+    const Consensus::Params* params;
+    std::atomic<size_t> nNext{0};
+    size_t nDone = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    /** Process blocks until none are left */
+    void Run()
+    {
+        size_t nProcessed = 0;
+        for (size_t i = nNext++; i < vBlocks.size(); i = nNext++) {
+            ImportedBlock& imported = vBlocks[i];
+            try {
+                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+                CSpanReader blkin(SER_DISK, CLIENT_VERSION, (const unsigned char*)imported.vData.data(), imported.vData.size());
+                blkin >> *pblock;
+                imported.hash = pblock->GetHash();
+                CValidationState state;
+                CheckBlock(*pblock, state, *params);
+                imported.pblock = std::move(pblock);
+            } catch (const std::exception& e) {
+                LogPrintf("LoadExternalBlockFile: Deserialize or I/O error - %s\n", e.what());
+            }
+            std::vector<char>().swap(imported.vData);
+            nProcessed++;
+        }
+        if (nProcessed > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            nDone += nProcessed;
+            if (nDone == vBlocks.size())
+                cond.notify_one();
+        }
+    }
+};
+
+static void StartImportBatch(const std::shared_ptr<ImportBatch>& batch)
+{
+    if (threadpool == nullptr)
+        return;
+    const size_t nTasks = std::min<size_t>(GetNumCores(), batch->vBlocks.size());
+    for (size_t i = 0; i < nTasks; i++) {
+        if (!threadpool->tryPost([batch] { batch->Run(); }))
+            break;
+    }
+}
+
+/** Wait for a batch to be checked, processing whatever the thread pool has not picked up yet */
+static void WaitImportBatch(ImportBatch& batch)
+{
+    batch.Run();
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.cond.wait(lock, [&batch] { return batch.nDone == batch.vBlocks.size(); });
+}
+
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
 {
     // Map of disk positions for blocks with unknown parent (only used for reindex)
@@ -4955,111 +5457,161 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
 
     int nLoaded = 0;
     try {
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE+8, SER_DISK, CLIENT_VERSION);
+        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor.
+        // SYSCOIN blocks are read a batch ahead of the one being accepted, keep both
+        // in the buffer so that scanning can resume inside an unreadable block.
+        const uint64_t nRewindLimit = 2 * (MAX_IMPORT_BATCH_BYTES + MAX_BLOCK_SERIALIZED_SIZE + 8);
+        CBufferedFile blkdat(fileIn, nRewindLimit + MAX_BLOCK_SERIALIZED_SIZE + 8, nRewindLimit, SER_DISK, CLIENT_VERSION);
         uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
-            boost::this_thread::interruption_point();
-
-            blkdat.SetPos(nRewind);
-            nRewind++; // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
-                blkdat.FindByte(chainparams.MessageStart()[0]);
-                nRewind = blkdat.GetPos()+1;
-                blkdat >> buf;
-                if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
-                    continue;
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
-                break;
-            }
-            try {
-                // read block
-                uint64_t nBlockPos = blkdat.GetPos();
-                if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                blkdat.SetPos(nBlockPos);
-                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-                CBlock& block = *pblock;
-                blkdat >> block;
-                nRewind = blkdat.GetPos();
-
-                uint256 hash = block.GetHash();
-                {
-                    LOCK(cs_main);
-                    // detect out of order blocks, and store them for later
-                    if (hash != chainparams.GetConsensus().hashGenesisBlock && !LookupBlockIndex(block.hashPrevBlock)) {
-                        LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                                block.hashPrevBlock.ToString());
-                        if (dbp)
-                            mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
+        std::shared_ptr<ImportBatch> pending;
+        bool fAbort = false;
+        while (!fAbort) {
+            // Stage 1: read the next batch of blocks while the pending one is being checked
+            std::shared_ptr<ImportBatch> batch = std::make_shared<ImportBatch>();
+            batch->params = &chainparams.GetConsensus();
+            size_t nBatchBytes = 0;
+            while (!blkdat.eof() && batch->vBlocks.size() < MAX_IMPORT_BATCH_BLOCKS && nBatchBytes < MAX_IMPORT_BATCH_BYTES) {
+                boost::this_thread::interruption_point();
+
+                blkdat.SetPos(nRewind);
+                nRewind++; // start one byte further next time, in case of failure
+                blkdat.SetLimit(); // remove former limit
+                unsigned int nSize = 0;
+                uint64_t nHeaderPos = 0;
+                try {
+                    // locate a header
+                    unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
+                    blkdat.FindByte(chainparams.MessageStart()[0]);
+                    nHeaderPos = blkdat.GetPos();
+                    nRewind = nHeaderPos+1;
+                    blkdat >> buf;
+                    if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
                         continue;
-                    }
-
-                    // process in case the block isn't known yet
-                    CBlockIndex* pindex = LookupBlockIndex(hash);
-                    if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
-                      CValidationState state;
-                      if (g_chainstate.AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr)) {
-                          nLoaded++;
-                      }
-                      if (state.IsError()) {
-                          break;
-                      }
-                    } else if (hash != chainparams.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
-                      LogPrint(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
-                    }
+                    // read size
+                    blkdat >> nSize;
+                    if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
+                        continue;
+                } catch (const std::exception&) {
+                    // no valid block header found; don't complain
+                    break;
                 }
-
-                // Activate the genesis block so normal node progress can continue
-                if (hash == chainparams.GetConsensus().hashGenesisBlock) {
-                    CValidationState state;
-                    if (!ActivateBestChain(state, chainparams)) {
+                try {
+                    // read block
+                    uint64_t nBlockPos = blkdat.GetPos();
+                    blkdat.SetLimit(nBlockPos + nSize);
+                    blkdat.SetPos(nBlockPos);
+                    ImportedBlock imported;
+                    imported.nHeaderPos = nHeaderPos;
+                    if (dbp)
+                        imported.pos = CDiskBlockPos(dbp->nFile, nBlockPos);
+                    imported.vData.resize(nSize);
+                    blkdat.read(imported.vData.data(), nSize);
+                    nRewind = blkdat.GetPos();
+                    nBatchBytes += nSize;
+                    batch->vBlocks.push_back(std::move(imported));
+                } catch (const std::exception& e) {
+                    LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+                }
+            }
+            // Stage 2: deserialize and check the new batch in parallel
+            if (!batch->vBlocks.empty())
+                StartImportBatch(batch);
+            else
+                batch.reset();
+
+            // Stage 3: accept the pending batch in file order
+            bool fRescan = false;
+            if (pending) {
+                WaitImportBatch(*pending);
+                for (ImportedBlock& imported : pending->vBlocks) {
+                    boost::this_thread::interruption_point();
+                    if (!imported.pblock) {
+                        // Unreadable block: drop what was read after it and scan
+                        // again from just after its header, as a serial read would
+                        batch.reset();
+                        nRewind = imported.nHeaderPos + 1;
+                        blkdat.SetPos(nRewind);
+                        fRescan = true;
                         break;
                     }
-                }
-
-                NotifyHeaderTip();
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
+                    if (dbp)
+                        *dbp = imported.pos;
+                    try {
+                        std::shared_ptr<CBlock> pblock = imported.pblock;
+                        const uint256& hash = imported.hash;
                         {
-                            LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
-                                    head.ToString());
                             LOCK(cs_main);
-                            CValidationState dummy;
-                            if (g_chainstate.AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr))
-                            {
-                                nLoaded++;
-                                queue.push_back(pblockrecursive->GetHash());
+                            // detect out of order blocks, and store them for later
+                            if (hash != chainparams.GetConsensus().hashGenesisBlock && !LookupBlockIndex(pblock->hashPrevBlock)) {
+                                LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+                                        pblock->hashPrevBlock.ToString());
+                                if (dbp)
+                                    mapBlocksUnknownParent.insert(std::make_pair(pblock->hashPrevBlock, *dbp));
+                                continue;
+                            }
+
+                            // process in case the block isn't known yet
+                            CBlockIndex* pindex = LookupBlockIndex(hash);
+                            if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
+                              CValidationState state;
+                              if (g_chainstate.AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr)) {
+                                  nLoaded++;
+                              }
+                              if (state.IsError()) {
+                                  fAbort = true;
+                                  break;
+                              }
+                            } else if (hash != chainparams.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
+                              LogPrint(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
+                            }
+                        }
+
+                        // Activate the genesis block so normal node progress can continue
+                        if (hash == chainparams.GetConsensus().hashGenesisBlock) {
+                            CValidationState state;
+                            if (!ActivateBestChain(state, chainparams)) {
+                                fAbort = true;
+                                break;
                             }
                         }
-                        range.first++;
-                        mapBlocksUnknownParent.erase(it);
+
                         NotifyHeaderTip();
+
+                        // Recursively process earlier encountered successors of this block
+                        std::deque<uint256> queue;
+                        queue.push_back(hash);
+                        while (!queue.empty()) {
+                            uint256 head = queue.front();
+                            queue.pop_front();
+                            std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
+                            while (range.first != range.second) {
+                                std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
+                                std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
+                                if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
+                                {
+                                    LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
+                                            head.ToString());
+                                    LOCK(cs_main);
+                                    CValidationState dummy;
+                                    if (g_chainstate.AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr))
+                                    {
+                                        nLoaded++;
+                                        queue.push_back(pblockrecursive->GetHash());
+                                    }
+                                }
+                                range.first++;
+                                mapBlocksUnknownParent.erase(it);
+                                NotifyHeaderTip();
+                            }
+                        }
+                    } catch (const std::exception& e) {
+                        LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
                     }
                 }
-            } catch (const std::exception& e) {
-                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
             }
+            if (!batch && !fRescan)
+                break;
+            pending = std::move(batch);
         }
     } catch (const std::runtime_error& e) {
         AbortNode(std::string("System error: ") + e.what());
@@ -38,6 +38,7 @@ class CBlockIndex;
 class CBlockTreeDB;
 class CChainParams;
 class CCoinsViewDB;
+class CCoinsViewWriteBehind;
 class CInv;
 class CConnman;
 class CScriptCheck;
@@ -98,6 +99,16 @@ static const unsigned int BLOCK_STALLING_TIMEOUT = 2;
  *  overloaded both with small and large headers.
  */
 static const unsigned int MAX_HEADERS_RESULTS = 2000;
+/** Minimum number of headers verified by one thread when checking the proof of work of a batch in parallel */
+static const unsigned int MIN_HEADERS_PER_POW_TASK = 16;
+/** Number of outpoints one thread reads from the coin database in one go when prefetching the inputs of a block */
+static const unsigned int COINS_PREFETCH_BATCH = 64;
+/** Number of transactions one thread prepares for script checks in one go when validating a block template */
+static const unsigned int TEMPLATE_TXDATA_BATCH = 16;
+/** Maximum number of blocks -reindex and -loadblock read ahead and check in parallel as one batch */
+static const unsigned int MAX_IMPORT_BATCH_BLOCKS = 128;
+/** Size of the serialized blocks after which an import batch is closed (it may go over by one block) */
+static const unsigned int MAX_IMPORT_BATCH_BYTES = 8000000;
 /** Maximum size of a "headers" message.  This is enforced starting with
  *  SIZE_HEADERS_LIMIT_VERSION peers and prevents overloading if we have
  *  very large headers (due to auxpow).
@@ -191,6 +202,8 @@ extern int64_t nMaxTipAge;
 extern bool fEnableReplacement;
 // SYSCOIN
 extern bool fLogThreadpool;
+/** Number of blocks read ahead of sequential block scans (-blockprefetch) */
+extern int nBlockPrefetch;
 extern std::map<uint256, int64_t> mapRejectedBlocks;
 
 /** Block hash whose ancestors we will assume to have valid scripts without checking them. */
@@ -321,6 +334,12 @@ void FlushStateToDisk();
 void PruneAndFlush();
 /** Prune block files up to a given height */
 void PruneBlockFilesManual(int nManualPruneHeight);
+/**
+ * Write the coins cache and then the asset caches out, so that the asset databases
+ * are never ahead of the coins after a crash. A write-behind coins layer is only
+ * waited for with fSync or when there are asset changes.
+ */
+bool FlushCoinsAndAssetCaches(CCoinsViewCache& coins, CCoinsViewWriteBehind* pwritebehind, bool fSync, std::string& strError);
 
 // SYSCOIN
 /** (try to) add transaction to memory pool
@@ -328,6 +347,18 @@ void PruneBlockFilesManual(int nManualPruneHeight);
 bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx,
                         bool* pfMissingInputs, std::list<CTransactionRef>* plTxnReplaced,
                         bool bypass_limits, const CAmount nAbsurdFee, bool test_accept=false, bool bMultiThreaded=false);
+/**
+ * Verify the scripts of transactions that arrive together, such as a chain of
+ * dependent sends, in one run of the script check queue rather than one run
+ * per transaction. Inputs are looked up in the mempool and the chainstate, and
+ * in the outputs of earlier transactions of the package. Transactions whose
+ * scripts were executed before are skipped. The scripts that pass are added to
+ * the script execution cache, so AcceptToMemoryPool does not run them again.
+ * vInvalid is set for the transactions whose scripts failed; those whose inputs
+ * were not found are left to AcceptToMemoryPool. cs_main is only held while the
+ * checks are gathered, not while they run.
+ */
+void CheckPackageScripts(const std::vector<CTransactionRef>& package, std::vector<bool>& vInvalid);
 static std::vector<uint256> DEFAULT_VECTOR;
 bool CheckSyscoinInputs(const bool ibd, const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fJustCheck, bool &bOverflow, int nHeight, const CBlock& block, bool bSanity = false, bool bMiner = false, std::vector<uint256>& txsToRemove=DEFAULT_VECTOR);
 bool GetUTXOCoin(const COutPoint& outpoint, Coin& coin);
@@ -449,11 +480,27 @@ void InitScriptExecutionCache();
 
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/** Read a block from disk. With fReadAuxpow false the auxpow is skipped rather than
+ * deserialized and verified (see SERIALIZE_BLOCK_NO_AUXPOW); use this where only the
+ * transactions are needed. */
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fReadAuxpow = true);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& message_start);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
 // SYSCOIN
 bool ReadBlockHeaderFromDisk(CBlockHeader& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/**
+ * Reads blocks ahead of a sequential walk along the active chain, such as a
+ * wallet rescan or an index sync, so they are in memory by the time the walk
+ * reaches them. Call Advance() with cs_main held whenever the walk moves on.
+ */
+class CBlockPrefetcher
+{
+private:
+    const CBlockIndex* m_last_prefetched = nullptr;
+
+public:
+    void Advance(const CBlockIndex* pindex);
+};
 /** Reprocess a number of blocks to try and get on the correct chain again **/
 bool DisconnectBlocks(int blocks);
 void ReprocessBlocks(int nBlocks);
@@ -463,8 +510,12 @@ void ReprocessBlocks(int nBlocks);
 /** Context-independent validity checks */
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true);
 
-/** Check a block is completely valid from start to finish (only works on top of our current best block) */
-bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+/** Check a block is completely valid from start to finish (only works on top of our current best block).
+ *  With fTemplate the block is a template CreateNewBlock() assembled from the mempool, and the syscoin checks
+ *  the miner ran are not repeated. CheckInputs returns early for scripts in the script execution cache anyway;
+ *  template mode looks them up front so that signature hash data is only precomputed, in parallel, for the
+ *  transactions whose scripts still have to run. */
+bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fTemplate = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 /** Check whether witness commitments are required for block. */
 bool IsWitnessEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& params);
@@ -529,6 +580,9 @@ extern CChain& chainActive;
 /** Global variable that points to the coins database (protected by cs_main) */
 extern std::unique_ptr<CCoinsViewDB> pcoinsdbview;
 
+/** Global variable that points to the write-behind layer over pcoinsdbview, if -coinswritebehind is enabled (protected by cs_main) */
+extern std::unique_ptr<CCoinsViewWriteBehind> pcoinswritebehind;
+
 /** Global variable that points to the active CCoinsView (protected by cs_main) */
 extern std::unique_ptr<CCoinsViewCache> pcoinsTip;
 
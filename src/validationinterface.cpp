@@ -5,6 +5,7 @@
 
 #include <validationinterface.h>
 
+#include <consensus/validation.h>
 #include <primitives/block.h>
 #include <scheduler.h>
 #include <sync.h>
@@ -14,7 +15,9 @@
 
 #include <list>
 #include <atomic>
+#include <deque>
 #include <future>
+#include <mutex>
 
 #include <boost/signals2/signal.hpp>
 
@@ -31,6 +34,8 @@ struct MainSignalsInstance {
     // SYSCOIN
     boost::signals2::signal<void (const CBlockIndex *)> AcceptedBlockHeader;
     boost::signals2::signal<void(const char *value, const char *topic)> NotifySyscoinUpdate;
+    boost::signals2::signal<void(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed)> NotifySyscoinUpdateRaw;
+    boost::signals2::signal<void (const uint256 &, bool fValid)> SyscoinBlockChecked;
     boost::signals2::signal<void (const CBlockIndex *, bool fInitialDownload)> NotifyHeaderTip;
 
     // We are not allowed to assume the scheduler only runs in one thread,
@@ -38,6 +43,15 @@ struct MainSignalsInstance {
     // our own queue here :(
     SingleThreadedSchedulerClient m_schedulerClient;
 
+    // SYSCOIN notifications are produced at a high rate while transactions are
+    // checked, so they are collected here and delivered by a single callback on
+    // m_schedulerClient instead of one callback each
+    std::mutex m_syscoinMutex;
+    std::deque<std::function<void ()>> m_syscoinQueue;
+    bool m_syscoinProcessing = false;
+    size_t m_syscoinQueueLimit = DEFAULT_MAX_SYSCOIN_NOTIFY_QUEUE;
+    uint64_t m_syscoinDropped = 0;
+
     explicit MainSignalsInstance(CScheduler *pscheduler) : m_schedulerClient(pscheduler) {}
 };
 
@@ -88,6 +102,8 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->NewPoWValidBlock.connect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
     // SYSCOIN
     g_signals.m_internals->NotifySyscoinUpdate.connect(boost::bind(&CValidationInterface::NotifySyscoinUpdate, pwalletIn, _1, _2));
+    g_signals.m_internals->NotifySyscoinUpdateRaw.connect(boost::bind(&CValidationInterface::NotifySyscoinUpdateRaw, pwalletIn, _1, _2, _3));
+    g_signals.m_internals->SyscoinBlockChecked.connect(boost::bind(&CValidationInterface::SyscoinBlockChecked, pwalletIn, _1, _2));
     g_signals.m_internals->AcceptedBlockHeader.connect(boost::bind(&CValidationInterface::AcceptedBlockHeader, pwalletIn, _1));
     g_signals.m_internals->NotifyHeaderTip.connect(boost::bind(&CValidationInterface::NotifyHeaderTip, pwalletIn, _1, _2));
 }
@@ -104,6 +120,8 @@ void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->NewPoWValidBlock.disconnect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
     // SYSCOIN
     g_signals.m_internals->NotifySyscoinUpdate.disconnect(boost::bind(&CValidationInterface::NotifySyscoinUpdate, pwalletIn, _1, _2));
+    g_signals.m_internals->NotifySyscoinUpdateRaw.disconnect(boost::bind(&CValidationInterface::NotifySyscoinUpdateRaw, pwalletIn, _1, _2, _3));
+    g_signals.m_internals->SyscoinBlockChecked.disconnect(boost::bind(&CValidationInterface::SyscoinBlockChecked, pwalletIn, _1, _2));
     g_signals.m_internals->NotifyHeaderTip.disconnect(boost::bind(&CValidationInterface::NotifyHeaderTip, pwalletIn, _1, _2));
     g_signals.m_internals->AcceptedBlockHeader.disconnect(boost::bind(&CValidationInterface::AcceptedBlockHeader, pwalletIn, _1));
 }
@@ -123,6 +141,8 @@ void UnregisterAllValidationInterfaces() {
     g_signals.m_internals->NewPoWValidBlock.disconnect_all_slots();
     // SYSCOIN
     g_signals.m_internals->NotifySyscoinUpdate.disconnect_all_slots();
+    g_signals.m_internals->NotifySyscoinUpdateRaw.disconnect_all_slots();
+    g_signals.m_internals->SyscoinBlockChecked.disconnect_all_slots();
     g_signals.m_internals->NotifyHeaderTip.disconnect_all_slots();
     g_signals.m_internals->AcceptedBlockHeader.disconnect_all_slots();
 }
@@ -189,14 +209,76 @@ void CMainSignals::Broadcast(int64_t nBestBlockTime, CConnman* connman) {
 
 void CMainSignals::BlockChecked(const CBlock& block, const CValidationState& state) {
     m_internals->BlockChecked(block, state);
+    // SYSCOIN
+    const uint256 blockHash = block.GetHash();
+    const bool fValid = state.IsValid();
+    AddToSyscoinQueue([blockHash, fValid, this] {
+        m_internals->SyscoinBlockChecked(blockHash, fValid);
+    }, false);
 }
 
 void CMainSignals::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock> &block) {
     m_internals->NewPoWValidBlock(pindex, block);
 }
 // SYSCOIN
-void CMainSignals::NotifySyscoinUpdate(const char *value, const char *topic) {
-    m_internals->NotifySyscoinUpdate(value, topic);
+void CMainSignals::AddToSyscoinQueue(std::function<void ()> func, bool fDroppable) {
+    {
+        std::lock_guard<std::mutex> lock(m_internals->m_syscoinMutex);
+        if (fDroppable && m_internals->m_syscoinQueue.size() >= m_internals->m_syscoinQueueLimit) {
+            // never make the caller wait for subscribers; unconfirmed events are
+            // announced again once their transaction is mined
+            if (m_internals->m_syscoinDropped++ % 1000 == 0)
+                LogPrintf("%s: notification queue full, dropped %u unconfirmed notifications so far\n", __func__, m_internals->m_syscoinDropped);
+            return;
+        }
+        m_internals->m_syscoinQueue.emplace_back(std::move(func));
+        if (m_internals->m_syscoinProcessing)
+            return;
+        m_internals->m_syscoinProcessing = true;
+    }
+    m_internals->m_schedulerClient.AddToProcessQueue([this] {
+        ProcessSyscoinQueue();
+    });
+}
+
+void CMainSignals::ProcessSyscoinQueue() {
+    while (true) {
+        std::function<void ()> func;
+        {
+            std::lock_guard<std::mutex> lock(m_internals->m_syscoinMutex);
+            if (m_internals->m_syscoinQueue.empty()) {
+                m_internals->m_syscoinProcessing = false;
+                return;
+            }
+            func = std::move(m_internals->m_syscoinQueue.front());
+            m_internals->m_syscoinQueue.pop_front();
+        }
+        func();
+    }
+}
+
+void CMainSignals::SetSyscoinQueueLimit(size_t nLimit) {
+    std::lock_guard<std::mutex> lock(m_internals->m_syscoinMutex);
+    m_internals->m_syscoinQueueLimit = nLimit;
+}
+
+uint64_t CMainSignals::SyscoinNotificationsDropped() {
+    if (!m_internals) return 0;
+    std::lock_guard<std::mutex> lock(m_internals->m_syscoinMutex);
+    return m_internals->m_syscoinDropped;
+}
+
+void CMainSignals::NotifySyscoinUpdate(const char *value, const char *topic, bool fConfirmed) {
+    std::string strValue(value), strTopic(topic);
+    AddToSyscoinQueue([strValue, strTopic, this] {
+        m_internals->NotifySyscoinUpdate(strValue.c_str(), strTopic.c_str());
+    }, !fConfirmed);
+}
+void CMainSignals::NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed) {
+    std::string strTopic(topic);
+    AddToSyscoinQueue([vchEvent, strTopic, fConfirmed, this] {
+        m_internals->NotifySyscoinUpdateRaw(vchEvent, strTopic.c_str(), fConfirmed);
+    }, !fConfirmed);
 }
 void CMainSignals::NotifyHeaderTip(const CBlockIndex * pindex, bool fInitialDownload) {
     m_internals->NotifyHeaderTip(pindex, fInitialDownload);
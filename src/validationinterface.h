@@ -24,6 +24,9 @@ class CScheduler;
 class CTxMemPool;
 enum class MemPoolRemovalReason;
 
+/** Default for -maxsyscoinnotifyqueue */
+static const unsigned int DEFAULT_MAX_SYSCOIN_NOTIFY_QUEUE = 10000;
+
 // These functions dispatch to one or all registered wallets
 
 /** Register a wallet to receive updates from core */
@@ -146,7 +149,19 @@ protected:
      * has been received and connected to the headers tree, though not validated yet */
     virtual void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& block) {};
     // SYSCOIN
+    /**
+     * Notifies listeners of asset and asset allocation events.
+     *
+     * Called on a background thread, in order with the other Syscoin notifications.
+     */
     virtual void NotifySyscoinUpdate(const char *value, const char *topic) {}
+    /** Serialized counterpart of NotifySyscoinUpdate; fConfirmed is set for events of a block being connected */
+    virtual void NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed) {}
+    /**
+     * Notifies listeners that the block whose Syscoin events were just notified has
+     * been checked (see BlockChecked). Called in order with the Syscoin notifications.
+     */
+    virtual void SyscoinBlockChecked(const uint256 &blockHash, bool fValid) {}
     virtual void AcceptedBlockHeader(const CBlockIndex *pindexNew) {}
     virtual void NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload) {}
     friend void ::RegisterValidationInterface(CValidationInterface*);
@@ -165,6 +180,9 @@ private:
     friend void ::CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
 
     void MempoolEntryRemoved(CTransactionRef tx, MemPoolRemovalReason reason);
+    // SYSCOIN
+    void AddToSyscoinQueue(std::function<void ()> func, bool fDroppable);
+    void ProcessSyscoinQueue();
 
 public:
     /** Register a CScheduler to give callbacks which should run in the background (may only be called once) */
@@ -176,6 +194,12 @@ public:
 
     size_t CallbacksPending();
 
+    // SYSCOIN
+    /** Set the number of queued Syscoin notifications beyond which unconfirmed ones are dropped */
+    void SetSyscoinQueueLimit(size_t nLimit);
+    /** Number of unconfirmed Syscoin notifications dropped because the queue was full */
+    uint64_t SyscoinNotificationsDropped();
+
     /** Register with mempool to call TransactionRemovedFromMempool callbacks */
     void RegisterWithMempoolSignals(CTxMemPool& pool);
     /** Unregister with mempool */
@@ -190,7 +214,10 @@ public:
     void BlockChecked(const CBlock&, const CValidationState&);
     void NewPoWValidBlock(const CBlockIndex *, const std::shared_ptr<const CBlock>&);
     // SYSCOIN
-    void NotifySyscoinUpdate(const char *value, const char *topic);
+    /** Queue asset/allocation notifications for the background thread. Unconfirmed
+     * (zdag) notifications are dropped rather than queued when subscribers fall behind. */
+    void NotifySyscoinUpdate(const char *value, const char *topic, bool fConfirmed = true);
+    void NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed);
     /** Notifies listeners of accepted block header */
     void AcceptedBlockHeader(const CBlockIndex *);
     /** Notifies listeners of updated block header tip */
@@ -2433,7 +2433,7 @@ static UniValue listsinceblock(const JSONRPCRequest& request)
     UniValue removed(UniValue::VARR);
     while (include_removed && paltindex && paltindex != pindex) {
         CBlock block;
-        if (!ReadBlockFromDisk(block, paltindex, Params().GetConsensus())) {
+        if (!ReadBlockFromDisk(block, paltindex, Params().GetConsensus(), false)) {
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Can't read block from disk");
         }
         for (const CTransactionRef& tx : block.vtx) {
@@ -5051,6 +5051,7 @@ extern UniValue assetsend(const JSONRPCRequest& request);
 extern UniValue assetinfo(const JSONRPCRequest& request);
 extern UniValue listassets(const JSONRPCRequest& request);
 extern UniValue assetallocationsend(const JSONRPCRequest& request);
+extern UniValue assetallocationsendbatch(const JSONRPCRequest& request);
 extern UniValue assetallocationmint(const JSONRPCRequest& request);
 extern UniValue assetallocationburn(const JSONRPCRequest& request);
 extern UniValue assetallocationinfo(const JSONRPCRequest& request);
@@ -5164,6 +5165,7 @@ static const CRPCCommand commands[] =
     { "syscoin",            "assetinfo",                        &assetinfo,                     {"asset"}},
     { "syscoin",            "listassets",                       &listassets,                    {"count","from","options"} },
     { "syscoin",            "assetallocationsend",              &assetallocationsend,           {"asset","address","inputs","witness"}},
+    { "syscoin",            "assetallocationsendbatch",         &assetallocationsendbatch,      {"jobs","witness","broadcast"}},
     { "syscoin",            "assetallocationinfo",              &assetallocationinfo,           {"asset"}},
     { "syscoin",            "assetallocationsenderstatus",      &assetallocationsenderstatus,   {"asset"}},
     { "syscoin",            "listassetallocationtransactions",  &listassetallocationtransactions,{"count","from","options"} },
@@ -1785,8 +1785,11 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
         CBlockIndex* tip = nullptr;
         double progress_begin;
         double progress_end;
+        // SYSCOIN read the following blocks while scanning the current one
+        CBlockPrefetcher prefetcher;
         {
             LOCK(cs_main);
+            prefetcher.Advance(pindex);
             progress_begin = GuessVerificationProgress(chainParams.TxData(), pindex);
             if (pindexStop == nullptr) {
                 tip = chainActive.Tip();
@@ -1807,7 +1810,8 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
             }
 
             CBlock block;
-            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            // SYSCOIN rescans only need the transactions
+            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus(), false)) {
                 LOCK2(cs_main, cs_wallet);
                 if (pindex && !chainActive.Contains(pindex)) {
                     // Abort scan if current block is no longer active, to prevent
@@ -1827,6 +1831,7 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
             {
                 LOCK(cs_main);
                 pindex = chainActive.Next(pindex);
+                prefetcher.Advance(pindex);
                 progress_current = GuessVerificationProgress(chainParams.TxData(), pindex);
                 if (pindexStop == nullptr && tip != chainActive.Tip()) {
                     tip = chainActive.Tip();
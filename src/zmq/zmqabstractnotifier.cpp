@@ -24,4 +24,14 @@ bool CZMQAbstractNotifier::NotifyTransaction(const CTransaction &/*transaction*/
 bool CZMQAbstractNotifier::NotifySyscoinUpdate(const char *, const char *)
 {
     return true;
-}
\ No newline at end of file
+}
+
+bool CZMQAbstractNotifier::NotifySyscoinUpdateRaw(const std::vector<unsigned char> &/*vchEvent*/, bool /*fConfirmed*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifySyscoinBlockChecked(const uint256 &/*blockHash*/, bool /*fValid*/)
+{
+    return true;
+}
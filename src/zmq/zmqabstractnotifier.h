@@ -36,6 +36,9 @@ public:
     virtual bool NotifyTransaction(const CTransaction &transaction);
     // SYSCOIN
     virtual bool NotifySyscoinUpdate(const char *, const char *);
+    virtual bool NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, bool fConfirmed);
+    /** Called once the block whose events were notified has been validated */
+    virtual bool NotifySyscoinBlockChecked(const uint256 &blockHash, bool fValid);
 
 protected:
     void *psocket;
@@ -51,6 +51,8 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     // SYSCOIN
     factories["pubassetallocation"] = CZMQAbstractNotifier::Create<CZMQPublishRawSyscoinNotifier>;
     factories["pubassetrecord"] = CZMQAbstractNotifier::Create<CZMQPublishRawSyscoinNotifier>;
+    factories["pubassetallocationraw"] = CZMQAbstractNotifier::Create<CZMQPublishBinarySyscoinNotifier>;
+    factories["pubassetrecordraw"] = CZMQAbstractNotifier::Create<CZMQPublishBinarySyscoinNotifier>;
     for (const auto& entry : factories)
     {
         std::string arg("-zmq" + entry.first);
@@ -217,4 +219,44 @@ void CZMQNotificationInterface::NotifySyscoinUpdate(const char *value, const cha
         }
     }
 }
+
+void CZMQNotificationInterface::NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed)
+{
+    const std::string strType = std::string("pub") + topic;
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i != notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->GetType() != strType) {
+            i++;
+            continue;
+        }
+
+        if (notifier->NotifySyscoinUpdateRaw(vchEvent, fConfirmed))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::SyscoinBlockChecked(const uint256 &blockHash, bool fValid)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i != notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifySyscoinBlockChecked(blockHash, fValid))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
 CZMQNotificationInterface* g_zmq_notification_interface = nullptr;
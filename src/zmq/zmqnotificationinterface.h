@@ -13,6 +13,9 @@
 class CBlockIndex;
 class CZMQAbstractNotifier;
 
+/** Default for -zmqsyscoinbatch */
+static const bool DEFAULT_ZMQ_SYSCOIN_BATCH = false;
+
 class CZMQNotificationInterface final : public CValidationInterface
 {
 public:
@@ -33,6 +36,8 @@ protected:
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
     // SYSCOIN
     void NotifySyscoinUpdate(const char *value, const char *topic) override;
+    void NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, const char *topic, bool fConfirmed) override;
+    void SyscoinBlockChecked(const uint256 &blockHash, bool fValid) override;
 private:
     CZMQNotificationInterface();
 
@@ -9,6 +9,7 @@
 #include <validation.h>
 #include <util.h>
 #include <rpc/server.h>
+#include <zmq/zmqnotificationinterface.h>
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
@@ -60,6 +61,30 @@ static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
     return 0;
 }
 
+// Internal function to send one part of a multipart message
+static int zmq_send_part(void *sock, const void* data, size_t size, bool fMore)
+{
+    zmq_msg_t msg;
+
+    int rc = zmq_msg_init_size(&msg, size);
+    if (rc != 0)
+    {
+        zmqError("Unable to initialize ZMQ msg");
+        return -1;
+    }
+
+    memcpy(zmq_msg_data(&msg), data, size);
+
+    rc = zmq_msg_send(&msg, sock, fMore ? ZMQ_SNDMORE : 0);
+    zmq_msg_close(&msg);
+    if (rc == -1)
+    {
+        zmqError("Unable to send ZMQ msg");
+        return -1;
+    }
+    return 0;
+}
+
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 {
     assert(!psocket);
@@ -146,6 +171,26 @@ bool CZMQAbstractPublishNotifier::SendMessage(const char *command, const void* d
     return true;
 }
 
+bool CZMQAbstractPublishNotifier::SendMessage(const char *command, const std::vector<std::vector<unsigned char>> &vParts)
+{
+    assert(psocket);
+
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(&msgseq[0], nSequence);
+    if (zmq_send_part(psocket, command, strlen(command), true) == -1)
+        return false;
+    for (const std::vector<unsigned char> &vchPart : vParts) {
+        if (zmq_send_part(psocket, vchPart.data(), vchPart.size(), true) == -1)
+            return false;
+    }
+    if (zmq_send_part(psocket, msgseq, sizeof(uint32_t), false) == -1)
+        return false;
+
+    nSequence++;
+
+    return true;
+}
+
 bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     uint256 hash = pindex->GetBlockHash();
@@ -200,4 +245,46 @@ bool CZMQPublishRawSyscoinNotifier::NotifySyscoinUpdate(const char * value, cons
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish raw syscoin payload for topic %s: %s\n", topic, value);
     return SendMessage(topic, value, strlen(value));
-}
\ No newline at end of file
+}
+
+bool CZMQPublishBinarySyscoinNotifier::Initialize(void *pcontext)
+{
+    // the command is the topic, e.g. "assetallocationraw" for -zmqpubassetallocationraw
+    strCommand = type.substr(3);
+    fBatch = gArgs.GetBoolArg("-zmqsyscoinbatch", DEFAULT_ZMQ_SYSCOIN_BATCH);
+    return CZMQAbstractPublishNotifier::Initialize(pcontext);
+}
+
+bool CZMQPublishBinarySyscoinNotifier::NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, bool fConfirmed)
+{
+    LOCK(cs);
+    // unconfirmed (zdag) events are always sent as they arrive
+    if (fBatch && fConfirmed) {
+        vBatch.push_back(vchEvent);
+        return true;
+    }
+    LogPrint(BCLog::ZMQ, "zmq: Publish %s event (%u bytes)\n", strCommand, vchEvent.size());
+    return SendMessage(strCommand.c_str(), vchEvent.data(), vchEvent.size());
+}
+
+bool CZMQPublishBinarySyscoinNotifier::NotifySyscoinBlockChecked(const uint256 &blockHash, bool fValid)
+{
+    LOCK(cs);
+    if (vBatch.empty())
+        return true;
+    if (!fValid) {
+        // events of a block that failed to connect are dropped
+        vBatch.clear();
+        return true;
+    }
+    std::vector<std::vector<unsigned char>> vParts;
+    vParts.reserve(vBatch.size() + 1);
+    vParts.emplace_back(blockHash.begin(), blockHash.end());
+    // same byte order as hashblock
+    std::reverse(vParts[0].begin(), vParts[0].end());
+    for (std::vector<unsigned char> &vchEvent : vBatch)
+        vParts.push_back(std::move(vchEvent));
+    vBatch.clear();
+    LogPrint(BCLog::ZMQ, "zmq: Publish %s batch of %u events for block %s\n", strCommand, vParts.size() - 1, blockHash.GetHex());
+    return SendMessage(strCommand.c_str(), vParts);
+}
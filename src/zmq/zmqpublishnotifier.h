@@ -7,6 +7,10 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <sync.h>
+
+#include <vector>
+
 class CBlockIndex;
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
@@ -24,6 +28,14 @@ public:
     */
     bool SendMessage(const char *command, const void* data, size_t size);
 
+    /* send zmq multipart message
+       parts:
+          * command
+          * each of vParts
+          * message sequence number
+    */
+    bool SendMessage(const char *command, const std::vector<std::vector<unsigned char>> &vParts);
+
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
 };
@@ -57,4 +69,23 @@ class CZMQPublishRawSyscoinNotifier : public CZMQAbstractPublishNotifier
 public:
     bool NotifySyscoinUpdate(const char *value, const char *topic) override;
 };
+
+/** Publishes serialized asset/allocation events (see NotifySyscoinUpdateRaw). With
+ * -zmqsyscoinbatch the confirmed events of a block are held back until the block has
+ * been checked (SyscoinBlockChecked) and are then sent as one message: command,
+ * block hash, events, sequence.
+ */
+class CZMQPublishBinarySyscoinNotifier : public CZMQAbstractPublishNotifier
+{
+private:
+    CCriticalSection cs;
+    std::string strCommand;
+    bool fBatch = false;
+    std::vector<std::vector<unsigned char>> vBatch GUARDED_BY(cs);
+
+public:
+    bool Initialize(void *pcontext) override;
+    bool NotifySyscoinUpdateRaw(const std::vector<unsigned char> &vchEvent, bool fConfirmed) override;
+    bool NotifySyscoinBlockChecked(const uint256 &blockHash, bool fValid) override;
+};
 #endif // SYSCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H